@@ -34,6 +34,7 @@
 #include "pluginSystem/PluginConnector.hpp"
 #include "nvidia/memory/MemoryInfo.hpp"
 #include "simulationControl/SimulationDescription.hpp"
+#include "simulationControl/StepProfiler.hpp"
 #include "mappings/simulation/Filesystem.hpp"
 #include "eventSystem/events/EventPool.hpp"
 #include "Environment.def"
@@ -117,6 +118,11 @@ public:
         return simulationControl::SimulationDescription::getInstance();
     }
 
+    simulationControl::StepProfiler& StepProfiler()
+    {
+        return simulationControl::StepProfiler::getInstance();
+    }
+
     PMacc::Filesystem<DIM>& Filesystem()
     {
         return PMacc::Filesystem<DIM>::getInstance();
@@ -284,4 +290,5 @@ private:
 
 #include "eventSystem/EventSystem.tpp"
 #include "particles/tasks/ParticleFactory.tpp"
+#include "simulationControl/StepProfiler.tpp"
 #include "eventSystem/events/CudaEvent.hpp"
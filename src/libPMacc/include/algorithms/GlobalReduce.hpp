@@ -53,6 +53,16 @@ public:
         mpi_reduce.participate(isActive);
     }
 
+    /* Start to change the participation without a global synchronization.
+     * Must called from any mpi process, the new participation is used by the
+     * next call of operator().
+     * @param isActive true if mpi rank should be part of reduce operation, else false
+     */
+    void participateAsync(bool isActive)
+    {
+        mpi_reduce.participateAsync(isActive);
+    }
+
     /* Reduce elements in global gpu memeory
      *
      * @param func functor for reduce which takes two arguments, first argument is the source and get the new reduced value.
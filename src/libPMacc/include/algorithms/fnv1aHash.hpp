@@ -0,0 +1,68 @@
+/**
+ * Copyright 2015-2017 Alexander Grund
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace PMacc
+{
+
+/** 32bit FNV-1a hash of a byte range
+ *
+ * The hash over several ranges is computed by passing the result of the
+ * previous call as `hash`. Not suited for cryptographic purposes.
+ *
+ * @param data begin of the range
+ * @param size number of bytes
+ * @param hash start value, FNV offset basis by default
+ * @return hash of the range
+ */
+inline uint32_t fnv1aHash32(const void* data, const size_t size, uint32_t hash = 2166136261u)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/** 64bit FNV-1a hash of a byte range
+ *
+ * @see fnv1aHash32
+ */
+inline uint64_t fnv1aHash64(const void* data, const size_t size, uint64_t hash = 14695981039346656037ull)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+} //namespace PMacc
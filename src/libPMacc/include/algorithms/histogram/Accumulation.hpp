@@ -0,0 +1,174 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "nvidia/atomic.hpp"
+
+#include <cmath>
+
+namespace PMacc
+{
+namespace algorithms
+{
+namespace histogram
+{
+
+    /** compensated summation of float_64 values
+     *
+     * Kahan-Babuska (Neumaier) variant, also exact if a summand is larger
+     * than the running sum.
+     */
+    struct KahanSum
+    {
+        float_64 sum;
+        float_64 compensation;
+
+        HDINLINE KahanSum() : sum(0.0), compensation(0.0)
+        {
+        }
+
+        HDINLINE void add(const float_64 value)
+        {
+            const float_64 t = sum + value;
+            if ((sum < 0.0 ? -sum : sum) >= (value < 0.0 ? -value : value))
+                compensation += (sum - t) + value;
+            else
+                compensation += (value - t) + sum;
+            sum = t;
+        }
+
+        HDINLINE float_64 get() const
+        {
+            return sum + compensation;
+        }
+    };
+
+namespace accumulation
+{
+
+    /** accumulate in 64bit fixed point
+     *
+     * Values are rounded to multiples of `resolution` and summed as 64bit
+     * integers. The sum is exact and independent of the order of the
+     * atomic operations, so results are reproducible and small
+     * contributions are never lost in large bins.
+     * The absolute value of each bin must stay below 2^63 * resolution.
+     */
+    struct FixedPoint
+    {
+        /* signed values are added in two's complement */
+        typedef uint64_cu StorageType;
+
+        /** @param resolution smallest value which can be represented */
+        HINLINE explicit FixedPoint(const float_64 resolution = 1.0 / float_64(1u << 24)) :
+            scale(1.0 / resolution)
+        {
+        }
+
+        template<typename T_Value>
+        HDINLINE StorageType toStorage(const T_Value value) const
+        {
+            /* clamp to the representable range instead of undefined behavior */
+            const float_64 maxValue = 9.2e18;
+            float_64 scaled = float_64(value) * scale;
+            scaled = scaled < maxValue ? scaled : maxValue;
+            scaled = scaled > -maxValue ? scaled : -maxValue;
+            return static_cast<StorageType>(static_cast<int64_cu>(llrint(scaled)));
+        }
+
+        HDINLINE float_64 toValue(const StorageType storage) const
+        {
+            return float_64(static_cast<int64_cu>(storage)) / scale;
+        }
+
+        HDINLINE static StorageType add(const StorageType a, const StorageType b)
+        {
+            return a + b;
+        }
+
+        DINLINE static void atomicAdd(StorageType* ptr, const StorageType value)
+        {
+            ::atomicAdd(ptr, value);
+        }
+
+        /** sum of `numValues` partial results with distance `stride` */
+        HDINLINE float_64 reduce(const StorageType* values, const uint32_t numValues, const size_t stride) const
+        {
+            StorageType sum = 0;
+            for (uint32_t i = 0; i < numValues; ++i)
+                sum += values[i * stride];
+            return toValue(sum);
+        }
+
+        float_64 scale;
+    };
+
+    /** accumulate in floating point
+     *
+     * The atomics are done in T_Type, partial results are summed with
+     * Kahan summation in float_64. Use this if the range of the values
+     * is not known, e.g. energies in simulation units.
+     *
+     * @tparam T_Type float_32 or float_64
+     */
+    template<typename T_Type>
+    struct Floating
+    {
+        typedef T_Type StorageType;
+
+        template<typename T_Value>
+        HDINLINE StorageType toStorage(const T_Value value) const
+        {
+            return static_cast<StorageType>(value);
+        }
+
+        HDINLINE float_64 toValue(const StorageType storage) const
+        {
+            return float_64(storage);
+        }
+
+        HDINLINE static StorageType add(const StorageType a, const StorageType b)
+        {
+            return a + b;
+        }
+
+        DINLINE static void atomicAdd(StorageType* ptr, const StorageType value)
+        {
+            nvidia::atomicAdd(ptr, value);
+        }
+
+        /** sum of `numValues` partial results with distance `stride` */
+        HDINLINE float_64 reduce(const StorageType* values, const uint32_t numValues, const size_t stride) const
+        {
+            KahanSum sum;
+            for (uint32_t i = 0; i < numValues; ++i)
+                sum.add(toValue(values[i * stride]));
+            return sum.get();
+        }
+    };
+
+} // namespace accumulation
+} // namespace histogram
+} // namespace algorithms
+} // namespace PMacc
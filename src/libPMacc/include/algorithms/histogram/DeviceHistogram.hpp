@@ -0,0 +1,192 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "algorithms/histogram/Accumulation.hpp"
+#include "nvidia/warp.hpp"
+
+namespace PMacc
+{
+namespace algorithms
+{
+namespace histogram
+{
+
+    /** histogram of one block
+     *
+     * Points either to a sub-histogram in shared memory, which is added to
+     * global memory by flush(), or directly to a sub-histogram in global
+     * memory if the bins do not fit into shared memory.
+     *
+     * add() and flush() must be called by all threads of the block.
+     */
+    template<typename T_Accumulation>
+    class BlockHistogram
+    {
+    public:
+        typedef T_Accumulation Accumulation;
+        typedef typename Accumulation::StorageType StorageType;
+
+        DINLINE BlockHistogram(StorageType* bins,
+                               StorageType* globalBins,
+                               const uint32_t numBins,
+                               const Accumulation& accumulation) :
+            bins(bins), globalBins(globalBins), numBins(numBins), accumulation(accumulation)
+        {
+        }
+
+        /** add a value to a bin
+         *
+         * Threads of a warp which add to the same bin are combined into one
+         * atomic operation. The combination stops as soon as a warp only
+         * contains different bins, then each thread adds its own value.
+         *
+         * @param isValid false if the thread has nothing to add
+         * @param bin index of the bin, must be < numBins if isValid is true
+         * @param value value to add
+         */
+        template<typename T_Value>
+        DINLINE void add(const bool isValid, const uint32_t bin, const T_Value value)
+        {
+            const StorageType storage = isValid ? accumulation.toStorage(value) : StorageType(0);
+#if (__CUDA_ARCH__ >= 300)
+            const uint32_t laneId = nvidia::getLaneId();
+            /* the shuffle reduction needs all lanes of the warp */
+            const bool isFullWarp = __ballot(1) == 0xffffffffu;
+            uint32_t pending = __ballot(isValid);
+
+            while (isFullWarp && pending != 0u)
+            {
+                const int leader = __ffs(pending) - 1;
+                const uint32_t leaderBin = nvidia::warpBroadcast(bin, leader);
+                const bool isPeer = ((pending >> laneId) & 1u) && bin == leaderBin;
+                const uint32_t peers = __ballot(isPeer);
+                /* scattered bins, the reduction would be more expensive than the atomics */
+                if (__popc(peers) == 1)
+                    break;
+
+                StorageType sum = isPeer ? storage : StorageType(0);
+                for (int laneMask = 16; laneMask > 0; laneMask /= 2)
+                    sum = Accumulation::add(sum, nvidia::warpShuffleXor(sum, laneMask));
+
+                if (laneId == uint32_t(leader))
+                    Accumulation::atomicAdd(bins + leaderBin, sum);
+                pending &= ~peers;
+            }
+
+            if ((pending >> laneId) & 1u)
+                Accumulation::atomicAdd(bins + bin, storage);
+#else
+            if (isValid)
+                Accumulation::atomicAdd(bins + bin, storage);
+#endif
+        }
+
+        /** add the shared sub-histogram to global memory
+         *
+         * Must be called by all threads of the block after the last add().
+         */
+        DINLINE void flush()
+        {
+            if (bins == globalBins)
+                return;
+
+            __syncthreads();
+            const uint32_t numThreads = blockDim.x * blockDim.y * blockDim.z;
+            const uint32_t linearThreadIdx = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+            for (uint32_t i = linearThreadIdx; i < numBins; i += numThreads)
+                if (bins[i] != StorageType(0))
+                    Accumulation::atomicAdd(globalBins + i, bins[i]);
+        }
+
+    private:
+        StorageType* bins;
+        StorageType* globalBins;
+        uint32_t numBins;
+        Accumulation accumulation;
+    };
+
+    /** device side handle of a histogram, passed by value to kernels
+     *
+     * Holds `numCopies` sub-histograms in global memory, block `b` adds to
+     * copy `b % numCopies`. If `useSharedMemory` is true each block
+     * accumulates in shared memory first, the kernel must be started with
+     * `numBins * sizeof(StorageType)` bytes of dynamic shared memory.
+     */
+    template<typename T_Accumulation>
+    struct DeviceHistogram
+    {
+        typedef T_Accumulation Accumulation;
+        typedef typename Accumulation::StorageType StorageType;
+
+        StorageType* subHistograms;
+        uint32_t numBins;
+        uint32_t numCopies;
+        bool useSharedMemory;
+        Accumulation accumulation;
+
+        /** histogram of the calling block
+         *
+         * Clears the shared sub-histogram, must be called by all threads of
+         * the block before any other access to the dynamic shared memory.
+         */
+        DINLINE BlockHistogram<Accumulation> getBlockHistogram() const
+        {
+            const uint32_t linearBlockIdx = blockIdx.x + gridDim.x * (blockIdx.y + gridDim.y * blockIdx.z);
+            StorageType* globalBins = subHistograms + size_t(linearBlockIdx % numCopies) * numBins;
+
+            if (!useSharedMemory)
+                return BlockHistogram<Accumulation>(globalBins, globalBins, numBins, accumulation);
+
+            /* uint64_cu: aligned for all storage types */
+            extern __shared__ uint64_cu s_mem_histogram[];
+            StorageType* sharedBins = reinterpret_cast<StorageType*>(s_mem_histogram);
+
+            const uint32_t numThreads = blockDim.x * blockDim.y * blockDim.z;
+            const uint32_t linearThreadIdx = threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+            for (uint32_t i = linearThreadIdx; i < numBins; i += numThreads)
+                sharedBins[i] = StorageType(0);
+            __syncthreads();
+
+            return BlockHistogram<Accumulation>(sharedBins, globalBins, numBins, accumulation);
+        }
+    };
+
+    /** sum all sub-histograms into the final float_64 histogram */
+    struct KernelMergeHistogram
+    {
+        template<typename T_DeviceHistogram>
+        DINLINE void operator()(const T_DeviceHistogram histogram, float_64* result) const
+        {
+            const uint32_t numThreads = blockDim.x * gridDim.x;
+            for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < histogram.numBins; i += numThreads)
+                result[i] = histogram.accumulation.reduce(histogram.subHistograms + i,
+                                                          histogram.numCopies,
+                                                          histogram.numBins);
+        }
+    };
+
+} // namespace histogram
+} // namespace algorithms
+} // namespace PMacc
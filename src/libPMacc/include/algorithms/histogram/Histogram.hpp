@@ -0,0 +1,147 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "algorithms/histogram/Accumulation.hpp"
+#include "algorithms/histogram/DeviceHistogram.hpp"
+#include "memory/buffers/GridBuffer.hpp"
+#include "eventSystem/EventSystem.hpp"
+
+#include <algorithm>
+
+namespace PMacc
+{
+namespace algorithms
+{
+namespace histogram
+{
+
+    /** histogram in GPU memory
+     *
+     * Kernels add values via getDeviceHistogram() (see DeviceHistogram and
+     * BlockHistogram): warp aggregated atomics into a sub-histogram per
+     * block in shared memory if all bins fit, else into one of several
+     * sub-histograms in global memory. merge() sums all sub-histograms
+     * once into a float_64 histogram.
+     *
+     * @tparam T_Accumulation accumulation::FixedPoint or accumulation::Floating<T>
+     */
+    template<typename T_Accumulation>
+    class Histogram
+    {
+    public:
+        typedef T_Accumulation Accumulation;
+        typedef typename Accumulation::StorageType StorageType;
+        typedef DeviceHistogram<Accumulation> DeviceHistogramType;
+
+        /**
+         * @param numBins number of bins
+         * @param accumulation accumulation policy
+         * @param maxSharedMemBytes shared memory per block available for the histogram
+         * @param maxGlobalMemBytes upper limit of the global memory for all sub-histograms
+         * @param maxCopies upper limit of the number of sub-histograms in global memory
+         */
+        Histogram(const uint32_t numBins,
+                  const Accumulation& accumulation = Accumulation(),
+                  const size_t maxSharedMemBytes = 32 * 1024,
+                  const size_t maxGlobalMemBytes = 64 * 1024 * 1024,
+                  const uint32_t maxCopies = 32) :
+            numBins(numBins), subHistograms(NULL), result(NULL)
+        {
+            deviceHistogram.numBins = numBins;
+            deviceHistogram.accumulation = accumulation;
+            deviceHistogram.useSharedMemory = size_t(numBins) * sizeof(StorageType) <= maxSharedMemBytes;
+
+            /* more copies reduce the contention of the global atomics */
+            const size_t bytesPerCopy = size_t(numBins) * sizeof(StorageType);
+            deviceHistogram.numCopies = static_cast<uint32_t>(
+                std::max(size_t(1), std::min(size_t(maxCopies), maxGlobalMemBytes / bytesPerCopy)));
+
+            subHistograms = new GridBuffer<StorageType, DIM1>(
+                DataSpace<DIM1>(deviceHistogram.numCopies * numBins));
+            deviceHistogram.subHistograms = subHistograms->getDeviceBuffer().getBasePointer();
+            result = new GridBuffer<float_64, DIM1>(DataSpace<DIM1>(numBins));
+
+            reset();
+        }
+
+        ~Histogram()
+        {
+            __delete(subHistograms);
+            __delete(result);
+        }
+
+        /** set all bins to zero */
+        void reset()
+        {
+            subHistograms->getDeviceBuffer().setValue(StorageType(0));
+        }
+
+        /** handle to pass to kernels */
+        DeviceHistogramType getDeviceHistogram() const
+        {
+            return deviceHistogram;
+        }
+
+        /** dynamic shared memory in bytes which must be passed to the kernel start */
+        size_t getSharedMemBytes() const
+        {
+            return deviceHistogram.useSharedMemory ? size_t(numBins) * sizeof(StorageType) : 0;
+        }
+
+        /** sum the sub-histograms and copy the result to the host
+         *
+         * @return histogram on the host, valid until the next merge()
+         */
+        const float_64* merge()
+        {
+            const uint32_t blockSize = 256;
+            const uint32_t gridSize = std::min((numBins + blockSize - 1) / blockSize, 1024u);
+            PMACC_KERNEL(KernelMergeHistogram{})
+                (gridSize, blockSize)
+                (deviceHistogram, result->getDeviceBuffer().getBasePointer());
+
+            result->deviceToHost();
+            __getTransactionEvent().waitForFinished();
+            return result->getHostBuffer().getBasePointer();
+        }
+
+        uint32_t getNumBins() const
+        {
+            return numBins;
+        }
+
+    private:
+        uint32_t numBins;
+        DeviceHistogramType deviceHistogram;
+        GridBuffer<StorageType, DIM1>* subHistograms;
+        GridBuffer<float_64, DIM1>* result;
+
+        Histogram(const Histogram&);
+        Histogram& operator=(const Histogram&);
+    };
+
+} // namespace histogram
+} // namespace algorithms
+} // namespace PMacc
@@ -0,0 +1,84 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "algorithms/histogram/Accumulation.hpp"
+
+#include <vector>
+#include <stdexcept>
+
+namespace PMacc
+{
+namespace algorithms
+{
+namespace histogram
+{
+
+    /** serial reference of Histogram on the host
+     *
+     * Each bin is a Kahan sum in float_64, independent of the accumulation
+     * policy of the GPU histogram. Used to validate and benchmark the GPU
+     * implementation.
+     */
+    class HostHistogram
+    {
+    public:
+
+        explicit HostHistogram(const uint32_t numBins) : bins(numBins)
+        {
+        }
+
+        void reset()
+        {
+            bins.assign(bins.size(), KahanSum());
+        }
+
+        void add(const uint32_t bin, const float_64 value)
+        {
+            if (bin >= bins.size())
+                throw std::runtime_error("HostHistogram: bin out of range");
+            bins[bin].add(value);
+        }
+
+        /** @return one value per bin */
+        std::vector<float_64> getResult() const
+        {
+            std::vector<float_64> result(bins.size());
+            for (size_t i = 0; i < bins.size(); ++i)
+                result[i] = bins[i].get();
+            return result;
+        }
+
+        uint32_t getNumBins() const
+        {
+            return static_cast<uint32_t>(bins.size());
+        }
+
+    private:
+        std::vector<KahanSum> bins;
+    };
+
+} // namespace histogram
+} // namespace algorithms
+} // namespace PMacc
@@ -28,12 +28,14 @@
 #include "dimensions/DataSpace.hpp"
 #include "memory/dataTypes/Mask.hpp"
 #include "pmacc_types.hpp"
+#include "algorithms/fnv1aHash.hpp"
 
 #include <mpi.h>
 
 #include <vector>
 #include <utility>
 #include <map>
+#include <cstring>
 
 namespace PMacc
 {
@@ -79,17 +81,22 @@ public:
 
     /*! ctor
      */
-    CommunicatorMPI() : hostRank(0)
+    CommunicatorMPI() : hostRank(0), nodeComm(MPI_COMM_NULL)
     {
         //MPI_Init(NULL, NULL);
     }
 
     /*! dtor
      *
-     * calls MPI_Finalize
+     * frees the node communicator, if MPI is not yet finalized
      */
     virtual ~CommunicatorMPI()
-    {}
+    {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized && nodeComm != MPI_COMM_NULL)
+            MPI_Comm_free(&nodeComm);
+    }
 
     virtual int getRank()
     {
@@ -111,6 +118,16 @@ public:
         return MPI_INFO_NULL;
     }
 
+    /*! returns a communicator of all processes on the same host (node)
+     *
+     * The rank within this communicator is the host rank \see getHostRank.
+     * Can be used e.g. to aggregate I/O per node.
+     */
+    MPI_Comm getMPINodeComm() const
+    {
+        return nodeComm;
+    }
+
     DataSpace<DIM3> getPeriodic() const
     {
         return this->periodic;
@@ -285,52 +302,68 @@ protected:
 
     /*! gets hostRank
      *
-     * process with MPI-rank 0 is the master and builds a map with hostname
-     * and number of already known processes on this host.
-     * Each rank will provide its hostname via MPISend and gets its HostRank
-     * from the master.
-     *
+     * MPI_COMM_WORLD is split into communicators of all processes on the
+     * same host (node), the rank in this communicator is the host rank.
+     * Processes are ordered by their MPI-rank on each host.
      */
     void updateHostRank()
+    {
+        MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &mpiSize));
+        MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank));
+
+#if (MPI_VERSION >= 3)
+        MPI_CHECK(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, mpiRank, MPI_INFO_NULL, &nodeComm));
+#else
+        splitByHostname();
+#endif
+        MPI_CHECK(MPI_Comm_rank(nodeComm, &hostRank));
+    }
+
+    /*! create nodeComm from the hostnames of all processes
+     *
+     * MPI_COMM_WORLD is split by a hash of the hostname, processes with
+     * different hostnames but equal hashes are separated by a second split
+     * within the (small) communicator of equal hashes.
+     */
+    void splitByHostname()
     {
         char hostname[MPI_MAX_PROCESSOR_NAME];
         int length;
 
+        memset(hostname, 0, MPI_MAX_PROCESSOR_NAME);
         MPI_CHECK(MPI_Get_processor_name(hostname, &length));
         cleanHostname(hostname);
-        hostname[length++] = '\0';
 
-        MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &mpiSize));
-        MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank));
+        /* MPI requires a non-negative color */
+        const uint32_t hash = fnv1aHash32(hostname, strnlen(hostname, MPI_MAX_PROCESSOR_NAME));
+        const int color = static_cast<int>(hash & 0x7fffffff);
 
-        if (mpiRank == 0)
-        {
-            std::map<std::string, int> hosts;
-            hosts[hostname] = 0;
-            hostRank = 0;
-            for (int rank = 1; rank < mpiSize; ++rank)
-            {
-                MPI_CHECK(MPI_Recv(hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR, rank, gridHostnameTag, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
+        MPI_Comm hashComm;
+        MPI_CHECK(MPI_Comm_split(MPI_COMM_WORLD, color, mpiRank, &hashComm));
 
-                //printf("Hostname: %s\n", hostname);
-                int hostrank = 0;
-                if (hosts.count(hostname) > 0) hostrank = hosts[hostname] + 1;
+        int hashSize;
+        int hashRank;
+        MPI_CHECK(MPI_Comm_size(hashComm, &hashSize));
+        MPI_CHECK(MPI_Comm_rank(hashComm, &hashRank));
 
-                MPI_CHECK(MPI_Send(&hostrank, 1, MPI_INT, rank, gridHostRankTag, MPI_COMM_WORLD));
+        std::vector<char> hostnames(hashSize * MPI_MAX_PROCESSOR_NAME);
+        MPI_CHECK(MPI_Allgather(hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                                &hostnames[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                                hashComm));
 
-                hosts[hostname] = hostrank;
-            }
-
-        }
-        else
+        /* the first process with the same hostname identifies the host */
+        int hostId = hashRank;
+        for (int i = 0; i < hashSize; ++i)
         {
-            MPI_CHECK(MPI_Send(hostname, length, MPI_CHAR, GridManagerRank, gridHostnameTag, MPI_COMM_WORLD));
-
-            MPI_CHECK(MPI_Recv(&hostRank, 1, MPI_INT, GridManagerRank, gridHostRankTag, MPI_COMM_WORLD, MPI_STATUS_IGNORE));
-
-            // if(hostRank!=0) hostRank--; //!\todo fix mpi hostrank start with 1
+            if (strncmp(hostname, &hostnames[i * MPI_MAX_PROCESSOR_NAME], MPI_MAX_PROCESSOR_NAME) == 0)
+            {
+                hostId = i;
+                break;
+            }
         }
 
+        MPI_CHECK(MPI_Comm_split(hashComm, hostId, hashRank, &nodeComm));
+        MPI_CHECK(MPI_Comm_free(&hashComm));
     }
 
     /*! update coordinates \see getCoordinates
@@ -435,6 +468,8 @@ private:
     Mask communicationMask;
     //! rank of this process local to its host (node)
     int hostRank;
+    //! communicator of all processes on the same host (node)
+    MPI_Comm nodeComm;
     //! offset for sliding window
     int yoffset;
 
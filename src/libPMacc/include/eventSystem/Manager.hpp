@@ -26,8 +26,9 @@
 #include "eventSystem/tasks/ITask.hpp"
 #include "Environment.def"
 
-#include <map>
-#include <set>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace PMacc
 {
@@ -36,12 +37,17 @@ namespace PMacc
 
     /**
      * Manages the event system by executing and waiting for tasks.
+     *
+     * Active tasks are polled round-robin from a ready queue. Tasks which
+     * report ITask::isWaitingForEvent() are parked after their execution and
+     * only polled again after one of the tasks they observe notified them.
      */
     class Manager : public IEvent
     {
     public:
-        typedef std::map<id_t, ITask*> TaskMap;
-        typedef std::set<id_t> TaskSet;
+        typedef std::unordered_map<id_t, ITask*> TaskMap;
+        typedef std::unordered_set<id_t> TaskSet;
+        typedef std::deque<id_t> TaskQueue;
 
         bool execute(id_t taskToWait = 0);
 
@@ -72,6 +78,16 @@ namespace PMacc
 
         void addPassiveTask(ITask *task);
 
+        /**
+         * move a parked task back into the ready queue
+         *
+         * Called after a task was notified by an observed task.
+         * Nothing happens if the task is not parked.
+         *
+         * @param taskId id of the notified task
+         */
+        void wakeUp(id_t taskId);
+
 
         std::size_t getCount();
 
@@ -85,6 +101,9 @@ namespace PMacc
 
         inline ITask* getActiveITaskIfNotFinished(id_t taskId) const;
 
+        /** move all parked tasks back into the ready queue */
+        inline void wakeUpAll();
+
         Manager();
 
         Manager(const Manager& cc);
@@ -99,6 +118,10 @@ namespace PMacc
 
         TaskMap tasks;
         TaskMap passiveTasks;
+        /** active tasks which are polled by execute() */
+        TaskQueue readyTasks;
+        /** active tasks which wait for a notification */
+        TaskSet waitingTasks;
     };
 
 } //namespace PMacc
@@ -29,7 +29,7 @@
 
 #include <cstdlib>
 #include <cstdio>
-#include <set>
+#include <utility>
 #include <iostream>
 
 //#define DEBUG_EVENTS
@@ -59,18 +59,24 @@ inline bool Manager::execute( id_t taskToWait )
     }
 #endif
 
-    static TaskMap::iterator iter = tasks.begin( );
+    /* all ready tasks are parked: poll them anyway to avoid that a task
+     * which missed its notification is never executed again */
+    if ( readyTasks.empty( ) )
+        wakeUpAll( );
 
-    if ( iter == tasks.end( ) )
-        iter = tasks.begin( );
-
-    // this is the slow but very save variant to delete tasks in a map
-    while ( iter != tasks.end( ) )
+    /* visit each ready task at most once per call, re-queued tasks are
+     * executed by the next call (round-robin) */
+    std::size_t numReadyTasks = readyTasks.size( );
+    while ( numReadyTasks != 0 && !readyTasks.empty( ) )
     {
-        id_t id = iter->first;
-        ITask* taskPtr = iter->second;
-        PMACC_ASSERT( taskPtr != NULL );
-        ++iter;
+        --numReadyTasks;
+        id_t id = readyTasks.front( );
+        readyTasks.pop_front( );
+
+        ITask* taskPtr = getActiveITaskIfNotFinished( id );
+        /* task was removed by other stackdeep */
+        if ( taskPtr == NULL )
+            continue;
 #ifdef DEBUG_EVENTS
         if ( counter == 500000 )
             std::cout << taskPtr->toString( ) << " " << passiveTasks.size( ) << std::endl;
@@ -89,13 +95,16 @@ inline bool Manager::execute( id_t taskToWait )
 
             if ( taskToWait == id )
             {
-                iter = tasks.end( );
 #ifdef DEBUG_EVENTS
                 --deep;
 #endif
                 return true; //jump out because searched task is finished
             }
         }
+        else if ( taskPtr->isWaitingForEvent( ) )
+            waitingTasks.insert( id );
+        else
+            readyTasks.push_back( id );
     }
 
 #ifdef DEBUG_EVENTS
@@ -179,7 +188,21 @@ inline void Manager::waitForAllTasks( )
 inline void Manager::addTask( ITask *task )
 {
     PMACC_ASSERT( task != NULL );
-    tasks[task->getId( )] = task;
+    if ( tasks.insert( std::make_pair( task->getId( ), task ) ).second )
+        readyTasks.push_back( task->getId( ) );
+}
+
+inline void Manager::wakeUp( id_t taskId )
+{
+    if ( waitingTasks.erase( taskId ) != 0 )
+        readyTasks.push_back( taskId );
+}
+
+inline void Manager::wakeUpAll( )
+{
+    for ( TaskSet::iterator iter = waitingTasks.begin( ); iter != waitingTasks.end( ); ++iter )
+        readyTasks.push_back( *iter );
+    waitingTasks.clear( );
 }
 
 inline void Manager::addPassiveTask( ITask *task )
@@ -25,6 +25,8 @@
 #include "eventSystem/events/EventNotify.hpp"
 #include "eventSystem/events/IEventData.hpp"
 #include "eventSystem/events/IEvent.hpp"
+#include "eventSystem/tasks/ITask.hpp"
+#include "Environment.hpp"
 #include "pmacc_types.hpp"
 
 #include <set>
@@ -38,7 +40,17 @@ namespace PMacc
             for (; iter != observers.end( ); iter++ )
             {
                 if ( *iter != NULL )
+                {
+                    /* the observer can delete itself within event(), query the id first */
+                    ITask* task = dynamic_cast<ITask*>( *iter );
+                    const id_t observerId = task != NULL ? task->getId( ) : 0;
+
                     ( *iter )->event( eventId, type, data );
+
+                    /* a parked task can make progress after it was notified */
+                    if ( observerId != 0 )
+                        Environment<>::get( ).Manager( ).wakeUp( observerId );
+                }
             }
             /* if notify is not called from destructor
              * other tasks can register after this call.
@@ -74,6 +74,20 @@ namespace PMacc
             return executeIntern();
         }
 
+        /**
+         * Returns if this task can only make progress after it was notified
+         * by an observed task (see IEvent::event).
+         *
+         * The Manager does not poll waiting tasks, they are moved back into
+         * the ready queue as soon as they receive a notification.
+         *
+         * @return true if executing the task now would not change its state
+         */
+        virtual bool isWaitingForEvent()
+        {
+            return false;
+        }
+
         /**
          * Initializes the task.
          * Must be called before adding the task to the Manager's queue.
@@ -91,6 +91,12 @@ namespace PMacc
             return false;
         }
 
+        bool isWaitingForEvent()
+        {
+            /* the MPI receive and the copy notify this task */
+            return state == WaitForReceived || state == WaitForFinish;
+        }
+
         virtual ~TaskReceive()
         {
             notify(this->myId, RECVFINISHED, NULL);
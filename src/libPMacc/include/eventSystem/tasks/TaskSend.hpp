@@ -91,6 +91,12 @@ namespace PMacc
             return false;
         }
 
+        bool isWaitingForEvent()
+        {
+            /* the copy and the MPI send notify this task */
+            return state == InitDone || state == SendDone;
+        }
+
         virtual ~TaskSend()
         {
             notify(this->myId, SENDFINISHED, NULL);
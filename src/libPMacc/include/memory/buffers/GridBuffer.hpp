@@ -357,6 +357,44 @@ public:
         addExchangeBuffer( receive, dataSpace, communicationTag, sizeOnDevice, sizeOnDevice );
     }
 
+    /**
+     * Change the size of an Exchange in dedicated memory space.
+     *
+     * Replaces the send exchange in direction sendEx and the receive exchange
+     * of the mirrored direction, both created by addExchangeBuffer(). The
+     * communication tag and the size-on-device settings are kept, the content
+     * is lost.
+     * A receiver must be able to hold all data the neighbor sends, therefore
+     * all ranks must call this method with the same size for a direction.
+     *
+     * @param sendEx send direction of the exchange
+     * @param dataSpace new size of the exchange buffer in each dimension
+     */
+    void resizeExchangeBuffer(uint32_t sendEx, const DataSpace<DIM> &dataSpace)
+    {
+        const ExchangeType recvEx = Mask::getMirroredExchangeType(sendEx);
+        if (sendExchanges[sendEx] == NULL || receiveExchanges[recvEx] == NULL)
+            throw std::runtime_error("Exchange to resize was never added!");
+        if (dataSpace.productOfComponents() == 0)
+            throw std::runtime_error("Exchange can not be resized to zero elements!");
+
+        /* the old buffers must not be used by a running send or receive */
+        sendEvents[sendEx].waitForFinished();
+        receiveEvents[recvEx].waitForFinished();
+
+        const uint32_t uniqCommunicationTag = sendExchanges[sendEx]->getCommunicationTag();
+        const bool sizeOnDeviceSend = sendExchanges[sendEx]->getDeviceBuffer().hasCurrentSizeOnDevice();
+        const bool sizeOnDeviceReceive = receiveExchanges[recvEx]->getDeviceBuffer().hasCurrentSizeOnDevice();
+
+        __delete(sendExchanges[sendEx]);
+        __delete(receiveExchanges[recvEx]);
+
+        sendExchanges[sendEx] = new ExchangeIntern<BORDERTYPE, DIM > (dataSpace, sendEx,
+                                                                      uniqCommunicationTag, sizeOnDeviceSend);
+        receiveExchanges[recvEx] = new ExchangeIntern<BORDERTYPE, DIM > (dataSpace, recvEx,
+                                                                         uniqCommunicationTag, sizeOnDeviceReceive);
+    }
+
     /**
      * Returns whether this GridBuffer has an Exchange for sending in ex direction.
      *
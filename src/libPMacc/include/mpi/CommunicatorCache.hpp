@@ -0,0 +1,374 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "communication/manager_common.h"
+#include "pmacc_types.hpp"
+
+#include <mpi.h>
+
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+
+namespace PMacc
+{
+namespace mpi
+{
+
+    /** cache of sub-communicators of MPI_COMM_WORLD
+     *
+     * Communicators are keyed by the set of participating ranks. A request
+     * exchanges only the participation flag of each rank (one integer
+     * all-gather). If a communicator for the same rank set was created
+     * before, e.g. by another plugin or before a window slide, it is reused.
+     * Otherwise it is created with `MPI_Comm_create_group`, which is
+     * collective only over the participating ranks.
+     *
+     * The communicator of all ranks is available without any communication.
+     *
+     * Requests can be non-blocking (requestCommunicator()). They must be
+     * issued in the same order on all ranks and are always completed in
+     * this order, a test or wait completes all earlier requests first.
+     *
+     * Cached communicators are kept for reuse until clear() is called.
+     *
+     * Without MPI-3 the all-gather is blocking and new communicators are
+     * created with `MPI_Comm_create`, which is collective over all ranks.
+     */
+    class CommunicatorCache
+    {
+    private:
+
+        struct RequestState
+        {
+            int isActive;
+            std::vector<int> participation;
+            MPI_Request request;
+            bool isDone;
+            MPI_Comm comm;
+        };
+
+    public:
+
+        /** handle of a pending communicator request */
+        class Request
+        {
+        public:
+
+            Request()
+            {
+            }
+
+        private:
+
+            friend class CommunicatorCache;
+
+            explicit Request(const std::shared_ptr<RequestState>& state) : state(state)
+            {
+            }
+
+            std::shared_ptr<RequestState> state;
+        };
+
+        static CommunicatorCache& getInstance()
+        {
+            static CommunicatorCache instance;
+            return instance;
+        }
+
+        /** communicator of all ranks
+         *
+         * No communication is required if it already exists, the first call
+         * must be done by all ranks.
+         */
+        MPI_Comm getCommunicatorAllRanks()
+        {
+            int numRanks = 0;
+            MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numRanks));
+
+            std::vector<int> allRanks(numRanks);
+            for (int i = 0; i < numRanks; ++i)
+                allRanks[i] = i;
+
+            Cache::iterator it = cache.find(allRanks);
+            if (it == cache.end())
+            {
+                Entry entry;
+                MPI_CHECK(MPI_Comm_dup(MPI_COMM_WORLD, &entry.comm));
+                entry.refCount = 0;
+                it = cache.insert(Cache::value_type(allRanks, entry)).first;
+#if (MPI_VERSION < 3)
+                createdGroups.insert(allRanks);
+#endif
+            }
+            it->second.refCount++;
+            return it->second.comm;
+        }
+
+        /** start a non-blocking request for the communicator of all active ranks
+         *
+         * Must be called by all ranks in the same order.
+         *
+         * @param isActive true if this rank is part of the communicator
+         */
+        Request requestCommunicator(bool isActive)
+        {
+            int numRanks = 0;
+            MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &numRanks));
+
+            std::shared_ptr<RequestState> state(new RequestState());
+            state->isActive = isActive ? 1 : 0;
+            state->participation.resize(numRanks);
+            state->isDone = false;
+            state->comm = MPI_COMM_NULL;
+
+#if (MPI_VERSION >= 3)
+            MPI_CHECK(MPI_Iallgather(&state->isActive, 1, MPI_INT,
+                                     &state->participation[0], 1, MPI_INT,
+                                     MPI_COMM_WORLD, &state->request));
+#else
+            /* test and wait of the null request return immediately */
+            MPI_CHECK(MPI_Allgather(&state->isActive, 1, MPI_INT,
+                                    &state->participation[0], 1, MPI_INT,
+                                    MPI_COMM_WORLD));
+            state->request = MPI_REQUEST_NULL;
+#endif
+            pending.push_back(state);
+
+            return Request(state);
+        }
+
+        /** test if a request is finished
+         *
+         * Never blocks if the participating ranks are known locally. If the
+         * communicator is not cached it is created, which synchronizes the
+         * participating ranks.
+         *
+         * @return true if wait() returns without blocking
+         */
+        bool test(Request& request)
+        {
+            if (!request.state)
+                throw std::runtime_error("CommunicatorCache: test() on an empty request");
+
+            while (!request.state->isDone)
+            {
+                std::shared_ptr<RequestState> state = pending.front();
+                int isFinished = 0;
+                MPI_CHECK(MPI_Test(&state->request, &isFinished, MPI_STATUS_IGNORE));
+                if (!isFinished)
+                    return false;
+                finish(*state);
+                pending.pop_front();
+            }
+            return true;
+        }
+
+        /** wait for a request
+         *
+         * @return communicator of all active ranks, MPI_COMM_NULL on inactive ranks
+         */
+        MPI_Comm wait(Request& request)
+        {
+            if (!request.state)
+                throw std::runtime_error("CommunicatorCache: wait() on an empty request");
+
+            while (!request.state->isDone)
+            {
+                std::shared_ptr<RequestState> state = pending.front();
+                MPI_CHECK(MPI_Wait(&state->request, MPI_STATUS_IGNORE));
+                finish(*state);
+                pending.pop_front();
+            }
+            return request.state->comm;
+        }
+
+        /** blocking request of the communicator of all active ranks
+         *
+         * Must be called by all ranks.
+         *
+         * @param isActive true if this rank is part of the communicator
+         * @return communicator of all active ranks, MPI_COMM_NULL on inactive ranks
+         */
+        MPI_Comm getCommunicator(bool isActive)
+        {
+            Request request = requestCommunicator(isActive);
+            return wait(request);
+        }
+
+        /** return a communicator
+         *
+         * The communicator stays cached for later requests of the same ranks.
+         * MPI_COMM_NULL is ignored.
+         */
+        void release(MPI_Comm comm)
+        {
+            if (comm == MPI_COMM_NULL)
+                return;
+
+            for (Cache::iterator it = cache.begin(); it != cache.end(); ++it)
+                if (it->second.comm == comm)
+                {
+                    if (it->second.refCount == 0)
+                        throw std::runtime_error("CommunicatorCache: communicator released too often");
+                    it->second.refCount--;
+                    return;
+                }
+            throw std::runtime_error("CommunicatorCache: communicator was not created by the cache");
+        }
+
+        /** free all cached communicators
+         *
+         * Must be called by all ranks if no communicator is used anymore,
+         * all communicators must be released before.
+         */
+        void clear()
+        {
+            for (Cache::iterator it = cache.begin(); it != cache.end(); ++it)
+                if (it->second.refCount != 0)
+                    throw std::runtime_error("CommunicatorCache: clear() with a communicator in use");
+
+            for (Cache::iterator it = cache.begin(); it != cache.end(); ++it)
+                MPI_CHECK(MPI_Comm_free(&it->second.comm));
+            cache.clear();
+#if (MPI_VERSION < 3)
+            createdGroups.clear();
+#endif
+        }
+
+        /** number of cached communicators this rank is part of */
+        size_t size() const
+        {
+            return cache.size();
+        }
+
+    private:
+
+        struct Entry
+        {
+            MPI_Comm comm;
+            int refCount;
+        };
+
+        /** participating ranks (ordered) -> communicator */
+        typedef std::map<std::vector<int>, Entry> Cache;
+
+        /** tag to separate the creation from user communication */
+        static constexpr int createTag = 7531;
+
+        CommunicatorCache()
+        {
+        }
+
+        ~CommunicatorCache()
+        {
+            /* communicators are released by MPI_Finalize if clear() was not called,
+             * communicators which are still in use are never freed
+             */
+            int isFinalized = 0;
+            MPI_Finalized(&isFinalized);
+            if (!isFinalized)
+                for (Cache::iterator it = cache.begin(); it != cache.end(); ++it)
+                    if (it->second.refCount == 0)
+                        MPI_Comm_free(&it->second.comm);
+        }
+
+        CommunicatorCache(const CommunicatorCache&);
+        CommunicatorCache& operator=(const CommunicatorCache&);
+
+        /** create the communicator of a group of ranks
+         *
+         * MPI-3: collective over the ranks of the group only,
+         * else collective over all ranks (MPI_COMM_NULL on non-members)
+         */
+        static MPI_Comm createCommunicator(const std::vector<int>& groupRanks)
+        {
+            MPI_Group worldGroup = MPI_GROUP_NULL;
+            MPI_Group newGroup = MPI_GROUP_NULL;
+            MPI_CHECK(MPI_Comm_group(MPI_COMM_WORLD, &worldGroup));
+            MPI_CHECK(MPI_Group_incl(worldGroup, static_cast<int>(groupRanks.size()), &groupRanks[0], &newGroup));
+
+            MPI_Comm comm = MPI_COMM_NULL;
+#if (MPI_VERSION >= 3)
+            MPI_CHECK(MPI_Comm_create_group(MPI_COMM_WORLD, newGroup, createTag, &comm));
+#else
+            MPI_CHECK(MPI_Comm_create(MPI_COMM_WORLD, newGroup, &comm));
+#endif
+
+            MPI_CHECK(MPI_Group_free(&worldGroup));
+            MPI_CHECK(MPI_Group_free(&newGroup));
+            return comm;
+        }
+
+        /** look up or create the communicator of a finished all-gather */
+        void finish(RequestState& state)
+        {
+            state.isDone = true;
+
+            std::vector<int> groupRanks;
+            for (size_t i = 0; i < state.participation.size(); ++i)
+                if (state.participation[i] != 0)
+                    groupRanks.push_back(static_cast<int>(i));
+
+#if (MPI_VERSION < 3)
+            /* MPI_Comm_create must be called by all ranks, therefore each rank
+             * knows all created groups, also those it is not part of */
+            if (!groupRanks.empty() && createdGroups.insert(groupRanks).second)
+            {
+                Entry entry;
+                entry.comm = createCommunicator(groupRanks);
+                entry.refCount = 0;
+                if (state.isActive)
+                    cache.insert(Cache::value_type(groupRanks, entry));
+            }
+#endif
+            if (!state.isActive)
+                return;
+
+            Cache::iterator it = cache.find(groupRanks);
+            if (it == cache.end())
+            {
+                Entry entry;
+                entry.comm = createCommunicator(groupRanks);
+                entry.refCount = 0;
+                it = cache.insert(Cache::value_type(groupRanks, entry)).first;
+            }
+            it->second.refCount++;
+            state.comm = it->second.comm;
+        }
+
+        Cache cache;
+#if (MPI_VERSION < 3)
+        /** all groups created by MPI_Comm_create, on member and non-member ranks */
+        std::set<std::vector<int> > createdGroups;
+#endif
+        /** requests in the order of issue which are not finished */
+        std::deque<std::shared_ptr<RequestState> > pending;
+    };
+
+} // namespace mpi
+} // namespace PMacc
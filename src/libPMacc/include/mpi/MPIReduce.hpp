@@ -24,6 +24,7 @@
 
 #include "communication/manager_common.h"
 
+#include "mpi/CommunicatorCache.hpp"
 #include "mpi/reduceMethods/AllReduce.hpp"
 #include "mpi/GetMPI_StructAsArray.hpp"
 #include "mpi/GetMPI_Op.hpp"
@@ -41,24 +42,28 @@ struct MPIReduce
 {
 
     /*reduce data over selected mpi nodes*/
-    MPIReduce() : mpiRank(-1), numRanks(0), comm(MPI_COMM_NULL), isMPICommInitialized(false)
+    MPIReduce() : mpiRank(-1), numRanks(0), comm(MPI_COMM_NULL), isMPICommInitialized(false),
+        isParticipationPending(false)
     {
-        participate(true);
+        /* all ranks participate, the communicator is shared by all instances */
+        comm = CommunicatorCache::getInstance().getCommunicatorAllRanks();
+        MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
+        MPI_CHECK(MPI_Comm_size(comm, &numRanks));
+        isMPICommInitialized = true;
     }
 
     virtual ~MPIReduce()
     {
-        if (isMPICommInitialized)
-        {
-            MPI_CHECK(MPI_Comm_free(&comm));
-        }
+        finishParticipation();
+        CommunicatorCache::getInstance().release(comm);
     }
 
-    /*
+    /* must not be called between participateAsync() and operator()
      * @return if resut of operator() is valid*/
     template<class MPIMethod>
     bool hasResult(const MPIMethod & method) const
     {
+        PMACC_ASSERT(isParticipationPending == false);
         PMACC_ASSERT(isMPICommInitialized == true);
         return method.hasResult(mpiRank);
     }
@@ -73,53 +78,34 @@ struct MPIReduce
 
     /* Activate participation for reduce algorithm.
      * Must called from any mpi process. This function use global blocking mpi calls.
+     * Communicators of the same participating ranks are shared, see CommunicatorCache.
      * @param isActive true if mpi rank should be part of reduce operation, else false
      */
     void participate(bool isActive)
     {
-        /*free old communicator of init is called again*/
-        if (isMPICommInitialized)
-        {
-            MPI_CHECK(MPI_Comm_free(&comm));
-            mpiRank = -1;
-            numRanks = 0;
-            isMPICommInitialized = false;
-        }
-
-        int countRanks;
-        MPI_CHECK(MPI_Comm_size(MPI_COMM_WORLD, &countRanks));
-        std::vector<int> reduceRank(countRanks);
-        std::vector<int> groupRanks(countRanks);
-        MPI_CHECK(MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank));
-
-        if (!isActive)
-            mpiRank = -1;
-
-        MPI_CHECK(MPI_Allgather(&mpiRank, 1, MPI_INT, &reduceRank[0], 1, MPI_INT, MPI_COMM_WORLD));
-
-        for (int i = 0; i < countRanks; ++i)
-        {
-            if (reduceRank[i] != -1)
-            {
-                groupRanks[numRanks] = reduceRank[i];
-                numRanks++ ;
-            }
-        }
+        participateAsync(isActive);
+        finishParticipation();
+    }
 
-        MPI_Group group = MPI_GROUP_NULL;
-        MPI_Group newgroup = MPI_GROUP_NULL;
-        MPI_CHECK(MPI_Comm_group(MPI_COMM_WORLD, &group));
-        MPI_CHECK(MPI_Group_incl(group, numRanks, &groupRanks[0], &newgroup));
+    /* Start to change the participation without a global synchronization.
+     * Must called from any mpi process. The new communicator is used by the
+     * next call of operator() which can block until all ranks have called
+     * participateAsync().
+     * @param isActive true if mpi rank should be part of reduce operation, else false
+     */
+    void participateAsync(bool isActive)
+    {
+        finishParticipation();
 
-        MPI_CHECK(MPI_Comm_create(MPI_COMM_WORLD, newgroup, &comm));
+        /*return old communicator if participate is called again*/
+        CommunicatorCache::getInstance().release(comm);
+        comm = MPI_COMM_NULL;
+        mpiRank = -1;
+        numRanks = 0;
+        isMPICommInitialized = false;
 
-        if (mpiRank != -1)
-        {
-            MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
-            isMPICommInitialized = true;
-        }
-        MPI_CHECK(MPI_Group_free(&group));
-        MPI_CHECK(MPI_Group_free(&newgroup));
+        participation = CommunicatorCache::getInstance().requestCommunicator(isActive);
+        isParticipationPending = true;
     }
 
     /* Reduce elements on cpu memory
@@ -142,6 +128,7 @@ struct MPIReduce
     {
         typedef Type ValueType;
 
+        finishParticipation();
         method(func,
                dest,
                src,
@@ -174,10 +161,30 @@ struct MPIReduce
 
 private:
 
+    /* use the communicator of the last participateAsync() call */
+    void finishParticipation()
+    {
+        if (!isParticipationPending)
+            return;
+
+        comm = CommunicatorCache::getInstance().wait(participation);
+        isParticipationPending = false;
+
+        if (comm != MPI_COMM_NULL)
+        {
+            MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
+            MPI_CHECK(MPI_Comm_size(comm, &numRanks));
+            isMPICommInitialized = true;
+        }
+    }
+
     MPI_Comm comm;
     int mpiRank;
     int numRanks;
     bool isMPICommInitialized;
+
+    CommunicatorCache::Request participation;
+    bool isParticipationPending;
 };
 }
 }//namespace
@@ -103,6 +103,53 @@ DINLINE double warpBroadcast(double data, const int32_t srcLaneId)
     pData[1] = warpBroadcast(pData[1], srcLaneId);
     return data;
 }
+
+/** exchange data with the lane laneId ^ laneMask (butterfly pattern)
+ *
+ * All lanes of the warp must take part.
+ * required PTX ISA >=3.0
+ */
+DINLINE int32_t warpShuffleXor(const int32_t data, const int32_t laneMask)
+{
+    return __shfl_xor(data, laneMask);
+}
+/**
+ * Exchange a 64bit integer by using 2 32bit exchanges
+ */
+DINLINE int64_cu warpShuffleXor(int64_cu data, const int32_t laneMask)
+{
+    int32_t* const pData = reinterpret_cast<int32_t*>(&data);
+    pData[0] = warpShuffleXor(pData[0], laneMask);
+    pData[1] = warpShuffleXor(pData[1], laneMask);
+    return data;
+}
+/**
+ * Exchange a 64bit unsigned int
+ * Maps to signed int function with no additional overhead
+ */
+DINLINE uint64_cu warpShuffleXor(const uint64_cu data, const int32_t laneMask)
+{
+    return static_cast<uint64_cu>(
+            warpShuffleXor(static_cast<int64_cu>(data), laneMask)
+            );
+}
+/**
+ * Exchange a 32bit float
+ */
+DINLINE float warpShuffleXor(const float data, const int32_t laneMask)
+{
+    return __shfl_xor(data, laneMask);
+}
+/**
+ * Exchange a 64bit float by using 2 32bit exchanges
+ */
+DINLINE double warpShuffleXor(double data, const int32_t laneMask)
+{
+    float* const pData = reinterpret_cast<float*>(&data);
+    pData[0] = warpShuffleXor(pData[0], laneMask);
+    pData[1] = warpShuffleXor(pData[1], laneMask);
+    return data;
+}
 #endif
 
 } //namespace nvidia
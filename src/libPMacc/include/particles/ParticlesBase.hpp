@@ -29,11 +29,15 @@
 
 #include "particles/memory/boxes/ParticlesBox.hpp"
 #include "particles/memory/buffers/ParticlesBuffer.hpp"
+#include "particles/memory/buffers/AdaptiveExchangeSize.hpp"
+#include "particles/memory/dataTypes/ExchangeStatistics.hpp"
 
 #include "mappings/kernel/StrideMapping.hpp"
 #include "traits/NumberOfExchanges.hpp"
 #include "assert.hpp"
 
+#include <vector>
+
 
 namespace PMacc
 {
@@ -149,6 +153,32 @@ public:
         this->fillGaps < BORDER > ();
     }
 
+    /* Sort the particles inside each supercell by their cell.
+     *
+     * Needs heap memory for a copy of the frames of the sorted supercells,
+     * supercells without free memory keep their order.
+     * The supercells are sorted in strides to bound this memory to a
+     * fraction of the frames.
+     *
+     * @tparam T_maxFrames supercells with more frames are not sorted
+     */
+    template<uint32_t T_maxFrames>
+    void sortParticlesByCell()
+    {
+        StrideMapping<CORE + BORDER, 3, MappingDesc> mapper(this->cellDescription);
+        ParticlesBoxType pBox = particlesBuffer->getDeviceParticleBox();
+
+        __startTransaction(__getTransactionEvent());
+        do
+        {
+            PMACC_KERNEL(KernelSortParticlesByCell<T_maxFrames>{})
+                (mapper.getGridDim(), (int)TileSize)
+                (pBox, mapper);
+        }
+        while (mapper.next());
+        __setTransactionEvent(__endTransaction());
+    }
+
     /* Delete all particles in GUARD for one direction.
      */
     void deleteGuardParticles(uint32_t exchangeType);
@@ -166,6 +196,19 @@ public:
      */
     void insertParticles(uint32_t exchangeType);
 
+    /* Resize the exchange buffers to the traffic observed since the last call.
+     *
+     * Collective over all ranks, waits for all running exchanges.
+     * Buffers are only grown if at least minFreeMemory bytes of device
+     * memory stay free on all ranks.
+     *
+     * @param policy sizing policy
+     * @param minFreeMemory device memory in byte which must stay free
+     * @return global statistics and new capacity of each exchange buffer
+     */
+    std::vector<ExchangeBufferReport> adaptExchangeBuffers(const AdaptiveExchangeSize& policy,
+                                                           size_t minFreeMemory);
+
     ParticlesBoxType getDeviceParticlesBox()
     {
         return particlesBuffer->getDeviceParticleBox();
@@ -31,6 +31,10 @@
 #include "particles/memory/boxes/ParticlesBox.hpp"
 #include "particles/memory/buffers/ParticlesBuffer.hpp"
 
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+
 
 namespace PMacc
 {
@@ -102,6 +106,84 @@ namespace PMacc
         }
     }
 
+    template<typename T_ParticleDescription, class MappingDesc>
+    std::vector<ExchangeBufferReport>
+    ParticlesBase<T_ParticleDescription, MappingDesc>::adaptExchangeBuffers(const AdaptiveExchangeSize& policy,
+                                                                            size_t minFreeMemory)
+    {
+        /* the buffers must not be replaced while an exchange is running */
+        __getTransactionEvent().waitForFinished();
+
+        MPI_Comm comm = Environment<MappingDesc::Dim>::get().GridController().getCommunicator().getMPIComm();
+
+        /* high water mark and number of steps are reduced with max, the counters with sum */
+        uint64_t localMax[2 * Exchanges];
+        uint64_t localSum[3 * Exchanges];
+        for (uint32_t ex = 0; ex < Exchanges; ++ex)
+        {
+            const ExchangeStatistics& statistics = particlesBuffer->getSendExchangeStatistics(ex);
+            localMax[2 * ex] = statistics.highWaterMark;
+            localMax[2 * ex + 1] = statistics.numSteps;
+            localSum[3 * ex] = statistics.numParticles;
+            localSum[3 * ex + 1] = statistics.numExtraRounds;
+            localSum[3 * ex + 2] = statistics.numOverflows;
+        }
+        uint64_t globalMax[2 * Exchanges];
+        uint64_t globalSum[3 * Exchanges];
+        MPI_CHECK(MPI_Allreduce(localMax, globalMax, 2 * Exchanges, MPI_UINT64_T, MPI_MAX, comm));
+        MPI_CHECK(MPI_Allreduce(localSum, globalSum, 3 * Exchanges, MPI_UINT64_T, MPI_SUM, comm));
+
+        /* all inputs are global, each rank takes the same decisions */
+        std::vector<ExchangeBufferReport> report;
+        size_t growBytes = 0;
+        for (uint32_t ex = 1; ex < Exchanges; ++ex)
+        {
+            if (!particlesBuffer->hasExchangeBuffer(ex))
+                continue;
+
+            ExchangeBufferReport entry;
+            entry.exchange = ex;
+            entry.statistics.highWaterMark = globalMax[2 * ex];
+            entry.statistics.numSteps = globalMax[2 * ex + 1];
+            entry.statistics.numParticles = globalSum[3 * ex];
+            entry.statistics.numExtraRounds = globalSum[3 * ex + 1];
+            entry.statistics.numOverflows = globalSum[3 * ex + 2];
+            entry.oldCapacity = particlesBuffer->getSendExchangeStack(ex).getMaxParticlesCount();
+            entry.newCapacity = entry.oldCapacity;
+            if (entry.statistics.numSteps != 0)
+                entry.newCapacity = policy.withConfiguredSize(particlesBuffer->getConfiguredExchangeSize(ex))
+                    .getCapacity(entry.oldCapacity, entry.statistics.highWaterMark);
+
+            /* send and receive buffer are allocated on the device */
+            if (entry.newCapacity > entry.oldCapacity)
+                growBytes += 2 * (entry.newCapacity - entry.oldCapacity) * BufferType::getBytesPerExchangeParticle();
+            report.push_back(entry);
+        }
+
+        if (growBytes != 0)
+        {
+            size_t freeMemory = 0;
+            Environment<>::get().MemoryInfo().getMemoryInfo(&freeMemory);
+            uint64_t localFree = freeMemory;
+            uint64_t globalFree = 0;
+            MPI_CHECK(MPI_Allreduce(&localFree, &globalFree, 1, MPI_UINT64_T, MPI_MIN, comm));
+
+            /* too large buffers are only slower, keep the old capacity */
+            if (globalFree < uint64_t(minFreeMemory) + uint64_t(growBytes))
+                for (size_t i = 0; i < report.size(); ++i)
+                    report[i].newCapacity = std::min(report[i].newCapacity, report[i].oldCapacity);
+        }
+
+        for (size_t i = 0; i < report.size(); ++i)
+            if (report[i].newCapacity != report[i].oldCapacity)
+                particlesBuffer->resizeExchange(report[i].exchange, report[i].newCapacity);
+
+        for (uint32_t ex = 0; ex < Exchanges; ++ex)
+            particlesBuffer->getSendExchangeStatistics(ex).reset();
+
+        return report;
+    }
+
 } //namespace PMacc
 
 #include "particles/AsyncCommunicationImpl.hpp"
@@ -0,0 +1,180 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "particles/memory/dataTypes/FramePoolStatistics.hpp"
+
+namespace PMacc
+{
+
+    /** device view of the spare frames of a species
+     *
+     * Released frames are kept in a fixed number of slots instead of
+     * returning them to mallocMC. A block first searches `numProbes` slots
+     * at a position derived from its index, frames released by a block are
+     * therefore likely recycled by the same block in the next kernel.
+     * If this fails, `numProbes` slots at a random position are searched.
+     * All slot accesses are atomic exchanges, no frame is owned twice.
+     *
+     * A default constructed box has no slots, all requests miss.
+     *
+     * @tparam T_Frame frame type
+     */
+    template<typename T_Frame>
+    class FramePoolBox
+    {
+    public:
+
+        HDINLINE FramePoolBox() :
+        slots(NULL), numSlots(0), numProbes(0), statistics(NULL)
+        {
+        }
+
+        /**
+         * @param slots device array with `numSlots` entries, 0 is an empty slot
+         * @param numSlots number of slots
+         * @param numProbes slots searched per region
+         * @param statistics device array with FramePoolStatistics::NUM_COUNTERS entries
+         */
+        HDINLINE FramePoolBox(uint64_cu* slots, const uint32_t numSlots, const uint32_t numProbes,
+                              uint64_cu* statistics) :
+        slots(slots), numSlots(numSlots), numProbes(numProbes), statistics(statistics)
+        {
+        }
+
+        /** take a spare frame
+         *
+         * @return frame or NULL if no spare frame was found
+         */
+        DINLINE T_Frame* pop()
+        {
+            count(FramePoolStatistics::ALLOCATIONS);
+            if (numSlots == 0)
+                return NULL;
+
+            T_Frame* frame = popInRegion(getBlockSlot());
+            if (frame != NULL)
+            {
+                count(FramePoolStatistics::LOCAL_HITS);
+                return frame;
+            }
+            frame = popInRegion(getRandomSlot());
+            if (frame != NULL)
+                count(FramePoolStatistics::GLOBAL_HITS);
+            return frame;
+        }
+
+        /** keep a frame for recycling
+         *
+         * @return false if all searched slots are used, the caller must free the frame
+         */
+        DINLINE bool push(T_Frame* frame)
+        {
+            count(FramePoolStatistics::RELEASES);
+            if (numSlots == 0)
+                return false;
+
+            if (pushInRegion(frame, getBlockSlot()))
+            {
+                count(FramePoolStatistics::LOCAL_STORES);
+                return true;
+            }
+            if (pushInRegion(frame, getRandomSlot()))
+            {
+                count(FramePoolStatistics::GLOBAL_STORES);
+                return true;
+            }
+            return false;
+        }
+
+        HDINLINE uint32_t getNumSlots() const
+        {
+            return numSlots;
+        }
+
+        HDINLINE uint64_cu* getSlots() const
+        {
+            return slots;
+        }
+
+    private:
+
+        DINLINE T_Frame* popInRegion(const uint32_t firstSlot)
+        {
+            for (uint32_t i = 0; i < numProbes; ++i)
+            {
+                uint64_cu* slot = slots + (firstSlot + i) % numSlots;
+                /* skip the atomic for empty slots */
+                if (*((volatile uint64_cu*) slot) != 0)
+                {
+                    const uint64_cu value = atomicExch(slot, uint64_cu(0));
+                    if (value != 0)
+                        return reinterpret_cast<T_Frame*> (value);
+                }
+            }
+            return NULL;
+        }
+
+        DINLINE bool pushInRegion(T_Frame* frame, const uint32_t firstSlot)
+        {
+            const uint64_cu value = reinterpret_cast<uint64_cu> (frame);
+            for (uint32_t i = 0; i < numProbes; ++i)
+            {
+                uint64_cu* slot = slots + (firstSlot + i) % numSlots;
+                if (*((volatile uint64_cu*) slot) == 0)
+                {
+                    if (atomicCAS(slot, uint64_cu(0), value) == 0)
+                        return true;
+                }
+            }
+            return false;
+        }
+
+        /** first slot of the region of the current block */
+        DINLINE uint32_t getBlockSlot() const
+        {
+            const uint32_t linearBlockIdx = blockIdx.x + gridDim.x * (blockIdx.y + gridDim.y * blockIdx.z);
+            return (linearBlockIdx * numProbes) % numSlots;
+        }
+
+        DINLINE uint32_t getRandomSlot() const
+        {
+            /* Knuth's multiplicative hash of the clock and the block */
+            const uint32_t seed = static_cast<uint32_t> (clock64()) + getBlockSlot();
+            return (seed * 2654435761u) % numSlots;
+        }
+
+        DINLINE void count(const FramePoolStatistics::Counter counter)
+        {
+            if (statistics != NULL)
+                atomicAdd(statistics + counter, uint64_cu(1));
+        }
+
+        PMACC_ALIGN(slots, uint64_cu*);
+        PMACC_ALIGN(numSlots, uint32_t);
+        PMACC_ALIGN(numProbes, uint32_t);
+        PMACC_ALIGN(statistics, uint64_cu*);
+    };
+
+} //namespace PMacc
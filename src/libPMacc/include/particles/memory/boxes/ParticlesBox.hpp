@@ -29,6 +29,7 @@
 #include "particles/memory/dataTypes/SuperCell.hpp"
 #include "memory/boxes/PitchedBox.hpp"
 #include "particles/memory/dataTypes/FramePointer.hpp"
+#include "particles/memory/boxes/FramePoolBox.hpp"
 
 namespace PMacc
 {
@@ -44,6 +45,7 @@ class ParticlesBox : protected DataBox<PitchedBox<SuperCell<T_Frame>, DIM> >
 {
 private:
     PMACC_ALIGN( hostMemoryOffset, int64_t );
+    PMACC_ALIGN( framePool, FramePoolBox<T_Frame> );
 public:
 
     typedef T_Frame FrameType;
@@ -76,27 +78,29 @@ public:
     }
 
     /**
-     * Returns an empty frame from data heap.
+     * @param superCells supercells on the device
+     * @param pool spare frames which are recycled before frames are allocated
+     */
+    HDINLINE ParticlesBox( const DataBox<PitchedBox<SuperCellType, DIM> > &superCells,
+                           const FramePoolBox<FrameType>& pool ) :
+    BaseType( superCells ), hostMemoryOffset( 0 ), framePool( pool )
+    {
+
+    }
+
+    /**
+     * Returns an empty frame, a recycled spare frame or a new frame from data heap.
      *
      * @return an empty frame
      */
     DINLINE FramePtr getEmptyFrame( )
     {
-        FrameType* tmp = NULL;
+        FrameType* tmp = framePool.pop( );
         const int maxTries = 13; //magic number is not performance critical
-        for ( int numTries = 0; numTries < maxTries; ++numTries )
+        for ( int numTries = 0; tmp == NULL && numTries < maxTries; ++numTries )
         {
             tmp = (FrameType*) mallocMC::malloc( sizeof (FrameType) );
-            if ( tmp != NULL )
-            {
-                /* disable all particles since we can not assume that newly allocated memory contains zeros */
-                for ( int i = 0; i < (int) math::CT::volume<typename FrameType::SuperCellSize>::type::value; ++i )
-                    ( *tmp )[i][multiMask_] = 0;
-                /* takes care that changed values are visible to all threads inside this block*/
-                __threadfence_block( );
-                break;
-            }
-            else
+            if ( tmp == NULL )
             {
                 printf( "%s: mallocMC out of memory (try %i of %i)\n",
                         (numTries + 1) == maxTries ? "ERROR" : "WARNING",
@@ -105,18 +109,28 @@ public:
             }
         }
 
+        if ( tmp != NULL )
+        {
+            /* disable all particles since we can not assume that new or recycled memory contains zeros */
+            for ( int i = 0; i < (int) math::CT::volume<typename FrameType::SuperCellSize>::type::value; ++i )
+                ( *tmp )[i][multiMask_] = 0;
+            /* takes care that changed values are visible to all threads inside this block*/
+            __threadfence_block( );
+        }
+
         return FramePtr( tmp );
     }
 
     /**
-     * Removes frame from heap data heap.
+     * Removes frame, it is kept as spare frame or returned to the data heap.
      *
      * @param frame frame to remove
      */
     template<typename T_InitMethod>
     DINLINE void removeFrame( FramePointer<FrameType, T_InitMethod>& frame )
     {
-        mallocMC::free( (void*) frame.ptr );
+        if ( !framePool.push( frame.ptr ) )
+            mallocMC::free( (void*) frame.ptr );
         frame.ptr = NULL;
     }
 
@@ -0,0 +1,98 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PMacc
+{
+
+    /** sizing policy for particle exchange buffers
+     *
+     * The capacity follows the high water mark of the particles sent per
+     * time step with some headroom. A buffer grows as soon as the headroom
+     * is used up and shrinks only if the traffic dropped far below the
+     * capacity, to avoid reallocations for small fluctuations.
+     * Particles which do not fit are sent in additional rounds, therefore
+     * the capacity is only a performance and not a correctness limit.
+     */
+    struct AdaptiveExchangeSize
+    {
+        /** smallest capacity in particles */
+        size_t minParticles;
+        /** largest capacity in particles */
+        size_t maxParticles;
+        /** capacity relative to the high water mark */
+        float_64 headroom;
+        /** shrink only if the new capacity is below this fraction of the current one */
+        float_64 shrinkThreshold;
+
+        AdaptiveExchangeSize(const size_t minParticles,
+                             const size_t maxParticles,
+                             const float_64 headroom = 1.5,
+                             const float_64 shrinkThreshold = 0.25) :
+            minParticles(std::max(size_t(1), minParticles)),
+            maxParticles(std::max(minParticles, maxParticles)),
+            headroom(headroom),
+            shrinkThreshold(shrinkThreshold)
+        {
+        }
+
+        /** policy for a buffer which was created with `configured` particles
+         *
+         * The configured size (e.g. from memory.param) is a lower bound and
+         * raises the largest size if required, a buffer never shrinks below
+         * the size the user asked for.
+         */
+        AdaptiveExchangeSize withConfiguredSize(const size_t configured) const
+        {
+            AdaptiveExchangeSize result(*this);
+            result.minParticles = std::max(minParticles, configured);
+            result.maxParticles = std::max(maxParticles, configured);
+            return result;
+        }
+
+        /** capacity for the next time steps
+         *
+         * @param capacity current capacity in particles
+         * @param highWaterMark maximum number of particles sent in one time step
+         * @return new capacity in particles
+         */
+        size_t getCapacity(const size_t capacity, const uint64_t highWaterMark) const
+        {
+            const float_64 wanted = std::ceil(float_64(highWaterMark) * headroom);
+            const size_t target = wanted >= float_64(maxParticles) ?
+                maxParticles : std::max(minParticles, static_cast<size_t>(wanted));
+
+            if (target > capacity || capacity > maxParticles)
+                return target;
+            if (float_64(target) < shrinkThreshold * float_64(capacity))
+                return target;
+            return capacity;
+        }
+    };
+
+} //namespace PMacc
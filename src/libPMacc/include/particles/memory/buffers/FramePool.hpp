@@ -0,0 +1,171 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "eventSystem/EventSystem.hpp"
+#include "memory/buffers/HostDeviceBuffer.hpp"
+#include "particles/memory/boxes/FramePoolBox.hpp"
+#include "particles/memory/dataTypes/FramePoolStatistics.hpp"
+
+#include <mallocMC/mallocMC.hpp>
+
+#include <algorithm>
+
+namespace PMacc
+{
+
+    /** return all spare frames to mallocMC */
+    struct KernelReleaseSpareFrames
+    {
+        template<typename T_FramePoolBox>
+        DINLINE void operator()(T_FramePoolBox pool) const
+        {
+            const uint32_t slotIdx = blockIdx.x * blockDim.x + threadIdx.x;
+            if (slotIdx >= pool.getNumSlots())
+                return;
+
+            const uint64_cu value = atomicExch(pool.getSlots() + slotIdx, uint64_cu(0));
+            if (value != 0)
+                mallocMC::free(reinterpret_cast<void*> (value));
+        }
+    };
+
+    /** spare frames of a species
+     *
+     * Frames released by ParticlesBox::removeFrame() are kept for the
+     * next ParticlesBox::getEmptyFrame() instead of returning them to
+     * mallocMC. This avoids the allocator for the frames which move
+     * between neighboring supercells in each time step.
+     * The spare frames are not available to other species, release()
+     * returns them to mallocMC.
+     *
+     * @tparam T_Frame frame type
+     */
+    template<typename T_Frame>
+    class FramePool
+    {
+    public:
+
+        typedef FramePoolBox<T_Frame> FramePoolBoxType;
+
+        /** create a pool without slots, all frames are returned to mallocMC */
+        FramePool() : slots(NULL), numProbes(0), isStatisticsEnabled(false)
+        {
+            statistics = new HostDeviceBuffer<uint64_cu, DIM1>(DataSpace<DIM1>(FramePoolStatistics::NUM_COUNTERS));
+            statistics->getDeviceBuffer().setValue(uint64_cu(0));
+        }
+
+        /** frames in the pool are not freed, the heap is destroyed after
+         *  all species */
+        virtual ~FramePool()
+        {
+            __delete(slots);
+            __delete(statistics);
+        }
+
+        /** change the number of slots, releases all spare frames
+         *
+         * @param numSlots maximal number of spare frames, 0 disables recycling
+         * @param numProbesPerRegion slots searched near the block and at a random position
+         */
+        void resize(const uint32_t numSlots, const uint32_t numProbesPerRegion)
+        {
+            release();
+            __delete(slots);
+            if (numSlots != 0)
+            {
+                slots = new HostDeviceBuffer<uint64_cu, DIM1>(DataSpace<DIM1>(numSlots));
+                slots->getDeviceBuffer().setValue(uint64_cu(0));
+            }
+            numProbes = std::min(numProbesPerRegion, numSlots);
+        }
+
+        /** return all spare frames to mallocMC */
+        void release()
+        {
+            if (slots == NULL)
+                return;
+
+            const uint32_t blockSize = 256;
+            const uint32_t numSlots = getNumSlots();
+            PMACC_KERNEL(KernelReleaseSpareFrames{})
+                ((numSlots + blockSize - 1) / blockSize, blockSize)
+                (getDeviceBox());
+        }
+
+        /** count the frame requests and releases on the device
+         *
+         * Each counted event is a global atomic, enable the counters only
+         * if the statistics are used.
+         */
+        void enableStatistics(const bool enable)
+        {
+            isStatisticsEnabled = enable;
+        }
+
+        FramePoolBoxType getDeviceBox()
+        {
+            uint64_cu* counters = NULL;
+            if (isStatisticsEnabled)
+                counters = statistics->getDeviceBuffer().getBasePointer();
+            if (slots == NULL)
+                return FramePoolBoxType(NULL, 0, 0, counters);
+            return FramePoolBoxType(slots->getDeviceBuffer().getBasePointer(),
+                                    getNumSlots(),
+                                    numProbes,
+                                    counters);
+        }
+
+        uint32_t getNumSlots() const
+        {
+            if (slots == NULL)
+                return 0;
+            return static_cast<uint32_t>(slots->getDeviceBuffer().getDataSpace().productOfComponents());
+        }
+
+        /** counters since the last resetStatistics(), zero if the
+         *  statistics are not enabled */
+        FramePoolStatistics getStatistics()
+        {
+            statistics->deviceToHost();
+            FramePoolStatistics result;
+            const uint64_cu* counters = statistics->getHostBuffer().getBasePointer();
+            for (uint32_t i = 0; i < FramePoolStatistics::NUM_COUNTERS; ++i)
+                result.counters[i] = counters[i];
+            return result;
+        }
+
+        void resetStatistics()
+        {
+            statistics->getDeviceBuffer().setValue(uint64_cu(0));
+        }
+
+    private:
+        HostDeviceBuffer<uint64_cu, DIM1>* slots;
+        HostDeviceBuffer<uint64_cu, DIM1>* statistics;
+        uint32_t numProbes;
+        bool isStatisticsEnabled;
+    };
+
+} //namespace PMacc
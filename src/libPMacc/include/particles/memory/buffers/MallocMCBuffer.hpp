@@ -26,11 +26,22 @@
 #include "dataManagement/ISimulationData.hpp"
 
 #include "mallocMC/mallocMC.hpp"
+#include "memory/buffers/GridBuffer.hpp"
 #include <string>
+#include <vector>
 
 namespace PMacc
 {
 
+    /** host mirror of the mallocMC heap
+     *
+     * The mirror is an anonymous memory mapping of the heap size. Host pages
+     * are only allocated by the operating system when they are written, so
+     * the resident host memory is the size of the downloaded data.
+     *
+     * Particle frames on the host are accessed via the device pointers
+     * shifted by getOffset().
+     */
     class MallocMCBuffer : public ISimulationData
     {
     public:
@@ -54,13 +65,47 @@ namespace PMacc
             return hostBufferOffset;
         }
 
+        /** download the whole heap
+         *
+         * called by the DataConnector, prefer synchronizeFrames() if only
+         * the frames of some species are accessed
+         */
         void synchronize();
 
+        /** download only the frames of a species
+         *
+         * The frames of all supercells in AREA are collected on the device,
+         * sorted and merged into contiguous ranges which are copied to the
+         * host mirror. Frames of other species are not updated.
+         *
+         * @tparam AREA area of the supercells (CORE, BORDER, GUARD)
+         * @param buffer particle species
+         * @param cellDescription mapping description of the species
+         */
+        template<uint32_t AREA, class T_Particles, class T_CellDescription>
+        void synchronizeFrames(T_Particles& buffer, T_CellDescription cellDescription);
+
     private:
 
+        /** create the host mirror if not done yet */
+        void allocateHostMirror();
+
+        /** copy a range of the heap to the host mirror
+         *
+         * @param begin offset of the first byte relative to the heap begin
+         * @param end offset behind the last byte
+         */
+        void copyRange(size_t begin, size_t end);
+
         char* hostPtr;
         int64_t hostBufferOffset;
         mallocMC::HeapInfo deviceHeapInfo;
+        /** true if the whole mirror is registered as page-locked memory */
+        bool isHostRegistered;
+
+        /** device pointers of the frames found by synchronizeFrames() */
+        GridBuffer<uint64_cu, DIM1>* frameList;
+        GridBuffer<uint64_cu, DIM1>* frameCounter;
 
     };
 
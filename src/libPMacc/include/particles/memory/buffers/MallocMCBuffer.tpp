@@ -26,11 +26,52 @@
 #include "pmacc_types.hpp"
 #include "Environment.hpp"
 #include "eventSystem/EventSystem.hpp"
+#include "mappings/kernel/AreaMapping.hpp"
+
+#include <sys/mman.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace PMacc
 {
 
-MallocMCBuffer::MallocMCBuffer( ) : hostPtr( NULL ),hostBufferOffset(0)
+/** collect the device pointers of all frames of a species
+ *
+ * one thread per supercell
+ */
+struct KernelCollectFrames
+{
+    template<class PBox, class Mapping>
+    DINLINE void operator()(
+        PBox pb,
+        uint64_cu* frameList,
+        uint64_cu* counter,
+        const uint64_cu maxFrames,
+        Mapping mapper
+    ) const
+    {
+        typedef typename PBox::FramePtr FramePtr;
+        const uint32_t Dim = Mapping::Dim;
+
+        const DataSpace<Dim> superCellIdx(mapper.getSuperCellIndex(DataSpace<Dim > (blockIdx)));
+
+        FramePtr frame = pb.getFirstFrame(superCellIdx);
+        while (frame.isValid())
+        {
+            const uint64_cu idx = atomicAdd(counter, (uint64_cu) 1);
+            if (idx < maxFrames)
+                frameList[idx] = (uint64_cu) frame.ptr;
+            frame = pb.getNextFrame(frame);
+        }
+    }
+};
+
+MallocMCBuffer::MallocMCBuffer( ) :
+    hostPtr( NULL ),
+    hostBufferOffset(0),
+    isHostRegistered(false),
+    frameList(NULL),
+    frameCounter(NULL)
 {
     /* currently mallocMC has only one heap */
     this->deviceHeapInfo=mallocMC::getHeapLocations()[0];
@@ -40,10 +81,40 @@ MallocMCBuffer::MallocMCBuffer( ) : hostPtr( NULL ),hostBufferOffset(0)
 MallocMCBuffer::~MallocMCBuffer( )
 {
     if ( hostPtr != NULL )
-        cudaHostUnregister(hostPtr);
+    {
+        if ( isHostRegistered )
+            cudaHostUnregister(hostPtr);
+        munmap(hostPtr, deviceHeapInfo.size);
+    }
+
+    __delete(frameList);
+    __delete(frameCounter);
+}
 
-    __deleteArray(hostPtr);
+void MallocMCBuffer::allocateHostMirror( )
+{
+    if ( hostPtr != NULL )
+        return;
 
+    /* anonymous mapping: physical pages are created on the first write,
+     * untouched parts of the heap do not consume host memory
+     */
+    void* mirror = mmap(NULL, deviceHeapInfo.size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if ( mirror == MAP_FAILED )
+        throw std::runtime_error("MallocMCBuffer: can not map host memory for the heap mirror");
+    hostPtr = static_cast<char*>(mirror);
+
+    this->hostBufferOffset = static_cast<int64_t>(reinterpret_cast<char*>(deviceHeapInfo.p) - hostPtr);
+}
+
+void MallocMCBuffer::copyRange( size_t begin, size_t end )
+{
+    end = std::min(end, deviceHeapInfo.size);
+    if ( begin >= end )
+        return;
+    CUDA_CHECK(cudaMemcpy(hostPtr + begin, static_cast<char*>(deviceHeapInfo.p) + begin,
+                          end - begin, cudaMemcpyDeviceToHost));
 }
 
 void MallocMCBuffer::synchronize( )
@@ -53,22 +124,82 @@ void MallocMCBuffer::synchronize( )
      *         system.
      *         WORKAROUND: use native cuda calls :-(
      */
-    if ( hostPtr == NULL )
+    allocateHostMirror();
+    if ( !isHostRegistered )
     {
-        /* use `new` and than `cudaHostRegister` is faster than `cudaMallocHost`
-         * but with the some result (create page-locked memory)
-         */
-        hostPtr = new char[deviceHeapInfo.size];
+        /* the whole heap is copied, page-locked memory is faster */
         CUDA_CHECK(cudaHostRegister(hostPtr, deviceHeapInfo.size, cudaHostRegisterDefault));
+        isHostRegistered = true;
+    }
+    /* add event system hints */
+    __startOperation(ITask::TASK_CUDA);
+    __startOperation(ITask::TASK_HOST);
+    copyRange(0, deviceHeapInfo.size);
+}
+
+template<uint32_t AREA, class T_Particles, class T_CellDescription>
+void MallocMCBuffer::synchronizeFrames( T_Particles& buffer, T_CellDescription cellDescription )
+{
+    typedef typename T_Particles::ParticlesBoxType::FrameType FrameType;
+
+    /* frames which are closer than this distance are copied with one call */
+    const size_t mergeDistance = 64 * 1024;
 
+    allocateHostMirror();
 
-        this->hostBufferOffset = static_cast<int64_t>(reinterpret_cast<char*>(deviceHeapInfo.p) - hostPtr);
+    const size_t maxFrames = deviceHeapInfo.size / sizeof (FrameType);
+    if ( frameList == NULL || size_t(frameList->getGridLayout().getDataSpace().x()) < maxFrames )
+    {
+        __delete(frameList);
+        frameList = new GridBuffer<uint64_cu, DIM1>(DataSpace<DIM1>(maxFrames));
     }
+    if ( frameCounter == NULL )
+        frameCounter = new GridBuffer<uint64_cu, DIM1>(DataSpace<DIM1>(1));
+
+    frameCounter->getDeviceBuffer().setValue(0);
+
+    AreaMapping<AREA, T_CellDescription> mapper(cellDescription);
+    PMACC_KERNEL(KernelCollectFrames{})
+        (mapper.getGridDim(), 1)
+        (buffer.getDeviceParticlesBox(),
+         frameList->getDeviceBuffer().getBasePointer(),
+         frameCounter->getDeviceBuffer().getBasePointer(),
+         (uint64_cu) maxFrames,
+         mapper);
+
+    frameCounter->deviceToHost();
+    const size_t numFrames = std::min(size_t(*(frameCounter->getHostBuffer().getBasePointer())), maxFrames);
+    if ( numFrames == 0 )
+        return;
+    frameList->deviceToHost();
+
+    uint64_cu* frames = frameList->getHostBuffer().getBasePointer();
+    std::sort(frames, frames + numFrames);
+
     /* add event system hints */
     __startOperation(ITask::TASK_CUDA);
     __startOperation(ITask::TASK_HOST);
-    CUDA_CHECK(cudaMemcpy(hostPtr, deviceHeapInfo.p, deviceHeapInfo.size, cudaMemcpyDeviceToHost));
 
+    const uint64_cu heapBegin = (uint64_cu) deviceHeapInfo.p;
+    size_t rangeBegin = frames[0] - heapBegin;
+    size_t rangeEnd = rangeBegin + sizeof (FrameType);
+    size_t copiedBytes = 0;
+    for ( size_t i = 1; i < numFrames; ++i )
+    {
+        const size_t frameBegin = frames[i] - heapBegin;
+        if ( frameBegin > rangeEnd + mergeDistance )
+        {
+            copyRange(rangeBegin, rangeEnd);
+            copiedBytes += rangeEnd - rangeBegin;
+            rangeBegin = frameBegin;
+        }
+        rangeEnd = std::max(rangeEnd, frameBegin + sizeof (FrameType));
+    }
+    copyRange(rangeBegin, rangeEnd);
+    copiedBytes += rangeEnd - rangeBegin;
+
+    log<ggLog::MEMORY >("MallocMCBuffer: download %1% frames, %2% of %3% MiB heap") %
+        numFrames % (copiedBytes / 1024 / 1024) % (deviceHeapInfo.size / 1024 / 1024);
 }
 
 } //namespace PMacc
@@ -28,6 +28,8 @@
 #include "dimensions/GridLayout.hpp"
 #include "memory/dataTypes/Mask.hpp"
 #include "particles/memory/buffers/StackExchangeBuffer.hpp"
+#include "particles/memory/dataTypes/ExchangeStatistics.hpp"
+#include "particles/memory/buffers/FramePool.hpp"
 #include "eventSystem/EventSystem.hpp"
 #include "particles/memory/dataTypes/SuperCell.hpp"
 
@@ -49,6 +51,8 @@
 #include "particles/ParticleDescription.hpp"
 #include "particles/memory/dataTypes/ListPointer.hpp"
 
+#include <algorithm>
+
 
 namespace PMacc
 {
@@ -184,6 +188,9 @@ public:
 
         superCells = new GridBuffer<SuperCellType, DIM > (superCellsCount);
 
+        framePool = new FramePool<FrameType>();
+
+        std::fill(configuredExchangeSize, configuredExchangeSize + 27, size_t(0));
     }
 
     void createParticleBuffer()
@@ -196,6 +203,7 @@ public:
      */
     virtual ~ParticlesBuffer()
     {
+        __delete(framePool);
         __delete(superCells);
         __delete(framesExchanges);
         __delete(exchangeMemoryIndexer);
@@ -206,6 +214,7 @@ public:
      */
     void reset()
     {
+        framePool->release();
 
         superCells->getDeviceBuffer().setValue(SuperCellType ());
         superCells->getHostBuffer().setValue(SuperCellType ());
@@ -225,6 +234,69 @@ public:
         framesExchanges->addExchangeBuffer(receive, DataSpace<DIM1 > (numFrameTypeBorders), communicationTag, true, false);
 
         exchangeMemoryIndexer->addExchangeBuffer(receive, DataSpace<DIM1 > (numFrameTypeBorders), communicationTag | (1u << (20 - 5)), true, false);
+
+        if (numFrameTypeBorders != 0)
+            exchangeMask = exchangeMask + receive.getMirroredMask();
+
+        const Mask send = receive.getMirroredMask();
+        for (uint32_t ex = 1; ex < 27; ++ex)
+            if (send.isSet(ex))
+                configuredExchangeSize[ex] = numFrameTypeBorders;
+    }
+
+    /**
+     * Changes the number of particles an exchange can hold.
+     *
+     * Resizes the send buffer in direction ex and the receive buffer of the
+     * mirrored direction. All ranks must use the same size for a direction
+     * (@see GridBuffer::resizeExchangeBuffer).
+     *
+     * @param ex send direction
+     * @param numParticles new capacity in particles
+     */
+    void resizeExchange(uint32_t ex, size_t numParticles)
+    {
+        framesExchanges->resizeExchangeBuffer(ex, DataSpace<DIM1 > (numParticles));
+        exchangeMemoryIndexer->resizeExchangeBuffer(ex, DataSpace<DIM1 > (numParticles));
+    }
+
+    /**
+     * Returns if an exchange buffer was added for sending in ex direction.
+     *
+     * In contrast to hasSendExchange() the result does not depend on the
+     * existence of a neighbor and is equal on all ranks.
+     *
+     * @param ex direction to query
+     * @return true if addExchange() created a buffer for ex
+     */
+    bool hasExchangeBuffer(uint32_t ex) const
+    {
+        return exchangeMask.isSet(ex);
+    }
+
+    /**
+     * Returns the capacity in particles which addExchange() created for the
+     * send direction ex, resizeExchange() does not change it.
+     */
+    size_t getConfiguredExchangeSize(uint32_t ex) const
+    {
+        return configuredExchangeSize[ex];
+    }
+
+    /**
+     * Returns the particle traffic statistics of the send direction ex.
+     */
+    ExchangeStatistics& getSendExchangeStatistics(uint32_t ex)
+    {
+        return sendExchangeStatistics[ex];
+    }
+
+    /**
+     * Returns the exchange memory in byte needed for one particle.
+     */
+    static size_t getBytesPerExchangeParticle()
+    {
+        return SizeOfOneBorderElement;
     }
 
     /**
@@ -236,7 +308,16 @@ public:
     {
 
         return ParticlesBox<FrameType, DIM > (
-                                                 superCells->getDeviceBuffer().getDataBox());
+                                                 superCells->getDeviceBuffer().getDataBox(),
+                                                 framePool->getDeviceBox());
+    }
+
+    /**
+     * Returns the spare frames which are recycled by the device ParticlesBox.
+     */
+    FramePool<FrameType>& getFramePool()
+    {
+        return *framePool;
     }
 
     /**
@@ -373,5 +454,13 @@ private:
     DataSpace<DIM> superCellSize;
     DataSpace<DIM> gridSize;
 
+    /* send directions with an exchange buffer */
+    Mask exchangeMask;
+    ExchangeStatistics sendExchangeStatistics[27];
+    /* capacity of each send direction requested by addExchange() */
+    size_t configuredExchangeSize[27];
+
+    FramePool<FrameType> *framePool;
+
 };
 }
@@ -0,0 +1,96 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+
+#include <algorithm>
+
+namespace PMacc
+{
+
+    /** particle traffic through one exchange direction
+     *
+     * Collected by the send task of the particle exchange, one entry per
+     * time step. The counters are reset whenever the exchange buffers are
+     * adapted.
+     */
+    struct ExchangeStatistics
+    {
+        /** maximum number of particles sent in one time step */
+        uint64_t highWaterMark;
+        /** number of particles sent */
+        uint64_t numParticles;
+        /** number of additional send rounds because the buffer was full */
+        uint64_t numExtraRounds;
+        /** number of time steps with more than one send round */
+        uint64_t numOverflows;
+        /** number of time steps */
+        uint64_t numSteps;
+
+        ExchangeStatistics()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            highWaterMark = 0;
+            numParticles = 0;
+            numExtraRounds = 0;
+            numOverflows = 0;
+            numSteps = 0;
+        }
+
+        /** add the traffic of one time step
+         *
+         * @param particles number of particles sent in all rounds
+         * @param rounds number of send rounds
+         */
+        void addStep(const uint64_t particles, const uint64_t rounds)
+        {
+            highWaterMark = std::max(highWaterMark, particles);
+            numParticles += particles;
+            if (rounds > 1)
+            {
+                numExtraRounds += rounds - 1;
+                ++numOverflows;
+            }
+            ++numSteps;
+        }
+    };
+
+    /** result of the adaption of one exchange buffer */
+    struct ExchangeBufferReport
+    {
+        /** send direction */
+        uint32_t exchange;
+        /** capacity in particles before the adaption */
+        size_t oldCapacity;
+        /** capacity in particles after the adaption */
+        size_t newCapacity;
+        /** statistics of all ranks since the last adaption */
+        ExchangeStatistics statistics;
+    };
+
+} //namespace PMacc
@@ -0,0 +1,86 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+
+#include <algorithm>
+
+namespace PMacc
+{
+
+    /** counters of the frame recycling of a species
+     *
+     * Counted on the device by FramePoolBox, copied to the host with
+     * FramePool::getStatistics().
+     */
+    struct FramePoolStatistics
+    {
+        /** position of the counters in the device array */
+        enum Counter
+        {
+            /** requested frames */
+            ALLOCATIONS = 0,
+            /** requests served by a spare frame near the slots of the block */
+            LOCAL_HITS,
+            /** requests served by a spare frame at a random position */
+            GLOBAL_HITS,
+            /** released frames */
+            RELEASES,
+            /** released frames stored near the slots of the block */
+            LOCAL_STORES,
+            /** released frames stored at a random position */
+            GLOBAL_STORES,
+            NUM_COUNTERS
+        };
+
+        uint64_t counters[NUM_COUNTERS];
+
+        FramePoolStatistics()
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            std::fill(counters, counters + NUM_COUNTERS, uint64_t(0));
+        }
+
+        /** fraction of the requested frames which were recycled */
+        double getHitRate() const
+        {
+            if (counters[ALLOCATIONS] == 0)
+                return 0.0;
+            return double(counters[LOCAL_HITS] + counters[GLOBAL_HITS]) / double(counters[ALLOCATIONS]);
+        }
+
+        /** fraction of the released frames which were kept for recycling */
+        double getStoreRate() const
+        {
+            if (counters[RELEASES] == 0)
+                return 0.0;
+            return double(counters[LOCAL_STORES] + counters[GLOBAL_STORES]) / double(counters[RELEASES]);
+        }
+    };
+
+} //namespace PMacc
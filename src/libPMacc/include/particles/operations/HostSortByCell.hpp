@@ -0,0 +1,71 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "particles/frame_types.hpp"
+
+#include <vector>
+#include <stdexcept>
+
+namespace PMacc
+{
+namespace particles
+{
+namespace operations
+{
+
+    /** serial reference of KernelSortParticlesByCell for one supercell
+     *
+     * Stable counting sort, particles of the same cell keep their order.
+     * The kernel does not define the order inside a cell, only the cell of
+     * each position can be compared.
+     *
+     * @param cellIdx local cell index of each particle
+     * @param numCells number of cells in a supercell
+     * @return order of the particles, element `i` is the index of the
+     *         particle which is moved to position `i`
+     */
+    inline std::vector<uint32_t> hostSortByCell(const std::vector<lcellId_t>& cellIdx,
+                                                const uint32_t numCells)
+    {
+        std::vector<uint32_t> cellOffset(numCells + 1, 0u);
+        for (size_t i = 0; i < cellIdx.size(); ++i)
+        {
+            if (cellIdx[i] >= numCells)
+                throw std::runtime_error("hostSortByCell: cell index out of range");
+            ++cellOffset[cellIdx[i] + 1];
+        }
+
+        for (uint32_t c = 0; c < numCells; ++c)
+            cellOffset[c + 1] += cellOffset[c];
+
+        std::vector<uint32_t> order(cellIdx.size());
+        for (size_t i = 0; i < cellIdx.size(); ++i)
+            order[cellOffset[cellIdx[i]]++] = static_cast<uint32_t>(i);
+        return order;
+    }
+
+} // namespace operations
+} // namespace particles
+} // namespace PMacc
@@ -103,6 +103,21 @@ namespace PMacc
             return false;
         }
 
+        bool isWaitingForEvent()
+        {
+            if (state == WaitForReceived)
+            {
+                /* park until the combined receive task notifies its observers */
+                ITask* task = Environment<>::get().Manager().getITaskIfNotFinished(tmpEvent.getTaskId());
+                if (task != NULL)
+                {
+                    task->addObserver(this);
+                    return true;
+                }
+            }
+            return false;
+        }
+
         virtual ~TaskParticlesReceive()
         {
             notify(this->myId, RECVFINISHED, NULL);
@@ -91,6 +91,21 @@ public:
         return false;
     }
 
+    bool isWaitingForEvent()
+    {
+        if (state == WaitForSend)
+        {
+            /* park until the combined send task notifies its observers */
+            ITask* task = Environment<>::get().Manager().getITaskIfNotFinished(tmpEvent.getTaskId());
+            if (task != NULL)
+            {
+                task->addObserver(this);
+                return true;
+            }
+        }
+        return false;
+    }
+
     virtual ~TaskParticlesSend()
     {
         notify(this->myId, RECVFINISHED, NULL);
@@ -45,7 +45,7 @@ namespace PMacc
         state(Constructor),
         maxSize(parBase.getParticlesBuffer().getSendExchangeStack(exchange).getMaxParticlesCount()),
         initDependency(__getTransactionEvent()),
-        lastSize(0),lastSendEvent(EventTask()),retryCounter(0){ }
+        lastSize(0),lastSendEvent(EventTask()),retryCounter(0),sentParticles(0){ }
 
         virtual void init()
         {
@@ -84,6 +84,7 @@ namespace PMacc
                     if (NULL == Environment<>::get().Manager().getITaskIfNotFinished(tmpEvent.getTaskId()))
                     {
                         PMACC_ASSERT(lastSize <= maxSize);
+                        sentParticles += lastSize;
                         //check for next bash round
                         if (lastSize == maxSize)
                         {
@@ -114,15 +115,9 @@ namespace PMacc
         virtual ~TaskSendParticlesExchange()
         {
             notify(this->myId, RECVFINISHED, NULL);
-            if(retryCounter != 0)
-            {
-                std::cerr << "Send/receive buffer for species " <<
-                    ParBase::FrameType::getName() <<
-                    " is to small (max: " << maxSize <<
-                    ", direction: " << exchange <<
-                    ", retries: " << retryCounter <<
-                    ")" << std::endl;
-            }
+            /* a full buffer is not an error, the statistics are used to
+             * adapt the buffer size (@see ParticlesBase::adaptExchangeBuffers) */
+            parBase.getParticlesBuffer().getSendExchangeStatistics(exchange).addStep(sentParticles, retryCounter + 1);
         }
 
         void event(id_t, EventType, IEventData*) { }
@@ -156,6 +151,7 @@ namespace PMacc
         size_t maxSize;
         size_t lastSize;
         size_t retryCounter;
+        size_t sentParticles;
     };
 
 } //namespace PMacc
@@ -92,6 +92,20 @@ namespace PMacc
          */
         virtual void checkpoint(uint32_t currentStep, const std::string checkpointDirectory) = 0;
 
+        /**
+         * Is the last checkpoint of this plugin completely written?
+         *
+         * Plugins which finish their checkpoint in the background override
+         * this, all others are done when checkpoint() returns.
+         *
+         * @param wait true: block until the checkpoint is written
+         * @return true if the checkpoint is written
+         */
+        virtual bool checkpointWritten(const bool /*wait*/)
+        {
+            return true;
+        }
+
         /**
          * Restart notification callback.
          *
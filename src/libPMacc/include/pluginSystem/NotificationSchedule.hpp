@@ -0,0 +1,173 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pluginSystem/IPlugin.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdlib>
+
+namespace PMacc
+{
+
+    /** set of simulation steps at which a plugin is notified
+     *
+     * The schedule is a comma separated list of ranges. A range is either a
+     * single period `N` (each N-th step, starting at step 0) or
+     * `start:end:period` with an inclusive end. `end` can be omitted for an
+     * open range and `period` defaults to 1, e.g.
+     *   `0:5000:100,5000:6000:10` notifies every 100 steps up to step 5000
+     *   and every 10 steps from 5000 to 6000.
+     * A period of `0` disables the range.
+     *
+     * In PIConGPU only `hdf5.period` and `adios.period` accept a schedule,
+     * the other plugins take a single period.
+     */
+    class NotificationSchedule
+    {
+    public:
+
+        /** returned by getNextStep() if no step follows */
+        static constexpr uint32_t noStep = std::numeric_limits<uint32_t>::max();
+
+        NotificationSchedule()
+        {
+        }
+
+        /** schedule with one range: each `period`-th step */
+        explicit NotificationSchedule(uint32_t period)
+        {
+            addRange(0, noStep, period);
+        }
+
+        /** parse a schedule
+         *
+         * throws PluginException if the description is malformed
+         */
+        explicit NotificationSchedule(const std::string& description)
+        {
+            std::vector<std::string> rangeList;
+            boost::split(rangeList, description, boost::is_any_of(","));
+            for (size_t i = 0; i < rangeList.size(); ++i)
+            {
+                std::string rangeDescription = boost::trim_copy(rangeList[i]);
+                if (rangeDescription.empty())
+                    continue;
+
+                std::vector<std::string> parts;
+                boost::split(parts, rangeDescription, boost::is_any_of(":"));
+                if (parts.size() == 1)
+                    addRange(0, noStep, parseNumber(parts[0], 0, description));
+                else if (parts.size() <= 3)
+                    addRange(parseNumber(parts[0], 0, description),
+                             parseNumber(parts[1], noStep, description),
+                             parts.size() == 3 ? parseNumber(parts[2], 1, description) : 1);
+                else
+                    throw PluginException(std::string("invalid notification period: ") + description);
+            }
+        }
+
+        /** true if no step is scheduled */
+        bool empty() const
+        {
+            return ranges.empty();
+        }
+
+        /** true if `step` is part of the schedule */
+        bool isDue(uint32_t step) const
+        {
+            return getNextStep(step) == step;
+        }
+
+        /** smallest scheduled step which is >= `step`
+         *
+         * @return scheduled step or noStep
+         */
+        uint32_t getNextStep(uint32_t step) const
+        {
+            uint32_t nextStep = noStep;
+            for (size_t i = 0; i < ranges.size(); ++i)
+            {
+                const Range& range = ranges[i];
+                if (step > range.end)
+                    continue;
+                uint32_t candidate = range.start;
+                if (step > range.start)
+                {
+                    /* round up to the next multiple of the period (64bit to avoid an overflow) */
+                    const uint64_t distance = step - range.start;
+                    const uint64_t next = range.start +
+                        (distance + range.period - 1) / range.period * uint64_t(range.period);
+                    if (next > range.end)
+                        continue;
+                    candidate = uint32_t(next);
+                }
+                nextStep = std::min(nextStep, candidate);
+            }
+            return nextStep;
+        }
+
+    private:
+
+        struct Range
+        {
+            uint32_t start;
+            /* inclusive */
+            uint32_t end;
+            uint32_t period;
+        };
+
+        void addRange(uint32_t start, uint32_t end, uint32_t period)
+        {
+            if (period == 0 || start > end)
+                return;
+            Range range;
+            range.start = start;
+            range.end = end;
+            range.period = period;
+            ranges.push_back(range);
+        }
+
+        static uint32_t parseNumber(const std::string& text, uint32_t defaultValue,
+                                    const std::string& description)
+        {
+            const std::string number = boost::trim_copy(text);
+            if (number.empty())
+                return defaultValue;
+
+            char* end = NULL;
+            const unsigned long long value = strtoull(number.c_str(), &end, 10);
+            if (*end != '\0' || number[0] == '-' || value >= noStep)
+                throw PluginException(std::string("invalid notification period: ") + description);
+            return uint32_t(value);
+        }
+
+        std::vector<Range> ranges;
+    };
+
+} //namespace PMacc
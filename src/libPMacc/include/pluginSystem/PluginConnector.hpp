@@ -25,9 +25,14 @@
 
 #include "pluginSystem/INotify.hpp"
 #include "pluginSystem/IPlugin.hpp"
+#include "pluginSystem/NotificationSchedule.hpp"
+#include "simulationControl/StepProfiler.hpp"
 
 #include <vector>
 #include <list>
+#include <queue>
+#include <algorithm>
+#include <functional>
 
 namespace PMacc
 {
@@ -39,7 +44,17 @@ namespace PMacc
     class PluginConnector
     {
     private:
-        typedef std::list<std::pair<INotify*, uint32_t> > NotificationList;
+        struct Notification
+        {
+            INotify* notifiedObj;
+            NotificationSchedule schedule;
+        };
+        typedef std::vector<Notification> NotificationList;
+
+        /** next due step and index of the notification in notificationList */
+        typedef std::pair<uint32_t, size_t> DueStep;
+        /** min-heap: the notification which is due next is on top */
+        typedef std::priority_queue<DueStep, std::vector<DueStep>, std::greater<DueStep> > DueQueue;
 
     public:
 
@@ -121,11 +136,38 @@ namespace PMacc
          * @param period notification period
          */
         void setNotificationPeriod(INotify* notifiedObj, uint32_t period)
+        {
+            setNotificationPeriod(notifiedObj, NotificationSchedule(period));
+        }
+
+        /** Set the notification steps
+         *
+         * @param notifiedObj the object to notify, e.g. an IPlugin instance
+         * @param period schedule description, see NotificationSchedule,
+         *               e.g. `100` or `0:5000:100,5000:6000:10`
+         */
+        void setNotificationPeriod(INotify* notifiedObj, const std::string& period)
+        {
+            setNotificationPeriod(notifiedObj, NotificationSchedule(period));
+        }
+
+        /** Set the notification steps
+         *
+         * @param notifiedObj the object to notify, e.g. an IPlugin instance
+         * @param schedule steps at which notifiedObj is notified
+         */
+        void setNotificationPeriod(INotify* notifiedObj, const NotificationSchedule& schedule)
         {
             if (notifiedObj != NULL)
             {
-                if (period > 0)
-                    notificationList.push_back( std::make_pair(notifiedObj, period) );
+                if (!schedule.empty())
+                {
+                    Notification notification;
+                    notification.notifiedObj = notifiedObj;
+                    notification.schedule = schedule;
+                    notificationList.push_back(notification);
+                    pushDueStep(notificationList.size() - 1, lastNotifyStep);
+                }
             }
             else
                 throw PluginException("Notifications for a NULL object are not allowed.");
@@ -134,21 +176,63 @@ namespace PMacc
         /**
          * Notifies plugins that data should be dumped.
          *
+         * Only plugins which are due in `currentStep` are touched. Plugins
+         * due in the same step are notified in the order of registration.
+         *
          * @param currentStep current simulation iteration step
          */
         void notifyPlugins(uint32_t currentStep)
         {
-            for (NotificationList::iterator iter = notificationList.begin();
-                    iter != notificationList.end(); ++iter)
+            /* the simulation went back in time (e.g. restart), recompute all due steps */
+            if (currentStep < lastNotifyStep)
+                rebuildDueQueue(currentStep);
+            lastNotifyStep = currentStep;
+
+            updateDueQueue(currentStep);
+
+            std::vector<size_t> dueNotifications;
+            while (!dueQueue.empty() && dueQueue.top().first == currentStep)
             {
-                INotify* notifiedObj = iter->first;
-                uint32_t period = iter->second;
-                if (currentStep % period == 0)
-                {
-                    notifiedObj->notify(currentStep);
-                    notifiedObj->setLastNotify(currentStep);
-                }
+                dueNotifications.push_back(dueQueue.top().second);
+                dueQueue.pop();
             }
+            std::sort(dueNotifications.begin(), dueNotifications.end());
+
+            /* phase names are only built if they are measured */
+            const bool isProfiling = simulationControl::ProfileScope::isProfiling();
+            for (size_t i = 0; i < dueNotifications.size(); ++i)
+            {
+                INotify* notifiedObj = notificationList[dueNotifications[i]].notifiedObj;
+                simulationControl::ProfileScope profileScope(
+                    isProfiling ? getNotifyPhaseName(notifiedObj) : std::string());
+                notifiedObj->notify(currentStep);
+                notifiedObj->setLastNotify(currentStep);
+            }
+
+            if (currentStep != NotificationSchedule::noStep)
+                for (size_t i = 0; i < dueNotifications.size(); ++i)
+                    pushDueStep(dueNotifications[i], currentStep + 1);
+        }
+
+        /** first step >= `step` at which any plugin is notified
+         *
+         * Can be used to prepare data ahead of an output step.
+         * Does not change the queue of due steps, notifications between the
+         * last notifyPlugins() call and `step` are still delivered.
+         *
+         * @return step or NotificationSchedule::noStep if no notification follows
+         */
+        uint32_t getNextNotifyStep(uint32_t step) const
+        {
+            /* each queued step is the next step of its notification after
+             * lastNotifyStep, if the earliest is not before `step` it is the answer */
+            if (step >= lastNotifyStep && (dueQueue.empty() || dueQueue.top().first >= step))
+                return dueQueue.empty() ? NotificationSchedule::noStep : dueQueue.top().first;
+
+            uint32_t nextStep = NotificationSchedule::noStep;
+            for (size_t i = 0; i < notificationList.size(); ++i)
+                nextStep = std::min(nextStep, notificationList[i].schedule.getNextStep(step));
+            return nextStep;
         }
 
         /**
@@ -159,14 +243,34 @@ namespace PMacc
          */
         void checkpointPlugins(uint32_t currentStep, const std::string checkpointDirectory)
         {
+            const bool isProfiling = simulationControl::ProfileScope::isProfiling();
             for (std::list<IPlugin*>::iterator iter = plugins.begin();
                     iter != plugins.end(); ++iter)
             {
+                simulationControl::ProfileScope profileScope(
+                    isProfiling ? std::string("checkpoint ") + (*iter)->pluginGetName() : std::string());
                 (*iter)->checkpoint(currentStep, checkpointDirectory);
                 (*iter)->setLastCheckpoint(currentStep);
             }
         }
 
+        /**
+         * Check if all plugins finished writing their last checkpoint.
+         *
+         * @param wait true: block until all checkpoints are written
+         * @return true if all checkpoints are written
+         */
+        bool checkpointsWritten(const bool wait)
+        {
+            bool written = true;
+            for (std::list<IPlugin*>::iterator iter = plugins.begin();
+                    iter != plugins.end(); ++iter)
+            {
+                written = (*iter)->checkpointWritten(wait) && written;
+            }
+            return written;
+        }
+
         /**
          * Notifies plugins that a restart is required.
          *
@@ -218,15 +322,53 @@ namespace PMacc
         friend class Environment<DIM2>;
         friend class Environment<DIM3>;
 
+        /** name of the profiled phase of a notification */
+        static std::string getNotifyPhaseName(INotify* notifiedObj)
+        {
+            IPlugin* plugin = dynamic_cast<IPlugin*>(notifiedObj);
+            if (plugin != NULL)
+                return std::string("notify ") + plugin->pluginGetName();
+            return std::string("notify");
+        }
+
         static PluginConnector& getInstance()
         {
             static PluginConnector instance;
             return instance;
         }
 
-        PluginConnector()
+        PluginConnector() : lastNotifyStep(0)
+        {
+
+        }
+
+        /** queue the notification `index` for its first step >= `step` */
+        void pushDueStep(size_t index, uint32_t step)
+        {
+            const uint32_t nextStep = notificationList[index].schedule.getNextStep(step);
+            if (nextStep != NotificationSchedule::noStep)
+                dueQueue.push(DueStep(nextStep, index));
+        }
+
+        /** move all queued steps which are before `step` to their next step >= `step`
+         *
+         * Only called by notifyPlugins(), skipped steps are never notified.
+         */
+        void updateDueQueue(uint32_t step)
         {
+            while (!dueQueue.empty() && dueQueue.top().first < step)
+            {
+                const size_t index = dueQueue.top().second;
+                dueQueue.pop();
+                pushDueStep(index, step);
+            }
+        }
 
+        void rebuildDueQueue(uint32_t step)
+        {
+            dueQueue = DueQueue();
+            for (size_t i = 0; i < notificationList.size(); ++i)
+                pushDueStep(i, step);
         }
 
         virtual ~PluginConnector()
@@ -236,5 +378,8 @@ namespace PMacc
 
         std::list<IPlugin*> plugins;
         NotificationList notificationList;
+        DueQueue dueQueue;
+        /** step of the last notifyPlugins() call */
+        uint32_t lastNotifyStep;
     };
 }
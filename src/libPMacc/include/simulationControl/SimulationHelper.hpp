@@ -29,6 +29,7 @@
 #include "mappings/simulation/GridController.hpp"
 #include "dimensions/DataSpace.hpp"
 #include "TimeInterval.hpp"
+#include "simulationControl/StepProfiler.hpp"
 #include "dataManagement/DataConnector.hpp"
 #include "Environment.hpp"
 #include "pluginSystem/IPlugin.hpp"
@@ -66,7 +67,12 @@ public:
     restartDirectory("checkpoints"),
     restartRequested(false),
     CHECKPOINT_MASTER_FILE("checkpoints.txt"),
-    author("")
+    author(""),
+    profilePhases(false),
+    checkpointPending(false),
+    checkpointBarrierPosted(false),
+    pendingCheckpointStep(0),
+    checkpointComm(MPI_COMM_NULL)
     {
         tSimulation.toggleStart();
         tInit.toggleStart();
@@ -74,6 +80,11 @@ public:
 
     virtual ~SimulationHelper()
     {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+        if (!finalized && checkpointComm != MPI_COMM_NULL)
+            MPI_Comm_free(&checkpointComm);
+
         tSimulation.toggleEnd();
         if (output)
         {
@@ -131,14 +142,20 @@ public:
      */
     virtual void dumpOneStep(uint32_t currentStep)
     {
+        Environment<>::get().StepProfiler().setCurrentStep(currentStep);
         Environment<DIM>::get().DataConnector().invalidate();
 
+        /* progress a checkpoint which is not yet confirmed by all ranks */
+        finishCheckpoint(false);
+
         /* trigger notification */
         Environment<DIM>::get().PluginConnector().notifyPlugins(currentStep);
 
         /* trigger checkpoint notification */
         if (checkpointPeriod && (currentStep % checkpointPeriod == 0))
         {
+            simulationControl::ProfileScope profileScope("checkpoint");
+
             /* first synchronize: if something failed, we can spare the time
              * for the checkpoint writing */
             CUDA_CHECK(cudaDeviceSynchronize());
@@ -147,10 +164,22 @@ public:
             /* avoid deadlock between not finished PMacc tasks and MPI_Barrier */
             __getTransactionEvent().waitForFinished();
 
-            GridController<DIM> &gc = Environment<DIM>::get().GridController();
-            /* can be spared for better scalings, but allows to spare the
-             * time for checkpointing if some ranks died */
-            MPI_CHECK(MPI_Barrier(gc.getCommunicator().getMPIComm()));
+            /* the checkpoint master file lists the checkpoints in order */
+            finishCheckpoint(true);
+
+            /* the confirmation of a checkpoint is posted at different steps
+             * on each rank, so it must not share a communicator with other
+             * collectives */
+            if (checkpointComm == MPI_COMM_NULL)
+                MPI_CHECK(MPI_Comm_dup(getGridController().getCommunicator().getMPIComm(),
+                                       &checkpointComm));
+
+            /* no barrier before writing: the collective I/O of the checkpoint
+             * plugins synchronizes the ranks anyway
+             *
+             * Plugins can copy the checkpoint to the host and write it in the
+             * background, they report the end of writing with
+             * IPlugin::checkpointWritten(). */
 
             /* create directory containing checkpoints  */
             if (numCheckpoints == 0)
@@ -169,15 +198,19 @@ public:
             /* avoid deadlock between not finished PMacc tasks and MPI_Barrier */
             __getTransactionEvent().waitForFinished();
 
-            /* \todo in an ideal world with MPI-3, this would be an
-             * MPI_Ibarrier call and this function would return a MPI_Request
-             * that could be checked */
-            MPI_CHECK(MPI_Barrier(gc.getCommunicator().getMPIComm()));
-
-            if (gc.getGlobalRank() == 0)
-            {
-                writeCheckpointStep(currentStep);
-            }
+            /* do not wait for the slowest rank: the checkpoint is added to the
+             * master file as soon as all ranks finished writing it, which is
+             * checked in the following steps (see finishCheckpoint) */
+            pendingCheckpointStep = currentStep;
+            checkpointPending = true;
+            checkpointBarrierPosted = false;
+#if (MPI_VERSION >= 3)
+            finishCheckpoint(false);
+#else
+            /* without a non-blocking barrier all ranks must confirm at the
+             * same point */
+            finishCheckpoint(true);
+#endif
             numCheckpoints++;
         }
     }
@@ -262,8 +295,12 @@ public:
              */
             while (currentStep < Environment<>::get().SimulationDescription().getRunSteps())
             {
+                Environment<>::get().StepProfiler().setCurrentStep(currentStep);
                 tRound.toggleStart();
-                runOneStep(currentStep);
+                {
+                    simulationControl::ProfileScope profileScope("step");
+                    runOneStep(currentStep);
+                }
                 tRound.toggleEnd();
                 roundAvg += tRound.getInterval();
 
@@ -279,6 +316,7 @@ public:
 
             // simulatation end
             Environment<>::get().Manager().waitForAllTasks();
+            finishCheckpoint(true);
 
             tSimCalculation.toggleEnd();
 
@@ -289,6 +327,9 @@ public:
                    (int) (tSimCalculation.getInterval() / 1000.) << " sec" << std::endl;
             }
 
+            if (profilePhases)
+                Environment<>::get().StepProfiler().report(getGridController().getCommunicator().getMPIComm());
+
         } // softRestarts loop
     }
 
@@ -309,7 +350,13 @@ public:
             ("checkpoint-directory", po::value<std::string>(&checkpointDirectory)->default_value(checkpointDirectory),
              "Directory for checkpoints")
             ("author", po::value<std::string>(&author)->default_value(std::string("")),
-             "The author that runs the simulation and is responsible for created output files");
+             "The author that runs the simulation and is responsible for created output files")
+            ("profile", po::value<bool>(&profilePhases)->zero_tokens(),
+             "Measure the time of each phase of a time step and each plugin, print min/mean/max over all ranks "
+             "at the end of the simulation. Note: synchronizes device and host at each phase boundary")
+            ("profile-trace-directory", po::value<std::string>(&profileTraceDirectory),
+             "Write all measured phases of each rank as Chrome trace (JSON) file to this directory "
+             "(requires --profile)");
     }
 
     std::string pluginGetName() const
@@ -325,10 +372,21 @@ public:
         calcProgress();
 
         output = (getGridController().getGlobalRank() == 0);
+
+        if (profilePhases)
+        {
+            if (!profileTraceDirectory.empty())
+                Environment<DIM>::get().Filesystem().createDirectoryWithPermissions(profileTraceDirectory);
+            Environment<>::get().StepProfiler().activate(
+                getGridController().getGlobalRank(),
+                profileTraceDirectory
+            );
+        }
     }
 
     void pluginUnload()
     {
+        Environment<>::get().StepProfiler().deactivate();
     }
 
     void restart(uint32_t, const std::string)
@@ -371,6 +429,12 @@ protected:
     /* author that runs the simulation */
     std::string author;
 
+    /* measure the time of each phase of a time step */
+    bool profilePhases;
+
+    /* directory for per-rank trace files of the measured phases */
+    std::string profileTraceDirectory;
+
 private:
 
     /**
@@ -391,6 +455,54 @@ private:
             showProgressAnyStep = 1;
     }
 
+    /**
+     * Complete the last checkpoint if all ranks finished writing it
+     *
+     * A rank confirms its part of the checkpoint as soon as all of its
+     * plugins finished writing. The checkpoint step is appended to the
+     * master checkpoint file only after all ranks confirmed.
+     *
+     * @param wait true: block until all ranks finished the checkpoint,
+     *             false: only test if all ranks finished the checkpoint
+     */
+    void finishCheckpoint(const bool wait)
+    {
+        if (!checkpointPending)
+            return;
+
+        if (!checkpointBarrierPosted)
+        {
+            if (!Environment<DIM>::get().PluginConnector().checkpointsWritten(wait))
+                return;
+#if (MPI_VERSION >= 3)
+            MPI_CHECK(MPI_Ibarrier(checkpointComm, &checkpointRequest));
+#else
+            MPI_CHECK(MPI_Barrier(checkpointComm));
+#endif
+            checkpointBarrierPosted = true;
+        }
+
+#if (MPI_VERSION >= 3)
+        int finished = 0;
+        if (wait)
+        {
+            MPI_CHECK(MPI_Wait(&checkpointRequest, MPI_STATUS_IGNORE));
+            finished = 1;
+        }
+        else
+            MPI_CHECK(MPI_Test(&checkpointRequest, &finished, MPI_STATUS_IGNORE));
+
+        if (!finished)
+            return;
+#endif
+
+        checkpointPending = false;
+        if (getGridController().getGlobalRank() == 0)
+        {
+            writeCheckpointStep(pendingCheckpointStep);
+        }
+    }
+
     /**
      * Append \p checkpointStep to the master checkpoint file
      *
@@ -458,6 +570,17 @@ private:
     TimeIntervall tSimulation;
     TimeIntervall tInit;
 
+    /* a checkpoint was written but is not yet confirmed by all ranks */
+    bool checkpointPending;
+    /* this rank confirmed the pending checkpoint (barrier is posted) */
+    bool checkpointBarrierPosted;
+    /* step of the not yet confirmed checkpoint */
+    uint32_t pendingCheckpointStep;
+    /* non-blocking barrier of the not yet confirmed checkpoint */
+    MPI_Request checkpointRequest;
+    /* communicator of the checkpoint confirmation */
+    MPI_Comm checkpointComm;
+
 };
 
 } // namespace PMacc
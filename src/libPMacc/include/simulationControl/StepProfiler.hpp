@@ -0,0 +1,339 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "communication/manager_common.h"
+#include "simulationControl/TimeInterval.hpp"
+
+#include <mpi.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+namespace PMacc
+{
+namespace simulationControl
+{
+
+/**
+ * Measures the wall time of named phases of the simulation (e.g. particle
+ * push, field solver, plugin notifications).
+ *
+ * The profiler is disabled by default. If activated, each phase boundary
+ * waits until all device work and PMacc tasks issued so far are finished,
+ * such that asynchronous work is accounted to the phase which issued it.
+ * This serializes communication and computation, therefore the total time
+ * per step increases.
+ *
+ * Each rank can stream all measured phases as Chrome trace (JSON) events
+ * to an own file (open with chrome://tracing). report() reduces the
+ * accumulated times over all ranks.
+ *
+ * Singleton class.
+ */
+class StepProfiler
+{
+public:
+
+    /** Enable time measurements
+     *
+     * @param rank global rank of this process
+     * @param traceDirectory directory for the per-rank trace files,
+     *                       empty string disables trace output
+     */
+    void activate( const uint32_t rank, const std::string& traceDirectory )
+    {
+        active = true;
+        myRank = rank;
+        if( !traceDirectory.empty() && !traceFile.is_open() )
+        {
+            std::stringstream fileName;
+            fileName << traceDirectory << "/trace_" << rank << ".json";
+            traceFile.open( fileName.str().c_str(), std::ofstream::out | std::ofstream::trunc );
+            if( !traceFile )
+                throw std::runtime_error( std::string( "Failed to open trace file " ) + fileName.str() );
+            traceFile << "{\"traceEvents\":[" << std::endl;
+            isFirstTraceEvent = true;
+        }
+    }
+
+    /** Disable time measurements and close the trace file */
+    void deactivate()
+    {
+        active = false;
+        if( traceFile.is_open() )
+        {
+            traceFile << std::endl << "]}" << std::endl;
+            traceFile.close();
+        }
+    }
+
+    /** Returns if time measurements are enabled */
+    bool isActive() const
+    {
+        return active;
+    }
+
+    /** Set the time step which is attached to all following measurements
+     *
+     * @param step current simulation step
+     */
+    void setCurrentStep( const uint32_t step )
+    {
+        currentStep = step;
+    }
+
+    /** Wait for all device work and PMacc tasks (see StepProfiler.tpp) */
+    void synchronize();
+
+    /** Account a measured interval to a phase
+     *
+     * @param phaseName name of the phase
+     * @param start begin of the interval in msec (see TimeIntervall::getTime)
+     * @param end end of the interval in msec
+     */
+    void addSample( const std::string& phaseName, const double start, const double end )
+    {
+        const uint32_t phaseId = getPhaseId( phaseName );
+        const double duration = end - start;
+        phaseTime[phaseId] += duration;
+
+        if( traceFile.is_open() )
+        {
+            if( !isFirstTraceEvent )
+                traceFile << "," << std::endl;
+            isFirstTraceEvent = false;
+            /* chrome trace format: complete event, time in usec */
+            traceFile << std::fixed << std::setprecision( 3 ) <<
+                "{\"name\":\"" << escapeJson( phaseName ) << "\",\"ph\":\"X\"" <<
+                ",\"ts\":" << start * 1000. <<
+                ",\"dur\":" << duration * 1000. <<
+                ",\"pid\":" << myRank << ",\"tid\":0" <<
+                ",\"args\":{\"step\":" << currentStep << "}}";
+        }
+    }
+
+    /** Reduce the accumulated phase times over all ranks and print
+     *  min/mean/max and the slowest rank per phase on rank 0
+     *
+     * This is a collective operation over comm. Phases are matched by name,
+     * the phases known by rank 0 are reported. Accumulated times are reset.
+     *
+     * @param comm communicator of all ranks which take part in the simulation
+     */
+    void report( MPI_Comm comm )
+    {
+        int rank;
+        int numRanks;
+        MPI_CHECK( MPI_Comm_rank( comm, &rank ) );
+        MPI_CHECK( MPI_Comm_size( comm, &numRanks ) );
+
+        /* agree on the phase order of rank 0 */
+        std::string names;
+        for( size_t i = 0; i < phaseNames.size(); ++i )
+            names += phaseNames[i] + '\n';
+        int namesLength = names.size();
+        MPI_CHECK( MPI_Bcast( &namesLength, 1, MPI_INT, 0, comm ) );
+        std::vector<char> namesBuffer( names.begin(), names.end() );
+        namesBuffer.resize( namesLength + 1, '\0' );
+        MPI_CHECK( MPI_Bcast( &namesBuffer[0], namesLength, MPI_CHAR, 0, comm ) );
+
+        std::vector<std::string> reportNames;
+        std::stringstream namesStream( std::string( &namesBuffer[0], namesLength ) );
+        std::string name;
+        while( std::getline( namesStream, name ) )
+            reportNames.push_back( name );
+
+        const int numPhases = reportNames.size();
+        if( numPhases == 0 )
+            return;
+
+        /* layout of MPI_DOUBLE_INT */
+        struct TimeRank
+        {
+            double value;
+            int rank;
+        };
+
+        std::vector<double> localTime( numPhases, 0.0 );
+        std::vector<TimeRank> localTimeRank( numPhases );
+        for( int i = 0; i < numPhases; ++i )
+        {
+            std::map<std::string, uint32_t>::const_iterator it = phaseIds.find( reportNames[i] );
+            if( it != phaseIds.end() )
+                localTime[i] = phaseTime[it->second];
+            localTimeRank[i].value = localTime[i];
+            localTimeRank[i].rank = rank;
+        }
+
+        std::vector<double> minTime( numPhases );
+        std::vector<double> sumTime( numPhases );
+        std::vector<TimeRank> maxTime( numPhases );
+        MPI_CHECK( MPI_Reduce( &localTime[0], &minTime[0], numPhases, MPI_DOUBLE, MPI_MIN, 0, comm ) );
+        MPI_CHECK( MPI_Reduce( &localTime[0], &sumTime[0], numPhases, MPI_DOUBLE, MPI_SUM, 0, comm ) );
+        MPI_CHECK( MPI_Reduce( &localTimeRank[0], &maxTime[0], numPhases, MPI_DOUBLE_INT, MPI_MAXLOC, 0, comm ) );
+
+        if( rank == 0 )
+        {
+            size_t nameWidth = 5;
+            for( int i = 0; i < numPhases; ++i )
+                nameWidth = std::max( nameWidth, reportNames[i].size() );
+
+            std::cout << "time per phase and rank [msec]:" << std::endl;
+            std::cout << std::setw( nameWidth ) << std::left << "phase" << std::right <<
+                std::setw( 14 ) << "min" <<
+                std::setw( 14 ) << "mean" <<
+                std::setw( 14 ) << "max" <<
+                std::setw( 14 ) << "slowest rank" << std::endl;
+            for( int i = 0; i < numPhases; ++i )
+            {
+                std::cout << std::setw( nameWidth ) << std::left << reportNames[i] << std::right <<
+                    std::fixed << std::setprecision( 1 ) <<
+                    std::setw( 14 ) << minTime[i] <<
+                    std::setw( 14 ) << sumTime[i] / double( numRanks ) <<
+                    std::setw( 14 ) << maxTime[i].value <<
+                    std::setw( 14 ) << maxTime[i].rank << std::endl;
+            }
+            std::cout.unsetf( std::ios_base::floatfield );
+        }
+
+        std::fill( phaseTime.begin(), phaseTime.end(), 0.0 );
+    }
+
+private:
+    friend class Environment<DIM1>;
+    friend class Environment<DIM2>;
+    friend class Environment<DIM3>;
+
+    static StepProfiler& getInstance()
+    {
+        static StepProfiler instance;
+        return instance;
+    }
+
+    StepProfiler() :
+    active( false ),
+    myRank( 0 ),
+    currentStep( 0 ),
+    isFirstTraceEvent( true )
+    {
+    }
+
+    ~StepProfiler()
+    {
+        deactivate();
+    }
+
+    /** escape a string for a JSON string literal */
+    static std::string escapeJson( const std::string& str )
+    {
+        std::stringstream escaped;
+        for( size_t i = 0; i < str.size(); ++i )
+        {
+            const char c = str[i];
+            if( c == '"' || c == '\\' )
+                escaped << '\\' << c;
+            else if( static_cast<unsigned char>( c ) < 0x20 )
+                escaped << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) <<
+                    static_cast<int>( c ) << std::dec << std::setfill( ' ' );
+            else
+                escaped << c;
+        }
+        return escaped.str();
+    }
+
+    uint32_t getPhaseId( const std::string& phaseName )
+    {
+        std::map<std::string, uint32_t>::const_iterator it = phaseIds.find( phaseName );
+        if( it != phaseIds.end() )
+            return it->second;
+
+        const uint32_t phaseId = phaseNames.size();
+        phaseIds[phaseName] = phaseId;
+        phaseNames.push_back( phaseName );
+        phaseTime.push_back( 0.0 );
+        return phaseId;
+    }
+
+    bool active;
+    uint32_t myRank;
+    uint32_t currentStep;
+
+    /** phase name to index in the vectors below */
+    std::map<std::string, uint32_t> phaseIds;
+    /** phase names in order of first usage */
+    std::vector<std::string> phaseNames;
+    /** accumulated time per phase in msec */
+    std::vector<double> phaseTime;
+
+    std::ofstream traceFile;
+    bool isFirstTraceEvent;
+};
+
+/** Measures the time between construction and destruction of the scope
+ *
+ * Nothing is done if the StepProfiler is not active.
+ *
+ * Usage:
+ * @code
+ * {
+ *     ProfileScope scope( "fieldSolver" );
+ *     myFieldSolver->update_afterCurrent( currentStep );
+ * }
+ * @endcode
+ */
+class ProfileScope
+{
+public:
+
+    /** start the measurement (see StepProfiler.tpp)
+     *
+     * @param phaseName name of the phase, all scopes with the same name are
+     *                  accumulated
+     */
+    ProfileScope( const std::string& phaseName );
+
+    /** stop the measurement (see StepProfiler.tpp) */
+    ~ProfileScope();
+
+    /** true if the StepProfiler is active (see StepProfiler.tpp)
+     *
+     * Allows to skip building phase names if nothing is measured.
+     */
+    static bool isProfiling();
+
+private:
+    std::string name;
+    double start;
+    bool active;
+};
+
+} // namespace simulationControl
+} // namespace PMacc
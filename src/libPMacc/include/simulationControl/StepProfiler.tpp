@@ -0,0 +1,69 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "simulationControl/StepProfiler.hpp"
+#include "simulationControl/TimeInterval.hpp"
+#include "Environment.hpp"
+
+namespace PMacc
+{
+namespace simulationControl
+{
+
+inline void StepProfiler::synchronize()
+{
+    CUDA_CHECK( cudaDeviceSynchronize() );
+    __getTransactionEvent().waitForFinished();
+}
+
+inline bool ProfileScope::isProfiling()
+{
+    return Environment<>::get().StepProfiler().isActive();
+}
+
+inline ProfileScope::ProfileScope( const std::string& phaseName ) :
+    start( 0.0 ),
+    active( isProfiling() )
+{
+    if( active )
+    {
+        name = phaseName;
+        /* do not account work of previous phases */
+        Environment<>::get().StepProfiler().synchronize();
+        start = TimeIntervall::getTime();
+    }
+}
+
+inline ProfileScope::~ProfileScope()
+{
+    if( active )
+    {
+        StepProfiler& profiler = Environment<>::get().StepProfiler();
+        profiler.synchronize();
+        profiler.addSample( name, start, TimeIntervall::getTime() );
+    }
+}
+
+} // namespace simulationControl
+} // namespace PMacc
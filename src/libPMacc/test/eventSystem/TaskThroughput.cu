@@ -0,0 +1,220 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Micro benchmark of the task scheduler in PMacc::Manager
+ *
+ * Synthetic host tasks are submitted to the manager, no device work is
+ * issued: pairs of a polling task (behaves like a task waiting for a cuda
+ * event) and a waiting task (behaves like TaskSend/TaskReceive which only
+ * make progress after a notification) are kept in flight.
+ * The benchmark is built with nvcc because the PMacc environment headers
+ * contain kernel launches.
+ */
+
+#include "Environment.hpp"
+#include "eventSystem/EventSystem.hpp"
+#include "simulationControl/TimeInterval.hpp"
+
+#include <stdint.h>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace
+{
+    using PMacc::ITask;
+    using PMacc::IEventData;
+    using PMacc::EventType;
+    using PMacc::Manager;
+    using PMacc::Environment;
+    using PMacc::TimeIntervall;
+
+    /** task is finished after it was executed numPolls times */
+    class PollTask : public ITask
+    {
+    public:
+
+        PollTask(uint32_t numPolls) :
+        ITask(),
+        numPolls(numPolls)
+        {
+            this->setTaskType(ITask::TASK_HOST);
+        }
+
+        virtual ~PollTask()
+        {
+            notify(this->myId, PMacc::FINISHED, NULL);
+        }
+
+        void init()
+        {
+        }
+
+        bool executeIntern()
+        {
+            if (numPolls == 0)
+                return true;
+            return --numPolls == 0;
+        }
+
+        void event(PMacc::id_t, EventType, IEventData*)
+        {
+        }
+
+        std::string toString()
+        {
+            return "PollTask";
+        }
+
+    private:
+        uint32_t numPolls;
+    };
+
+    /** task is finished after it was notified by an observed task */
+    class WaitTask : public ITask
+    {
+    public:
+
+        WaitTask(ITask* observedTask) :
+        ITask(),
+        notified(false)
+        {
+            this->setTaskType(ITask::TASK_HOST);
+            observedTask->addObserver(this);
+        }
+
+        virtual ~WaitTask()
+        {
+            notify(this->myId, PMacc::FINISHED, NULL);
+        }
+
+        void init()
+        {
+        }
+
+        bool executeIntern()
+        {
+            return notified;
+        }
+
+        bool isWaitingForEvent()
+        {
+            return !notified;
+        }
+
+        void event(PMacc::id_t, EventType, IEventData*)
+        {
+            notified = true;
+        }
+
+        std::string toString()
+        {
+            return "WaitTask";
+        }
+
+    private:
+        bool notified;
+    };
+
+    /** submit numTasks pairs of tasks and wait until all are finished
+     *
+     * @return time in msec
+     */
+    double runScheduler(uint32_t numTasks, uint32_t numPolls)
+    {
+        Manager& manager = Environment<>::get().Manager();
+
+        TimeIntervall timer;
+        timer.toggleStart();
+        for (uint32_t i = 0; i < numTasks; ++i)
+        {
+            PollTask* pollTask = new PollTask(numPolls);
+            WaitTask* waitTask = new WaitTask(pollTask);
+            manager.addTask(pollTask);
+            manager.addTask(waitTask);
+        }
+        manager.waitForAllTasks();
+        timer.toggleEnd();
+        return timer.getInterval();
+    }
+
+    /** query numLookups times the state of in flight tasks
+     *
+     * @return time in msec
+     */
+    double runLookup(uint32_t numTasks, uint32_t numLookups)
+    {
+        Manager& manager = Environment<>::get().Manager();
+
+        std::vector<PMacc::id_t> ids;
+        ids.reserve(numTasks);
+        for (uint32_t i = 0; i < numTasks; ++i)
+        {
+            /* never finished before the lookups are done */
+            PollTask* task = new PollTask(2);
+            ids.push_back(task->getId());
+            manager.addTask(task);
+        }
+
+        uint32_t numFound = 0;
+        TimeIntervall timer;
+        timer.toggleStart();
+        for (uint32_t i = 0; i < numLookups; ++i)
+        {
+            if (manager.getITaskIfNotFinished(ids[i % numTasks]) != NULL)
+                ++numFound;
+        }
+        timer.toggleEnd();
+        /* checked in release builds too, a lost task would falsify the timing */
+        if (numFound != numLookups)
+            throw std::runtime_error("TaskThroughput: task in flight was not found");
+
+        manager.waitForAllTasks();
+        return timer.getInterval();
+    }
+}
+
+int main(int, char**)
+{
+    const uint32_t numPolls = 8;
+    const uint32_t numLookups = 10 * 1000 * 1000;
+
+    std::cout << std::setw(12) << "tasks"
+              << std::setw(20) << "tasks/sec"
+              << std::setw(20) << "lookups/sec" << std::endl;
+
+    for (uint32_t numTasks = 16; numTasks <= 16 * 1024; numTasks *= 4)
+    {
+        const double schedulerTime = runScheduler(numTasks, numPolls);
+        const double lookupTime = runLookup(numTasks, numLookups);
+
+        /* two tasks are submitted per pair */
+        std::cout << std::setw(12) << 2 * numTasks
+                  << std::setw(20) << 2. * numTasks / schedulerTime * 1000.
+                  << std::setw(20) << numLookups / lookupTime * 1000.
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PMaccFixture.hpp"
+
+// STL
+#include <vector>
+#include <cmath>
+
+// BOOST
+#include <boost/test/unit_test.hpp>
+
+// PMacc
+#include <Environment.hpp>
+#include <memory/buffers/GridBuffer.hpp>
+#include <algorithms/histogram/Histogram.hpp>
+#include <algorithms/histogram/HostHistogram.hpp>
+#include "pmacc_types.hpp"
+
+
+/** add value[i] to bin[i], the last block is only partially used */
+struct KernelFillHistogram
+{
+    template<typename T_DeviceHistogram>
+    DINLINE void operator()(T_DeviceHistogram histogram,
+                            const uint32_t* bins,
+                            const float* values,
+                            const uint32_t numValues) const
+    {
+        const uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+        const bool isValid = i < numValues;
+
+        auto blockHistogram = histogram.getBlockHistogram();
+        blockHistogram.add(isValid, isValid ? bins[i] : 0u, isValid ? values[i] : 0.0f);
+        blockHistogram.flush();
+    }
+};
+
+/** fill the GPU histogram and the host reference with the same values
+ *
+ * @param binRange values go to the bins [0, binRange), small ranges
+ *                 exercise the warp aggregation
+ * @return maximal absolute difference to the reference
+ */
+template<typename T_Accumulation>
+double compareWithReference(const uint32_t numBins,
+                            const uint32_t binRange,
+                            const T_Accumulation& accumulation = T_Accumulation())
+{
+    using namespace ::PMacc;
+
+    const uint32_t numValues = 100000 + 17;
+    GridBuffer<uint32_t, DIM1> bins(DataSpace<DIM1>(numValues));
+    GridBuffer<float, DIM1> values(DataSpace<DIM1>(numValues));
+    algorithms::histogram::HostHistogram reference(numBins);
+
+    /* deterministic pseudo random numbers, positive and negative values */
+    uint32_t state = 42u;
+    for (uint32_t i = 0; i < numValues; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        const uint32_t bin = (state >> 8) % binRange;
+        const float value = float(int32_t(state % 2001u) - 1000) / 64.0f;
+        bins.getHostBuffer().getBasePointer()[i] = bin;
+        values.getHostBuffer().getBasePointer()[i] = value;
+        reference.add(bin, value);
+    }
+    bins.hostToDevice();
+    values.hostToDevice();
+
+    algorithms::histogram::Histogram<T_Accumulation> histogram(numBins, accumulation);
+    const uint32_t blockSize = 256;
+    PMACC_KERNEL(KernelFillHistogram{})
+        ((numValues + blockSize - 1) / blockSize, blockSize, histogram.getSharedMemBytes())
+        (histogram.getDeviceHistogram(),
+         bins.getDeviceBuffer().getBasePointer(),
+         values.getDeviceBuffer().getBasePointer(),
+         numValues);
+    const float_64* result = histogram.merge();
+
+    const std::vector<float_64> expected = reference.getResult();
+    double maxDifference = 0.0;
+    for (uint32_t i = 0; i < numBins; ++i)
+        maxDifference = std::max(maxDifference, std::abs(result[i] - expected[i]));
+    return maxDifference;
+}
+
+typedef PMaccFixture<TEST_DIM> MyPMaccFixture;
+BOOST_GLOBAL_FIXTURE(MyPMaccFixture);
+
+BOOST_AUTO_TEST_SUITE( histogram )
+
+    /* all values are multiples of 1/64, the fixed point sum is exact */
+    BOOST_AUTO_TEST_CASE( fixedPointExact )
+    {
+        typedef ::PMacc::algorithms::histogram::accumulation::FixedPoint FixedPoint;
+        const FixedPoint accumulation(1.0 / 64.0);
+
+        /* shared memory sub-histograms */
+        BOOST_CHECK_EQUAL( compareWithReference<FixedPoint>(100, 100, accumulation), 0.0 );
+        /* warp aggregation, few different bins */
+        BOOST_CHECK_EQUAL( compareWithReference<FixedPoint>(100, 3, accumulation), 0.0 );
+        /* global memory sub-histograms */
+        BOOST_CHECK_EQUAL( compareWithReference<FixedPoint>(1000000, 1000000, accumulation), 0.0 );
+    }
+
+    BOOST_AUTO_TEST_CASE( floating )
+    {
+        typedef ::PMacc::algorithms::histogram::accumulation::Floating<float> Floating;
+
+        /* bins hold sums of up to ~1e5 values of magnitude ~10 */
+        BOOST_CHECK_SMALL( compareWithReference<Floating>(100, 100), 1.0e-1 );
+        BOOST_CHECK_SMALL( compareWithReference<Floating>(100, 3), 1.0 );
+        BOOST_CHECK_SMALL( compareWithReference<Floating>(1000000, 1000000), 1.0e-3 );
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// BOOST
+#include <boost/test/unit_test.hpp>
+
+// MPI
+#include <mpi.h>
+
+// PMacc
+#include <mpi/CommunicatorCache.hpp>
+
+// STL
+#include <stdexcept>
+
+/* all tests are collective, they must be called on all ranks */
+
+BOOST_AUTO_TEST_SUITE( communicatorCache )
+
+BOOST_AUTO_TEST_CASE( reuseCommunicator )
+{
+    ::PMacc::mpi::CommunicatorCache& cache = ::PMacc::mpi::CommunicatorCache::getInstance();
+
+    int worldRank = 0;
+    int worldSize = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+
+    /* even ranks are active */
+    const bool isActive = worldRank % 2 == 0;
+    MPI_Comm first = cache.getCommunicator(isActive);
+    MPI_Comm second = cache.getCommunicator(isActive);
+
+    BOOST_CHECK(first == second);
+    if (isActive)
+    {
+        int size = 0;
+        int rank = 0;
+        MPI_Comm_size(first, &size);
+        MPI_Comm_rank(first, &rank);
+        BOOST_CHECK_EQUAL(size, (worldSize + 1) / 2);
+        BOOST_CHECK_EQUAL(rank, worldRank / 2);
+    }
+    else
+        BOOST_CHECK(first == MPI_COMM_NULL);
+
+    cache.release(first);
+    cache.release(second);
+    cache.clear();
+}
+
+BOOST_AUTO_TEST_CASE( allRanks )
+{
+    ::PMacc::mpi::CommunicatorCache& cache = ::PMacc::mpi::CommunicatorCache::getInstance();
+
+    MPI_Comm all = cache.getCommunicatorAllRanks();
+    /* the same rank set requested collectively maps to the same communicator */
+    MPI_Comm requested = cache.getCommunicator(true);
+    BOOST_CHECK(all == requested);
+    BOOST_CHECK_EQUAL(cache.size(), 1u);
+
+    cache.release(all);
+    cache.release(requested);
+    cache.clear();
+}
+
+BOOST_AUTO_TEST_CASE( clearOnlyUnused )
+{
+    ::PMacc::mpi::CommunicatorCache& cache = ::PMacc::mpi::CommunicatorCache::getInstance();
+
+    MPI_Comm all = cache.getCommunicatorAllRanks();
+    /* a communicator in use is never freed */
+    BOOST_CHECK_THROW(cache.clear(), std::runtime_error);
+    BOOST_CHECK_EQUAL(cache.size(), 1u);
+
+    int size = 0;
+    BOOST_CHECK_EQUAL(MPI_Comm_size(all, &size), MPI_SUCCESS);
+
+    cache.release(all);
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE( nonBlockingInOrder )
+{
+    ::PMacc::mpi::CommunicatorCache& cache = ::PMacc::mpi::CommunicatorCache::getInstance();
+
+    int worldRank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+
+    ::PMacc::mpi::CommunicatorCache::Request first = cache.requestCommunicator(true);
+    ::PMacc::mpi::CommunicatorCache::Request second = cache.requestCommunicator(worldRank == 0);
+
+    /* waiting for the second request finishes the first one */
+    MPI_Comm secondComm = cache.wait(second);
+    BOOST_CHECK(cache.test(first));
+    MPI_Comm firstComm = cache.wait(first);
+
+    BOOST_CHECK(firstComm != MPI_COMM_NULL);
+    BOOST_CHECK_EQUAL(secondComm != MPI_COMM_NULL, worldRank == 0);
+
+    cache.release(firstComm);
+    cache.release(secondComm);
+    cache.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Host-only benchmark of the memory locality gained by
+ * ParticlesBase::sortParticlesByCell()
+ *
+ * Particles of a supercell are visited in memory order by warps of 32
+ * threads, as in the pusher and the current deposition. Each particle
+ * touches a 2x2x2 stencil of cells. For the unsorted order (cells drawn at
+ * random, as after many pushes) and for the order of hostSortByCell() it
+ * reports per warp access of one stencil point:
+ *  - 128 byte segments touched (global memory transactions)
+ *  - shared memory bank replays reading the field cache (pusher)
+ *  - largest number of threads updating the same address, atomics to
+ *    the same address are serialized (deposition)
+ * This models the access pattern only, it does not time the pusher or the
+ * current deposition kernels.
+ */
+
+#include "particles/operations/HostSortByCell.hpp"
+
+#include <stdint.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+
+namespace
+{
+    using PMacc::lcellId_t;
+
+    /* supercell of 8x8x4 cells */
+    const uint32_t superCellX = 8;
+    const uint32_t superCellY = 8;
+    const uint32_t superCellZ = 4;
+    const uint32_t numCells = superCellX * superCellY * superCellZ;
+
+    const uint32_t warpSize = 32;
+    const uint32_t numBanks = 32;
+    const uint32_t segmentBytes = 128;
+
+    /** deterministic pseudo random numbers */
+    struct Lcg
+    {
+        uint32_t state;
+
+        Lcg() : state(42u)
+        {
+        }
+
+        uint32_t operator()()
+        {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        }
+    };
+
+    /** cell index in a box of cells with size `size` */
+    uint32_t cellInBox(const uint32_t cell,
+                       const uint32_t offsetX, const uint32_t offsetY, const uint32_t offsetZ,
+                       const uint32_t sizeX, const uint32_t sizeY)
+    {
+        const uint32_t x = cell % superCellX + offsetX;
+        const uint32_t y = cell / superCellX % superCellY + offsetY;
+        const uint32_t z = cell / (superCellX * superCellY) + offsetZ;
+        return x + sizeX * (y + sizeY * z);
+    }
+
+    struct Locality
+    {
+        double segments;
+        double bankReplays;
+        double atomicConflicts;
+    };
+
+    /** access statistics of one supercell, field cache with one guard cell */
+    Locality measure(const std::vector<lcellId_t>& cellIdx)
+    {
+        Locality result = {0.0, 0.0, 0.0};
+        const uint32_t numParticles = cellIdx.size();
+        uint32_t numWarpAccesses = 0;
+
+        for (uint32_t warp = 0; warp < numParticles; warp += warpSize)
+        {
+            const uint32_t warpEnd = std::min(warp + warpSize, numParticles);
+            for (uint32_t s = 0; s < 8; ++s)
+            {
+                std::set<uint32_t> segments;
+                std::vector<std::set<uint32_t> > banks(numBanks);
+                std::map<uint32_t, uint32_t> hits;
+                uint32_t maxHits = 0;
+
+                for (uint32_t p = warp; p < warpEnd; ++p)
+                {
+                    /* float index in the cache of (superCell + 2) cells per direction */
+                    const uint32_t addr = cellInBox(cellIdx[p], s & 1, (s >> 1) & 1, s >> 2,
+                                                    superCellX + 2, superCellY + 2);
+                    segments.insert(addr * sizeof(float) / segmentBytes);
+                    banks[addr % numBanks].insert(addr);
+                    maxHits = std::max(maxHits, ++hits[addr]);
+                }
+
+                size_t maxWordsPerBank = 0;
+                for (uint32_t b = 0; b < numBanks; ++b)
+                    maxWordsPerBank = std::max(maxWordsPerBank, banks[b].size());
+
+                result.segments += segments.size();
+                result.bankReplays += maxWordsPerBank - 1;
+                result.atomicConflicts += maxHits;
+                ++numWarpAccesses;
+            }
+        }
+
+        result.segments /= numWarpAccesses;
+        result.bankReplays /= numWarpAccesses;
+        result.atomicConflicts /= numWarpAccesses;
+        return result;
+    }
+}
+
+int main(int, char**)
+{
+    /* the locality only depends on the order inside a supercell */
+    const uint32_t numSuperCells = 64;
+
+    std::cout << std::setw(6) << "ppc"
+              << std::setw(8) << "order"
+              << std::setw(12) << "segments"
+              << std::setw(14) << "bankReplays"
+              << std::setw(18) << "atomicConflicts" << std::endl;
+
+    for (uint32_t ppc = 1; ppc <= 16; ppc *= 2)
+    {
+        Lcg random;
+        std::vector<std::vector<lcellId_t> > unsorted(numSuperCells);
+        std::vector<std::vector<lcellId_t> > sorted(numSuperCells);
+        for (uint32_t sc = 0; sc < numSuperCells; ++sc)
+        {
+            unsorted[sc].resize(ppc * numCells);
+            for (size_t p = 0; p < unsorted[sc].size(); ++p)
+                unsorted[sc][p] = lcellId_t(random() % numCells);
+
+            const std::vector<uint32_t> order =
+                PMacc::particles::operations::hostSortByCell(unsorted[sc], numCells);
+            sorted[sc].resize(order.size());
+            for (size_t p = 0; p < order.size(); ++p)
+                sorted[sc][p] = unsorted[sc][order[p]];
+        }
+
+        const std::vector<std::vector<lcellId_t> >* orders[] = {&unsorted, &sorted};
+        const char* names[] = {"random", "sorted"};
+        for (uint32_t o = 0; o < 2; ++o)
+        {
+            Locality locality = {0.0, 0.0, 0.0};
+            for (uint32_t sc = 0; sc < numSuperCells; ++sc)
+            {
+                const Locality l = measure((*orders[o])[sc]);
+                locality.segments += l.segments / numSuperCells;
+                locality.bankReplays += l.bankReplays / numSuperCells;
+                locality.atomicConflicts += l.atomicConflicts / numSuperCells;
+            }
+
+            std::cout << std::setw(6) << ppc
+                      << std::setw(8) << names[o]
+                      << std::setw(12) << std::setprecision(3) << locality.segments
+                      << std::setw(14) << std::setprecision(3) << locality.bankReplays
+                      << std::setw(18) << std::setprecision(3) << locality.atomicConflicts << std::endl;
+        }
+    }
+
+    return 0;
+}
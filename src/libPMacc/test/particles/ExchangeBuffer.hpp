@@ -0,0 +1,78 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pmacc_types.hpp>
+#include <particles/memory/buffers/AdaptiveExchangeSize.hpp>
+#include <particles/memory/dataTypes/ExchangeStatistics.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <stdint.h>
+
+BOOST_AUTO_TEST_SUITE( particles )
+
+BOOST_AUTO_TEST_CASE(ExchangeStatisticsHighWaterMark)
+{
+    PMacc::ExchangeStatistics statistics;
+    statistics.addStep(10, 1);
+    statistics.addStep(300, 3);
+    statistics.addStep(20, 1);
+
+    BOOST_REQUIRE_EQUAL(statistics.highWaterMark, 300u);
+    BOOST_REQUIRE_EQUAL(statistics.numParticles, 330u);
+    BOOST_REQUIRE_EQUAL(statistics.numExtraRounds, 2u);
+    BOOST_REQUIRE_EQUAL(statistics.numOverflows, 1u);
+    BOOST_REQUIRE_EQUAL(statistics.numSteps, 3u);
+
+    statistics.reset();
+    BOOST_REQUIRE_EQUAL(statistics.highWaterMark, 0u);
+    BOOST_REQUIRE_EQUAL(statistics.numSteps, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveExchangeSizePolicy)
+{
+    const PMacc::AdaptiveExchangeSize policy(100, 10000, 1.5, 0.25);
+
+    /* grow with headroom if the traffic uses more than 2/3 of the buffer */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(1000, 800), 1200u);
+    /* overflowing traffic is limited by the largest size */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(1000, 50000), 10000u);
+    /* small fluctuations keep the size */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(1000, 400), 1000u);
+    /* shrink if the traffic dropped far below the capacity */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(1000, 100), 150u);
+    /* never shrink below the smallest size */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(1000, 0), 100u);
+    /* capacities above the largest size are reduced */
+    BOOST_REQUIRE_EQUAL(policy.getCapacity(20000, 9000), 10000u);
+
+    /* a configured size above the largest size is kept */
+    const PMacc::AdaptiveExchangeSize configured = policy.withConfiguredSize(40000);
+    BOOST_REQUIRE_EQUAL(configured.getCapacity(40000, 0), 40000u);
+    /* and is also the largest size */
+    BOOST_REQUIRE_EQUAL(configured.getCapacity(40000, 30000), 40000u);
+    /* a smaller configured size does not change the limits */
+    BOOST_REQUIRE_EQUAL(policy.withConfiguredSize(50).getCapacity(1000, 0), 100u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
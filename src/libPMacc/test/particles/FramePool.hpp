@@ -0,0 +1,133 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pmacc_types.hpp>
+#include <particles/memory/buffers/FramePool.hpp>
+#include <memory/buffers/HostDeviceBuffer.hpp>
+#include <eventSystem/EventSystem.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <stdint.h>
+
+BOOST_AUTO_TEST_SUITE( particles )
+
+namespace
+{
+    /* the pool never dereferences frames, fake addresses are sufficient */
+    struct DummyFrame
+    {
+    };
+
+    struct PushFrames
+    {
+        template<class T_Pool, class T_Box>
+        DINLINE void operator()(T_Pool pool, T_Box storedBox, uint32_t numFrames) const
+        {
+            const uint32_t localId = blockIdx.x * blockDim.x + threadIdx.x;
+            if(localId < numFrames)
+            {
+                DummyFrame* frame = reinterpret_cast<DummyFrame*>(uint64_cu(localId + 1) * 256u);
+                storedBox(localId) = pool.push(frame) ? 1u : 0u;
+            }
+        }
+    };
+
+    struct PopFrames
+    {
+        template<class T_Pool, class T_Box>
+        DINLINE void operator()(T_Pool pool, T_Box frameBox, uint32_t numFrames) const
+        {
+            const uint32_t localId = blockIdx.x * blockDim.x + threadIdx.x;
+            if(localId < numFrames)
+                frameBox(localId) = reinterpret_cast<uint64_cu>(pool.pop());
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(FramePool)
+{
+    typedef PMacc::FramePool<DummyFrame> Pool;
+    typedef PMacc::FramePoolStatistics Statistics;
+
+    /* one block, all slots are inside the region of the block */
+    constexpr uint32_t numSlots = 8;
+    constexpr uint32_t numFrames = numSlots + 1;
+
+    Pool pool;
+    pool.resize(numSlots, numSlots);
+    pool.enableStatistics(true);
+    BOOST_REQUIRE_EQUAL(pool.getNumSlots(), numSlots);
+
+    PMacc::HostDeviceBuffer<uint32_t, 1> storedBuf(numFrames);
+    PMACC_KERNEL(PushFrames{})(1, numFrames)
+            (pool.getDeviceBox(), storedBuf.getDeviceBuffer().getDataBox(), numFrames);
+    storedBuf.deviceToHost();
+    uint32_t numStored = 0;
+    for(uint32_t i=0; i<numFrames; i++)
+        numStored += storedBuf.getHostBuffer().getDataBox()(i);
+    /* the frame which does not fit must be freed by the caller */
+    BOOST_REQUIRE_EQUAL(numStored, numSlots);
+
+    PMacc::HostDeviceBuffer<uint64_cu, 1> frameBuf(numFrames);
+    PMACC_KERNEL(PopFrames{})(1, numFrames)
+            (pool.getDeviceBox(), frameBuf.getDeviceBuffer().getDataBox(), numFrames);
+    frameBuf.deviceToHost();
+    std::set<uint64_cu> frames;
+    uint32_t numEmpty = 0;
+    for(uint32_t i=0; i<numFrames; i++)
+    {
+        const uint64_cu frame = frameBuf.getHostBuffer().getDataBox()(i);
+        if(frame == 0)
+        {
+            ++numEmpty;
+            continue;
+        }
+        /* each stored frame is handed out exactly once */
+        BOOST_REQUIRE(frames.insert(frame).second);
+        BOOST_REQUIRE_EQUAL(storedBuf.getHostBuffer().getDataBox()(frame / 256u - 1u), 1u);
+    }
+    BOOST_REQUIRE_EQUAL(numEmpty, 1u);
+
+    const Statistics statistics = pool.getStatistics();
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::RELEASES], numFrames);
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::LOCAL_STORES], numSlots);
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::GLOBAL_STORES], 0u);
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::ALLOCATIONS], numFrames);
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::LOCAL_HITS], numSlots);
+    BOOST_REQUIRE_EQUAL(statistics.counters[Statistics::GLOBAL_HITS], 0u);
+    BOOST_REQUIRE_CLOSE(statistics.getHitRate(), double(numSlots) / double(numFrames), 1.0e-9);
+
+    pool.resetStatistics();
+    BOOST_REQUIRE_EQUAL(pool.getStatistics().counters[Statistics::ALLOCATIONS], 0u);
+
+    /* without statistics the device box does not count */
+    pool.enableStatistics(false);
+    BOOST_REQUIRE(pool.getDeviceBox().getNumSlots() == numSlots);
+    PMACC_KERNEL(PopFrames{})(1, numFrames)
+            (pool.getDeviceBox(), frameBuf.getDeviceBuffer().getDataBox(), numFrames);
+    BOOST_REQUIRE_EQUAL(pool.getStatistics().counters[Statistics::ALLOCATIONS], 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,272 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of libPMacc.
+ *
+ * libPMacc is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * libPMacc is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with libPMacc.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pmacc_types.hpp>
+#include <particles/operations/HostSortByCell.hpp>
+#include <particles/ParticlesBase.kernel>
+#include <particles/ParticleDescription.hpp>
+#include <particles/memory/buffers/ParticlesBuffer.hpp>
+#include <memory/buffers/HostDeviceBuffer.hpp>
+#include <identifier/value_identifier.hpp>
+#include <math/Vector.hpp>
+
+#include <mallocMC/mallocMC.hpp>
+#include <boost/mpl/string.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE( particles )
+
+namespace
+{
+    value_identifier(uint32_t, sortTestId, 0);
+
+    typedef PMacc::math::CT::shrinkTo<PMacc::math::CT::Int<8, 8, 4>, TEST_DIM>::type SortTestSuperCellSize;
+
+    typedef PMacc::ParticlesBuffer<
+        PMacc::ParticleDescription<
+            boost::mpl::string<'s'>,
+            SortTestSuperCellSize,
+            boost::mpl::vector<sortTestId>
+        >,
+        SortTestSuperCellSize,
+        TEST_DIM
+    > SortTestBuffer;
+
+    constexpr uint32_t sortTestTileSize = PMacc::math::CT::volume<SortTestSuperCellSize>::type::value;
+    constexpr uint32_t sortTestNoParticle = 0xFFFFFFFFu;
+
+    /* the buffer holds one supercell, all blocks work on it */
+    struct SortTestMapping
+    {
+        typedef SortTestSuperCellSize SuperCellSize;
+        static constexpr uint32_t Dim = TEST_DIM;
+
+        HDINLINE PMacc::DataSpace<Dim> getSuperCellIndex(const PMacc::DataSpace<Dim>&) const
+        {
+            return PMacc::DataSpace<Dim>::create(0);
+        }
+    };
+
+    /* slot `id` of the frame list holds a particle, gaps and a half filled last frame */
+    HDINLINE bool sortTestIsParticle(const uint32_t id, const uint32_t numSlots)
+    {
+        return id % 5u != 3u && id < numSlots - sortTestTileSize / 2u;
+    }
+
+    /* scattered cells with several particles per cell */
+    HDINLINE uint32_t sortTestCell(const uint32_t id)
+    {
+        return (id * 37u + id / 7u) % sortTestTileSize;
+    }
+
+    struct FillSuperCell
+    {
+        template<class T_ParBox>
+        DINLINE void operator()(T_ParBox pb, const int numFrames) const
+        {
+            typedef typename T_ParBox::FramePtr FramePtr;
+
+            const PMacc::DataSpace<TEST_DIM> superCellIdx = PMacc::DataSpace<TEST_DIM>::create(0);
+            if(threadIdx.x == 0)
+            {
+                for(int i = 0; i < numFrames; ++i)
+                {
+                    FramePtr frame = pb.getEmptyFrame();
+                    pb.setAsLastFrame(frame, superCellIdx);
+                }
+            }
+            __syncthreads();
+
+            const uint32_t numSlots = numFrames * sortTestTileSize;
+            uint32_t id = threadIdx.x;
+            for(FramePtr frame = pb.getFirstFrame(superCellIdx); frame.isValid(); frame = pb.getNextFrame(frame))
+            {
+                if(sortTestIsParticle(id, numSlots))
+                {
+                    auto particle = frame[threadIdx.x];
+                    particle[PMacc::multiMask_] = 1;
+                    particle[PMacc::localCellIdx_] = sortTestCell(id);
+                    particle[sortTestId_] = id;
+                }
+                id += sortTestTileSize;
+            }
+        }
+    };
+
+    /* copy id and cell of each slot of the frame list, the number of frames
+     * and the size of the last frame
+     */
+    struct ReadSuperCell
+    {
+        template<class T_ParBox, class T_Box>
+        DINLINE void operator()(T_ParBox pb, T_Box idBox, T_Box cellBox, T_Box infoBox, const int maxFrames) const
+        {
+            typedef typename T_ParBox::FramePtr FramePtr;
+
+            const PMacc::DataSpace<TEST_DIM> superCellIdx = PMacc::DataSpace<TEST_DIM>::create(0);
+            int numFrames = 0;
+            for(FramePtr frame = pb.getFirstFrame(superCellIdx); frame.isValid(); frame = pb.getNextFrame(frame))
+            {
+                if(numFrames < maxFrames)
+                {
+                    auto particle = frame[threadIdx.x];
+                    const uint32_t slot = numFrames * sortTestTileSize + threadIdx.x;
+                    const bool isParticle = particle[PMacc::multiMask_] == 1;
+                    idBox(slot) = isParticle ? uint32_t(particle[sortTestId_]) : sortTestNoParticle;
+                    cellBox(slot) = isParticle ? uint32_t(particle[PMacc::localCellIdx_]) : sortTestNoParticle;
+                }
+                ++numFrames;
+            }
+            if(threadIdx.x == 0)
+            {
+                infoBox(0) = numFrames;
+                infoBox(1) = pb.getSuperCell(superCellIdx).getSizeLastFrame();
+            }
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(HostSortByCell)
+{
+    using PMacc::lcellId_t;
+
+    const lcellId_t cells[] = {3, 0, 3, 1, 0, 3, 2};
+    const std::vector<lcellId_t> cellIdx(cells, cells + sizeof(cells) / sizeof(cells[0]));
+
+    const std::vector<uint32_t> order = PMacc::particles::operations::hostSortByCell(cellIdx, 4);
+
+    /* stable: particles of one cell keep their order */
+    const uint32_t expected[] = {1, 4, 3, 6, 0, 2, 5};
+    BOOST_REQUIRE_EQUAL(order.size(), cellIdx.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        BOOST_REQUIRE_EQUAL(order[i], expected[i]);
+
+    /* empty supercell */
+    BOOST_REQUIRE(PMacc::particles::operations::hostSortByCell(std::vector<lcellId_t>(), 4).empty());
+}
+
+BOOST_AUTO_TEST_CASE(KernelSortParticlesByCell)
+{
+    using PMacc::lcellId_t;
+
+    constexpr int numFrames = 5;
+    constexpr uint32_t numSlots = numFrames * sortTestTileSize;
+
+    /* input in the order of the frame list and the serial reference */
+    std::vector<uint32_t> inIds;
+    std::vector<lcellId_t> inCells;
+    for (uint32_t id = 0; id < numSlots; ++id)
+        if (sortTestIsParticle(id, numSlots))
+        {
+            inIds.push_back(id);
+            inCells.push_back(lcellId_t(sortTestCell(id)));
+        }
+    const uint32_t numParticles = inIds.size();
+    const std::vector<uint32_t> order =
+        PMacc::particles::operations::hostSortByCell(inCells, sortTestTileSize);
+
+    mallocMC::initHeap(64u * 1024u * 1024u);
+    {
+        const PMacc::DataSpace<TEST_DIM> superCellSize(SortTestSuperCellSize::toRT());
+        SortTestBuffer buffer(superCellSize, superCellSize);
+        buffer.createParticleBuffer();
+
+        PMacc::HostDeviceBuffer<uint32_t, 1> idBuf(numSlots);
+        PMacc::HostDeviceBuffer<uint32_t, 1> cellBuf(numSlots);
+        PMacc::HostDeviceBuffer<uint32_t, 1> infoBuf(2);
+
+        PMACC_KERNEL(FillSuperCell{})(1, sortTestTileSize)
+                (buffer.getDeviceParticleBox(), numFrames);
+
+        /* too many frames: the supercell keeps its order */
+        PMACC_KERNEL(PMacc::KernelSortParticlesByCell<numFrames - 1>{})(1, sortTestTileSize)
+                (buffer.getDeviceParticleBox(), SortTestMapping());
+        PMACC_KERNEL(ReadSuperCell{})(1, sortTestTileSize)
+                (buffer.getDeviceParticleBox(),
+                 idBuf.getDeviceBuffer().getDataBox(),
+                 cellBuf.getDeviceBuffer().getDataBox(),
+                 infoBuf.getDeviceBuffer().getDataBox(),
+                 numFrames);
+        idBuf.deviceToHost();
+        infoBuf.deviceToHost();
+        BOOST_REQUIRE_EQUAL(infoBuf.getHostBuffer().getDataBox()(0), uint32_t(numFrames));
+        for (uint32_t slot = 0, i = 0; slot < numSlots; ++slot)
+        {
+            const uint32_t id = idBuf.getHostBuffer().getDataBox()(slot);
+            if (sortTestIsParticle(slot, numSlots))
+                BOOST_REQUIRE_EQUAL(id, inIds[i++]);
+            else
+                BOOST_REQUIRE_EQUAL(id, sortTestNoParticle);
+        }
+
+        PMACC_KERNEL(PMacc::KernelSortParticlesByCell<numFrames>{})(1, sortTestTileSize)
+                (buffer.getDeviceParticleBox(), SortTestMapping());
+        PMACC_KERNEL(ReadSuperCell{})(1, sortTestTileSize)
+                (buffer.getDeviceParticleBox(),
+                 idBuf.getDeviceBuffer().getDataBox(),
+                 cellBuf.getDeviceBuffer().getDataBox(),
+                 infoBuf.getDeviceBuffer().getDataBox(),
+                 numFrames);
+        idBuf.deviceToHost();
+        cellBuf.deviceToHost();
+        infoBuf.deviceToHost();
+
+        /* dense frames */
+        const uint32_t numSortedFrames = (numParticles + sortTestTileSize - 1) / sortTestTileSize;
+        BOOST_REQUIRE_EQUAL(infoBuf.getHostBuffer().getDataBox()(0), numSortedFrames);
+        BOOST_REQUIRE_EQUAL(infoBuf.getHostBuffer().getDataBox()(1),
+                            numParticles - (numSortedFrames - 1) * sortTestTileSize);
+
+        /* same cell at each position as the reference, the order inside a
+         * cell is not defined
+         */
+        std::vector<std::pair<uint32_t, uint32_t> > sorted;
+        std::vector<std::pair<uint32_t, uint32_t> > reference;
+        for (uint32_t slot = 0; slot < numSortedFrames * sortTestTileSize; ++slot)
+        {
+            const uint32_t id = idBuf.getHostBuffer().getDataBox()(slot);
+            const uint32_t cell = cellBuf.getHostBuffer().getDataBox()(slot);
+            if (slot >= numParticles)
+            {
+                BOOST_REQUIRE_EQUAL(id, sortTestNoParticle);
+                continue;
+            }
+            BOOST_REQUIRE_EQUAL(cell, uint32_t(inCells[order[slot]]));
+            BOOST_REQUIRE_EQUAL(cell, sortTestCell(id));
+            sorted.push_back(std::make_pair(cell, id));
+            reference.push_back(std::make_pair(uint32_t(inCells[order[slot]]), inIds[order[slot]]));
+        }
+        std::sort(sorted.begin(), sorted.end());
+        std::sort(reference.begin(), reference.end());
+        BOOST_REQUIRE(sorted == reference);
+    }
+    mallocMC::finalizeHeap();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,28 @@
 #include "PMaccFixture.hpp"
 #include <boost/test/unit_test.hpp>
 
+#include <mallocMC/mallocMC.hpp>
+
+/* heap for the tests which allocate frames, same policies as PIConGPU */
+struct ScatterConfig
+{
+    typedef boost::mpl::int_<2*1024*1024> pagesize;
+    typedef boost::mpl::int_<4> accessblocks;
+    typedef boost::mpl::int_<8> regionsize;
+    typedef boost::mpl::int_<2> wastefactor;
+    typedef boost::mpl::bool_<true> resetfreedpages;
+};
+
+typedef mallocMC::Allocator<
+mallocMC::CreationPolicies::Scatter<ScatterConfig>,
+mallocMC::DistributionPolicies::Noop,
+mallocMC::OOMPolicies::ReturnNull,
+mallocMC::ReservePoolPolicies::SimpleCudaMalloc,
+mallocMC::AlignmentPolicies::Shrink<>
+> ScatterAllocator;
+
+MALLOCMC_SET_ALLOCATOR_TYPE( ScatterAllocator );
+
 #if TEST_DIM == 2
     BOOST_GLOBAL_FIXTURE(PMaccFixture2D);
 #else
@@ -30,3 +52,6 @@
 #endif
 
 #include "IdProvider.hpp"
+#include "ExchangeBuffer.hpp"
+#include "SortByCell.hpp"
+#include "FramePool.hpp"
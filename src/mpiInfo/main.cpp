@@ -20,13 +20,19 @@
 
 #include <mpi.h>
 #include <cstdlib>
+#include <cstring>
+#include <stdint.h>
 #include <iostream> // std::cerr
+#include <map>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/cmdline.hpp>
 #include <boost/program_options/variables_map.hpp>
 
+#include "algorithms/fnv1aHash.hpp"
+
 
 #define MPI_CHECK(cmd) {int error = cmd; if(error!=MPI_SUCCESS){printf("<%s>:%i ",__FILE__,__LINE__); throw std::runtime_error(std::string("[MPI] Error"));}}
 
@@ -61,7 +67,7 @@ void cleanHostname( char* name )
     }
 }
 
-/*! gets hostRank
+/*! gets hostRank (serial reference implementation)
  *
  * process with MPI-rank 0 is the master and builds a map with hostname
  * and number of already known processes on this host.
@@ -69,7 +75,7 @@ void cleanHostname( char* name )
  * from the master.
  *
  */
-int getHostRank( )
+int getHostRankSerial( )
 {
     char hostname[MPI_MAX_PROCESSOR_NAME];
     int length;
@@ -121,6 +127,66 @@ int getHostRank( )
     return hostRank;
 }
 
+/*! gets hostRank
+ *
+ * MPI_COMM_WORLD is split into communicators of all processes on the same
+ * host, the rank in this communicator is the host rank
+ * (same algorithm as in PMacc::CommunicatorMPI).
+ */
+int getHostRank( )
+{
+    int myrank;
+    MPI_CHECK( MPI_Comm_rank( MPI_COMM_WORLD, &myrank ) );
+
+    MPI_Comm nodeComm;
+#if ( MPI_VERSION >= 3 )
+    MPI_CHECK( MPI_Comm_split_type( MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myrank, MPI_INFO_NULL, &nodeComm ) );
+#else
+    char hostname[MPI_MAX_PROCESSOR_NAME];
+    int length;
+
+    memset( hostname, 0, MPI_MAX_PROCESSOR_NAME );
+    MPI_CHECK( MPI_Get_processor_name( hostname, &length ) );
+    cleanHostname( hostname );
+
+    /* MPI requires a non-negative color */
+    const uint32_t hash = PMacc::fnv1aHash32( hostname, strnlen( hostname, MPI_MAX_PROCESSOR_NAME ) );
+
+    MPI_Comm hashComm;
+    MPI_CHECK( MPI_Comm_split( MPI_COMM_WORLD, static_cast<int>( hash & 0x7fffffff ), myrank, &hashComm ) );
+
+    int hashSize;
+    int hashRank;
+    MPI_CHECK( MPI_Comm_size( hashComm, &hashSize ) );
+    MPI_CHECK( MPI_Comm_rank( hashComm, &hashRank ) );
+
+    std::vector<char> hostnames( hashSize * MPI_MAX_PROCESSOR_NAME );
+    MPI_CHECK( MPI_Allgather( hostname, MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                              &hostnames[0], MPI_MAX_PROCESSOR_NAME, MPI_CHAR,
+                              hashComm ) );
+
+    /* separate different hosts with equal hashes */
+    int hostId = hashRank;
+    for ( int i = 0; i < hashSize; ++i )
+    {
+        if ( strncmp( hostname, &hostnames[i * MPI_MAX_PROCESSOR_NAME], MPI_MAX_PROCESSOR_NAME ) == 0 )
+        {
+            hostId = i;
+            break;
+        }
+    }
+
+    MPI_CHECK( MPI_Comm_split( hashComm, hostId, hashRank, &nodeComm ) );
+    MPI_CHECK( MPI_Comm_free( &hashComm ) );
+#endif
+
+    int hostRank;
+    MPI_CHECK( MPI_Comm_rank( nodeComm, &hostRank ) );
+    MPI_CHECK( MPI_Comm_free( &nodeComm ) );
+
+    return hostRank;
+}
+
 int getMyRank( )
 {
     int myrank;
@@ -135,18 +201,60 @@ int getTotalRanks( )
     return totalnodes;
 }
 
+/*! measure the time (maximum over all ranks) to determine the host rank
+ *
+ * @param useSerial use the serial reference implementation
+ * @param[out] hostRank resulting host rank
+ * @return time in seconds
+ */
+double timeHostRank( bool useSerial, int& hostRank )
+{
+    MPI_CHECK( MPI_Barrier( MPI_COMM_WORLD ) );
+    double time = MPI_Wtime( );
+    hostRank = useSerial ? getHostRankSerial( ) : getHostRank( );
+    time = MPI_Wtime( ) - time;
+
+    double maxTime;
+    MPI_CHECK( MPI_Allreduce( &time, &maxTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD ) );
+    return maxTime;
+}
+
+/*! compare the serial host rank handshake with the communicator split */
+void benchmarkHostRank( )
+{
+    int serialHostRank;
+    int hostRank;
+    const double serialTime = timeHostRank( true, serialHostRank );
+    const double time = timeHostRank( false, hostRank );
+
+    int mismatch = serialHostRank != hostRank;
+    int numMismatch;
+    MPI_CHECK( MPI_Reduce( &mismatch, &numMismatch, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD ) );
+
+    if ( getMyRank( ) == 0 )
+    {
+        std::cout << "host rank (serial handshake): " << serialTime << " sec" << std::endl;
+        std::cout << "host rank (communicator split): " << time << " sec" << std::endl;
+        if ( numMismatch != 0 )
+            std::cout << "host ranks differ on " << numMismatch << " ranks" << std::endl;
+    }
+}
+
 int main( int argc, char** argv )
 {
     bool localRank = false;
     bool myRank = false;
     bool totalRank = false;
+    bool benchmark = false;
 
     po::options_description desc( "Allowed options" );
     desc.add_options( )
         ( "help,h", "produce help message" )
         ( "mpi_host_rank", po::value<bool > ( &localRank )->zero_tokens( ), "get local mpi rank" )
         ( "mpi_rank", po::value<bool > ( &myRank )->zero_tokens( ), "get mpi rank" )
-        ( "mpi_size", po::value<bool > ( &totalRank )->zero_tokens( ), "get count of mpi ranks" );
+        ( "mpi_size", po::value<bool > ( &totalRank )->zero_tokens( ), "get count of mpi ranks" )
+        ( "benchmark_host_rank", po::value<bool > ( &benchmark )->zero_tokens( ),
+          "compare the time to get the local mpi rank: serial handshake with rank 0 vs. node-local communicator split" );
 
     // parse command line options and config file and store values in vm
     po::variables_map vm;
@@ -167,6 +275,8 @@ int main( int argc, char** argv )
         std::cout << "mpi_rank: " << getMyRank( ) << std::endl;
     if ( totalRank )
         std::cout << "mpi_size: " << getTotalRanks( ) << std::endl;
+    if ( benchmark )
+        benchmarkHostRank( );
 
 
     MPI_CHECK( MPI_Finalize( ) );
@@ -37,6 +37,11 @@
 #include "particles/traits/GetPhotonCreator.hpp"
 #include "particles/synchrotronPhotons/SynchrotronFunctions.hpp"
 #include "particles/creation/creation.hpp"
+#include "particles/memory/buffers/AdaptiveExchangeSize.hpp"
+#include "particles/memory/dataTypes/ExchangeStatistics.hpp"
+#include "particles/memory/dataTypes/FramePoolStatistics.hpp"
+
+#include <vector>
 
 namespace picongpu
 {
@@ -188,6 +193,149 @@ struct CommunicateSpecies
     }
 };
 
+/** Adapt the exchange buffers of a species to the observed traffic
+ *
+ * Collective over all ranks. The global traffic statistics of each
+ * direction are printed by rank 0.
+ *
+ * @tparam T_SpeciesName name of particle species
+ */
+template<typename T_SpeciesName>
+struct AdaptExchangeBuffers
+{
+    typedef T_SpeciesName SpeciesName;
+    typedef typename SpeciesName::type SpeciesType;
+    typedef typename SpeciesType::FrameType FrameType;
+    typedef typename SpeciesType::BufferType BufferType;
+
+    /**
+     * @param tuple struct with all species
+     * @param minBytes smallest size of an exchange buffer in byte
+     * @param maxBytes largest size of an exchange buffer in byte, larger
+     *                 sizes from memory.param are kept
+     * @param minFreeMemory device memory in byte which must stay free if buffers grow
+     */
+    template<typename T_StorageTuple>
+    HINLINE void operator()(
+                            T_StorageTuple& tuple,
+                            const size_t minBytes,
+                            const size_t maxBytes,
+                            const size_t minFreeMemory
+                            ) const
+    {
+        const size_t bytesPerParticle = BufferType::getBytesPerExchangeParticle();
+        const AdaptiveExchangeSize policy(minBytes / bytesPerParticle, maxBytes / bytesPerParticle);
+
+        const std::vector<ExchangeBufferReport> report =
+            tuple[SpeciesName()]->adaptExchangeBuffers(policy, minFreeMemory);
+
+        if (Environment<simDim>::get().GridController().getGlobalRank() != 0)
+            return;
+
+        for (size_t i = 0; i < report.size(); ++i)
+        {
+            const ExchangeStatistics& statistics = report[i].statistics;
+            if (statistics.numSteps == 0)
+                continue;
+
+            log<picLog::MEMORY > ("exchange %1% %2%: max %3% particles per step (%4%%% of %5% MiB), "
+                                  "%6% overflows with %7% extra rounds, new size %8% MiB") %
+                FrameType::getName() % ExchangeTypeNames()[report[i].exchange] %
+                statistics.highWaterMark %
+                (100.0 * float_64(statistics.highWaterMark) / float_64(report[i].oldCapacity)) %
+                (float_64(report[i].oldCapacity * bytesPerParticle) / 1024. / 1024.) %
+                statistics.numOverflows % statistics.numExtraRounds %
+                (float_64(report[i].newCapacity * bytesPerParticle) / 1024. / 1024.);
+        }
+    }
+};
+
+/** Set the number of spare frames which a species keeps for recycling
+ *
+ * @tparam T_SpeciesName name of particle species
+ */
+template<typename T_SpeciesName>
+struct SetFramePoolSize
+{
+    typedef T_SpeciesName SpeciesName;
+    typedef typename SpeciesName::type SpeciesType;
+    typedef typename SpeciesType::FrameType FrameType;
+
+    /**
+     * @param tuple struct with all species
+     * @param numSlots maximal number of spare frames, 0 disables recycling
+     * @param numProbes slots searched per frame request and region
+     * @param countStatistics count requests and hits for LogFramePoolStatistics
+     */
+    template<typename T_StorageTuple>
+    HINLINE void operator()(T_StorageTuple& tuple, const uint32_t numSlots, const uint32_t numProbes,
+                            const bool countStatistics) const
+    {
+        FramePool<FrameType>& framePool =
+            tuple[SpeciesName()]->getParticlesBuffer().getFramePool();
+        framePool.resize(numSlots, numProbes);
+        framePool.enableStatistics(countStatistics);
+    }
+};
+
+/** Print the frame recycling statistics of a species
+ *
+ * Collective over all ranks, rank 0 prints the global sums.
+ * The counters are reset afterwards.
+ *
+ * @tparam T_SpeciesName name of particle species
+ */
+template<typename T_SpeciesName>
+struct LogFramePoolStatistics
+{
+    typedef T_SpeciesName SpeciesName;
+    typedef typename SpeciesName::type SpeciesType;
+    typedef typename SpeciesType::FrameType FrameType;
+
+    template<typename T_StorageTuple>
+    HINLINE void operator()(T_StorageTuple& tuple) const
+    {
+        auto& framePool = tuple[SpeciesName()]->getParticlesBuffer().getFramePool();
+        const FramePoolStatistics localStatistics = framePool.getStatistics();
+        framePool.resetStatistics();
+
+        GridController<simDim>& gc = Environment<simDim>::get().GridController();
+        FramePoolStatistics statistics;
+        MPI_CHECK(MPI_Reduce(localStatistics.counters, statistics.counters,
+                             FramePoolStatistics::NUM_COUNTERS, MPI_UINT64_T, MPI_SUM,
+                             0, gc.getCommunicator().getMPIComm()));
+
+        if (gc.getGlobalRank() != 0)
+            return;
+
+        const uint64_t numRequests = statistics.counters[FramePoolStatistics::ALLOCATIONS];
+        const uint64_t numLocalHits = statistics.counters[FramePoolStatistics::LOCAL_HITS];
+        log<picLog::MEMORY > ("frame pool %1%: %2% frames requested, %3%%% recycled (%4%%% in the block region), "
+                              "%5%%% of %6% released frames kept") %
+            FrameType::getName() % numRequests %
+            (100.0 * statistics.getHitRate()) %
+            (numRequests == 0 ? 0.0 : 100.0 * float_64(numLocalHits) / float_64(numRequests)) %
+            (100.0 * statistics.getStoreRate()) %
+            statistics.counters[FramePoolStatistics::RELEASES];
+    }
+};
+
+/** Sort the particles of a species inside each supercell by their cell
+ *
+ * @tparam T_SpeciesName name of particle species
+ */
+template<typename T_SpeciesName>
+struct SortParticlesByCell
+{
+    typedef T_SpeciesName SpeciesName;
+
+    template<typename T_StorageTuple>
+    HINLINE void operator()(T_StorageTuple& tuple) const
+    {
+        tuple[SpeciesName()]->template sortParticlesByCell<SORT_MAX_FRAMES_PER_SUPERCELL>();
+    }
+};
+
 /** update momentum, move and communicate all species */
 struct PushAllSpecies
 {
@@ -127,6 +127,31 @@ private:
 
             /* get dimensions and offsets (collective call) */
             Domain fileDomain = pdc.getGlobalDomain(ParamClass::iteration, ParamClass::datasetName);
+
+            /* a 2D profile (z size 1) with the attribute extrusionSize (see
+             * png2gas) is repeated extrusionSize times in z direction
+             */
+            uint64_t extrusionSize = 0;
+            if (simDim == DIM3 && fileDomain.getSize()[2] == 1)
+            {
+                try
+                {
+                    pdc.readAttribute(ParamClass::iteration, ParamClass::datasetName,
+                                      "extrusionSize", &extrusionSize);
+                }
+                catch (const DCException&)
+                {
+                    extrusionSize = 0;
+                }
+            }
+            const bool isExtruded = extrusionSize > 0;
+            if (isExtruded)
+            {
+                Dimensions extrudedSize(fileDomain.getSize());
+                extrudedSize[2] = extrusionSize;
+                fileDomain = Domain(fileDomain.getOffset(), extrudedSize);
+            }
+
             Dimensions fileDomainEnd = fileDomain.getOffset() + fileDomain.getSize();
             DataSpace<simDim> accessSpace;
             DataSpace<simDim> accessOffset;
@@ -188,7 +213,16 @@ private:
             size_t accessSize = accessSpace.productOfComponents();
             if (accessSize > 0)
             {
-                tmpBfr = new ValueType[accessSize];
+                /* read only one plane of an extruded profile */
+                size_t readSize = accessSize;
+                if (isExtruded)
+                {
+                    fileAccessSpace[2] = 1;
+                    fileAccessOffset[2] = 0;
+                    readSize = fileAccessSpace.getScalarSize();
+                }
+
+                tmpBfr = new ValueType[readSize];
 
                 Dimensions sizeRead(0, 0, 0);
                 pdc.read(
@@ -199,7 +233,7 @@ private:
                          sizeRead,
                          tmpBfr);
 
-                if (sizeRead.getScalarSize() != accessSize)
+                if (sizeRead.getScalarSize() != readSize)
                 {
                     __delete(tmpBfr);
                     return;
@@ -212,10 +246,15 @@ private:
                 DataSpace<simDim> guards = fieldBuffer.getGridLayout().getGuard();
                 D1Box d1RAccess(dataBox.shift(guards + accessOffset), accessSpace);
 
-                /* copy from temporary buffer to fieldTmp host buffer */
-                for (int i = 0; i < accessSpace.productOfComponents(); ++i)
+                /* copy from temporary buffer to fieldTmp host buffer,
+                 * an extruded plane is repeated for all z
+                 */
+                const int numElements = accessSpace.productOfComponents();
+                const int readElements = readSize;
+                #pragma omp parallel for
+                for (int i = 0; i < numElements; ++i)
                 {
-                    d1RAccess[i].x() = tmpBfr[i];
+                    d1RAccess[i].x() = tmpBfr[i % readElements];
                 }
 
                 __delete(tmpBfr);
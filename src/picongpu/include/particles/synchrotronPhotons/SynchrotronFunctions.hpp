@@ -29,6 +29,8 @@
 #include "cuSTL/cursor/BufferCursor.hpp"
 #include <boost/shared_ptr.hpp>
 #include <boost/math/tr1.hpp> /* cyl_bessel_k */
+#include <string>
+#include <vector>
 
 namespace picongpu
 {
@@ -98,20 +100,55 @@ private:
         }
     };
 
-    /** First synchrotron function
+    /** Integral of the bessel function K_5/3 from `lower` to `upper`
      */
-    float_64 F_1(const float_64 x) const;
+    float_64 integrateBesselK(const float_64 lower, const float_64 upper) const;
     /** Second synchrotron function
      */
     float_64 F_2(const float_64 x) const;
 
+    /** Fill both lookup tables
+     *
+     * The first synchrotron function is computed by a single cumulative
+     * integration of K_5/3 from the integral bound backwards over all sample
+     * points. The interval integrals and the second synchrotron function are
+     * computed in parallel.
+     */
+    void computeTables(std::vector<float_X>& table_F_1, std::vector<float_X>& table_F_2) const;
+
+    /** Hash of all parameters influencing the lookup tables */
+    uint64_t getParameterHash() const;
+
+    /** Name of the cache file for the current table parameters */
+    std::string getCacheFileName(const std::string& cacheDirectory) const;
+
+    /** Read both tables from a cache file
+     *
+     * @return false if the file does not exist or does not match the
+     *         current table parameters
+     */
+    bool loadCache(const std::string& fileName,
+                   std::vector<float_X>& table_F_1, std::vector<float_X>& table_F_2) const;
+
+    /** Write both tables to a cache file */
+    void storeCache(const std::string& fileName,
+                    const std::vector<float_X>& table_F_1, const std::vector<float_X>& table_F_2) const;
+
 public:
     enum Select
     {
         first=0, second=1
     };
 
-    void init();
+    /** Create the lookup tables on the device
+     *
+     * The tables are computed by the root rank and broadcasted to all other
+     * ranks.
+     *
+     * @param cacheDirectory directory to load the tables from and to store
+     *        them to for later runs, caching is disabled if empty
+     */
+    void init(const std::string& cacheDirectory = std::string());
     /** Return a cursor representing a synchrotron function
      *
      * @param syncFunction first or second synchrotron function
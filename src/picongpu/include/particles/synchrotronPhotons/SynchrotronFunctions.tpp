@@ -22,8 +22,16 @@
 
 #include "particles/synchrotronPhotons/SynchrotronFunctions.hpp"
 #include "simulation_defines.hpp"
+#include "algorithms/fnv1aHash.hpp"
 #include <boost/array.hpp>
 #include <boost/numeric/odeint/integrate/integrate.hpp>
+#include <mpi.h>
+#include <unistd.h> /* getpid */
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 
 namespace picongpu
@@ -61,22 +69,23 @@ HDINLINE float_X MapToLookupTable::operator()(const float_X x) const
 } // namespace detail
 
 
-/** First synchrotron function
+/** Integral of the bessel function K_5/3 from `lower` to `upper`
  */
-float_64 SynchrotronFunctions::F_1(const float_64 x) const
+float_64 SynchrotronFunctions::integrateBesselK(const float_64 lower, const float_64 upper) const
 {
-    if(x == float_64(0.0))
+    if(lower >= upper)
         return float_64(0.0);
 
     using namespace boost::numeric::odeint;
     typedef boost::array<float_64, 1> state_type;
 
     state_type integral_result = {0.0};
-    const float_64 upper_bound(SYNC_FUNCS_F1_INTEGRAL_BOUND);
-    const float_64 stepwidth(SYNC_FUNCS_BESSEL_INTEGRAL_STEPWIDTH);
-    integrate(BesselK(), integral_result, x, upper_bound, stepwidth);
+    const float_64 stepwidth = std::min(
+        float_64(SYNC_FUNCS_BESSEL_INTEGRAL_STEPWIDTH),
+        upper - lower);
+    integrate(BesselK(), integral_result, lower, upper, stepwidth);
 
-    return x * integral_result[0];
+    return integral_result[0];
 }
 /** Second synchrotron function
  */
@@ -89,27 +98,200 @@ float_64 SynchrotronFunctions::F_2(const float_64 x) const
 }
 
 
-void SynchrotronFunctions::init()
+void SynchrotronFunctions::computeTables(
+    std::vector<float_X>& table_F_1,
+    std::vector<float_X>& table_F_2) const
+{
+    const int numSamples = static_cast<int>(SYNC_FUNCS_NUM_SAMPLES);
+    const float_64 upper_bound(SYNC_FUNCS_F1_INTEGRAL_BOUND);
+
+    /* sample points, this mapping increases the sample point density for
+     * small values of x where the synchrotron functions have a divergent slope.
+     * Without this mapping the emission probabilty of low-energy photons
+     * is underestimated.
+     */
+    std::vector<float_64> x(numSamples);
+    for(int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+    {
+        const float_64 x_m = float_64(sampleIdx) * SYNC_FUNCS_STEP_WIDTH;
+        x[sampleIdx] = x_m * x_m * x_m;
+    }
+
+    /* integral of K_5/3 between two neighboring sample points (clipped
+     * to the integral bound), entry `i` holds the interval [x_i, x_i+1]
+     */
+    std::vector<float_64> intervalIntegral(numSamples, 0.0);
+
+    table_F_1.resize(numSamples);
+    table_F_2.resize(numSamples);
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(int sampleIdx = 0; sampleIdx < numSamples; sampleIdx++)
+    {
+        /* F_1(0) is zero, the integral of K_5/3 starting at zero diverges */
+        if(sampleIdx > 0)
+        {
+            const float_64 lower = std::min(x[sampleIdx], upper_bound);
+            const float_64 upper = sampleIdx + 1 < numSamples ?
+                std::min(x[sampleIdx + 1], upper_bound) : upper_bound;
+            intervalIntegral[sampleIdx] = this->integrateBesselK(lower, upper);
+        }
+
+        table_F_2[sampleIdx] = static_cast<float_X>(this->F_2(x[sampleIdx]));
+    }
+
+    /* F_1(x) = x * int_x^bound K_5/3(t) dt, accumulated backwards */
+    float_64 integral(0.0);
+    for(int sampleIdx = numSamples - 1; sampleIdx > 0; sampleIdx--)
+    {
+        integral += intervalIntegral[sampleIdx];
+        table_F_1[sampleIdx] = static_cast<float_X>(x[sampleIdx] * integral);
+    }
+    table_F_1[0] = float_X(0.0);
+}
+
+
+uint64_t SynchrotronFunctions::getParameterHash() const
+{
+    /* FNV-1a over the raw bytes of all table parameters */
+    uint64_t hash = 14695981039346656037ull;
+    const auto combine = [&hash](const void* data, const size_t size)
+    {
+        hash = PMacc::fnv1aHash64(data, size, hash);
+    };
+
+    /* increase if the table generation changes */
+    const uint32_t formatVersion = 1u;
+    const uint32_t numSamples = SYNC_FUNCS_NUM_SAMPLES;
+    const uint32_t floatSize = sizeof(float_X);
+    const float_64 cutOff = SYNC_FUNCS_CUTOFF;
+    const float_64 stepWidth = SYNC_FUNCS_STEP_WIDTH;
+    const float_64 besselStepWidth = SYNC_FUNCS_BESSEL_INTEGRAL_STEPWIDTH;
+    const float_64 integralBound = SYNC_FUNCS_F1_INTEGRAL_BOUND;
+
+    combine(&formatVersion, sizeof(formatVersion));
+    combine(&numSamples, sizeof(numSamples));
+    combine(&floatSize, sizeof(floatSize));
+    combine(&cutOff, sizeof(cutOff));
+    combine(&stepWidth, sizeof(stepWidth));
+    combine(&besselStepWidth, sizeof(besselStepWidth));
+    combine(&integralBound, sizeof(integralBound));
+
+    return hash;
+}
+
+
+std::string SynchrotronFunctions::getCacheFileName(const std::string& cacheDirectory) const
+{
+    std::stringstream fileName;
+    fileName << cacheDirectory << "/synchrotronFunctions_"
+             << std::hex << std::setw(16) << std::setfill('0')
+             << this->getParameterHash() << ".bin";
+    return fileName.str();
+}
+
+
+bool SynchrotronFunctions::loadCache(
+    const std::string& fileName,
+    std::vector<float_X>& table_F_1,
+    std::vector<float_X>& table_F_2) const
+{
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    if(!file.is_open())
+        return false;
+
+    uint64_t hash = 0;
+    uint32_t numSamples = 0;
+    file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    file.read(reinterpret_cast<char*>(&numSamples), sizeof(numSamples));
+    if(!file || hash != this->getParameterHash() || numSamples != SYNC_FUNCS_NUM_SAMPLES)
+        return false;
+
+    table_F_1.resize(numSamples);
+    table_F_2.resize(numSamples);
+    file.read(reinterpret_cast<char*>(&table_F_1[0]), numSamples * sizeof(float_X));
+    file.read(reinterpret_cast<char*>(&table_F_2[0]), numSamples * sizeof(float_X));
+
+    return static_cast<bool>(file);
+}
+
+
+void SynchrotronFunctions::storeCache(
+    const std::string& fileName,
+    const std::vector<float_X>& table_F_1,
+    const std::vector<float_X>& table_F_2) const
+{
+    /* write to a temporary file first, concurrent runs never see a
+     * partially written cache file
+     */
+    std::stringstream tmpFileName;
+    tmpFileName << fileName << ".tmp" << getpid();
+
+    std::ofstream file(tmpFileName.str().c_str(), std::ios::binary);
+    if(!file.is_open())
+    {
+        log<picLog::PHYSICS>("Can not write synchrotron functions cache file %1%") % fileName;
+        return;
+    }
+
+    const uint64_t hash = this->getParameterHash();
+    const uint32_t numSamples = SYNC_FUNCS_NUM_SAMPLES;
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(&numSamples), sizeof(numSamples));
+    file.write(reinterpret_cast<const char*>(&table_F_1[0]), numSamples * sizeof(float_X));
+    file.write(reinterpret_cast<const char*>(&table_F_2[0]), numSamples * sizeof(float_X));
+    file.close();
+
+    if(!file || std::rename(tmpFileName.str().c_str(), fileName.c_str()) != 0)
+    {
+        std::remove(tmpFileName.str().c_str());
+        log<picLog::PHYSICS>("Can not write synchrotron functions cache file %1%") % fileName;
+    }
+}
+
+
+void SynchrotronFunctions::init(const std::string& cacheDirectory)
 {
     const uint32_t numSamples = SYNC_FUNCS_NUM_SAMPLES;
 
     this->dBuf_SyncFuncs[first] = MyBuf(new PMacc::container::DeviceBuffer<float_X, DIM1>(numSamples));
     this->dBuf_SyncFuncs[second] = MyBuf(new PMacc::container::DeviceBuffer<float_X, DIM1>(numSamples));
 
+    std::vector<float_X> table_F_1(numSamples);
+    std::vector<float_X> table_F_2(numSamples);
+
+    PMacc::GridController<simDim>& gc = Environment<simDim>::get().GridController();
+    MPI_Comm comm = gc.getCommunicator().getMPIComm();
+
+    if(gc.getGlobalRank() == 0)
+    {
+        const bool useCache = !cacheDirectory.empty();
+        const std::string fileName = useCache ? this->getCacheFileName(cacheDirectory) : std::string();
+
+        if(useCache && this->loadCache(fileName, table_F_1, table_F_2))
+            log<picLog::PHYSICS>("Synchrotron functions loaded from %1%") % fileName;
+        else
+        {
+            log<picLog::PHYSICS>("Compute synchrotron functions (%1% samples)") % numSamples;
+            this->computeTables(table_F_1, table_F_2);
+            if(useCache)
+            {
+                Environment<simDim>::get().Filesystem().createDirectory(cacheDirectory);
+                this->storeCache(fileName, table_F_1, table_F_2);
+            }
+        }
+    }
+
+    MPI_CHECK(MPI_Bcast(&table_F_1[0], numSamples * sizeof(float_X), MPI_CHAR, 0, comm));
+    MPI_CHECK(MPI_Bcast(&table_F_2[0], numSamples * sizeof(float_X), MPI_CHAR, 0, comm));
+
     PMacc::container::HostBuffer<float_X, DIM1> hBuf_F_1(numSamples);
     PMacc::container::HostBuffer<float_X, DIM1> hBuf_F_2(numSamples);
 
     for(uint32_t sampleIdx = 0u; sampleIdx < numSamples; sampleIdx++)
     {
-        const float_64 x_m = float_64(sampleIdx) * SYNC_FUNCS_STEP_WIDTH;
-        /* This mapping increases the sample point density for small values of x
-         * where the synchrotron functions have a divergent slope. Without this mapping
-         * the emission probabilty of low-energy photons is underestimated.
-         */
-        const float_64 x = x_m * x_m * x_m;
-
-        hBuf_F_1.origin()[sampleIdx] = static_cast<float_X>(this->F_1(x));
-        hBuf_F_2.origin()[sampleIdx] = static_cast<float_X>(this->F_2(x));
+        hBuf_F_1.origin()[sampleIdx] = table_F_1[sampleIdx];
+        hBuf_F_2.origin()[sampleIdx] = table_F_2[sampleIdx];
     }
 
     *this->dBuf_SyncFuncs[first] = hBuf_F_1;
@@ -37,15 +37,13 @@
 #include "mappings/kernel/AreaMapping.hpp"
 #include "plugins/ISimulationPlugin.hpp"
 
-#include "mpi/reduceMethods/Reduce.hpp"
-#include "mpi/MPIReduce.hpp"
-#include "nvidia/functors/Add.hpp"
-
 #include "algorithms/Gamma.hpp"
 #include "algorithms/KinEnergy.hpp"
 #include "memory/shared/Allocate.hpp"
+#include "algorithms/histogram/Histogram.hpp"
 
 #include "common/txtFileHandling.hpp"
+#include "plugins/common/ReductionService.hpp"
 
 namespace picongpu
 {
@@ -57,10 +55,12 @@ struct KernelBinEnergyParticles
 {
     /* sum up the energy of all particles
      * the kinetic energy of all active particles will be calculated
+     *
+     * bin 0 is for <minEnergy, bin numBins+1 is for >maxEnergy
      */
-    template<class ParBox, class BinBox, class Mapping>
+    template<class ParBox, class DeviceHistogram, class Mapping>
     DINLINE void operator()(ParBox pb,
-                                             BinBox gBins, int numBins,
+                                             DeviceHistogram histogram, int numBins,
                                              float_X minEnergy,
                                              float_X maxEnergy,
                                              float_X maximumSlopeToDetectorX,
@@ -77,18 +77,7 @@ struct KernelBinEnergyParticles
 
         const bool enableDetector = maximumSlopeToDetectorX != float_X(0.0) && maximumSlopeToDetectorZ != float_X(0.0);
 
-        /* shBins index can go from 0 to (numBins+2)-1
-         * 0 is for <minEnergy
-         * (numBins+2)-1 is for >maxEnergy
-         */
-        extern __shared__ float_X shBin[]; /* size must be numBins+2 because we have <min and >max */
-
-        int realNumBins = numBins + 2;
-
-
-
         typedef typename Mapping::SuperCellSize SuperCellSize;
-        const int threads = PMacc::math::CT::volume<SuperCellSize>::type::value;
 
         const DataSpace<simDim > threadIndex(threadIdx);
         const int linearThreadIdx = DataSpaceOperations<simDim>::template map<SuperCellSize > (threadIndex);
@@ -99,27 +88,26 @@ struct KernelBinEnergyParticles
             frame = pb.getLastFrame(superCellIdx);
             particlesInSuperCell = pb.getSuperCell(superCellIdx).getSizeLastFrame();
         }
-        /* set all bins to 0 */
-        for (int i = linearThreadIdx; i < realNumBins; i += threads)
-        {
-            shBin[i] = float_X(0.);
-        }
-
         __syncthreads();
         if (!frame.isValid())
           return; /* end kernel if we have no frames */
 
+        /* privatized histogram of this block, set to zero */
+        auto blockHistogram = histogram.getBlockHistogram();
+
         while (frame.isValid())
         {
-            if (linearThreadIdx < particlesInSuperCell)
+            bool calcParticle = linearThreadIdx < particlesInSuperCell;
+            int binNumber = 0;
+            float_X normedWeighting = float_X(0.0);
+
+            if (calcParticle)
             {
                 auto particle = frame[linearThreadIdx];
                 /* kinetic Energy for Particles: E^2 = p^2*c^2 + m^2*c^4
                  *                                   = c^2 * [p^2 + m^2*c^2] */
                 const float3_X mom = particle[momentum_];
 
-                bool calcParticle = true;
-
                 if (enableDetector && mom.y() > 0.0)
                 {
                     const float_X slopeMomX = abs(mom.x() / mom.y());
@@ -141,7 +129,7 @@ struct KernelBinEnergyParticles
                     localEnergy /= weighting;
 
                     /* +1 move value from 1 to numBins+1 */
-                    int binNumber = math::floor((localEnergy - minEnergy) /
+                    binNumber = math::floor((localEnergy - minEnergy) /
                                           (maxEnergy - minEnergy) * (float_32) numBins) + 1;
 
                     const int maxBin = numBins + 1;
@@ -152,17 +140,15 @@ struct KernelBinEnergyParticles
                     /* all entries smaller than minEnergy go into bin zero */
                     binNumber = binNumber > 0 ? binNumber : 0;
 
-                    /*!\todo: we can't use 64bit type on this place (NVIDIA BUG?)
-                     * COMPILER ERROR: ptxas /tmp/tmpxft_00005da6_00000000-2_main.ptx, line 4246; error   : Global state space expected for instruction 'atom'
-                     * I think this is a problem with extern shared mem and atmic (only on TESLA)
-                     * NEXT BUG: don't do uint32_t w=__float2uint_rn(weighting); and use w for atomic, this create wrong results
-                     */
-                    /* overflow for big weighting reduces in shared mem */
-                    /* atomicAdd(&(shBin[binNumber]), (uint32_t) weighting); */
-                    const float_X normedWeighting = float_X(weighting) / float_X(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
-                    atomicAddWrapper(&(shBin[binNumber]), normedWeighting);
+                    /* the fixed point accumulation of the histogram can not
+                     * overflow for realistic weightings and adds small
+                     * weightings exactly to large bins */
+                    normedWeighting = float_X(weighting) / float_X(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
                 }
             }
+            /* called by all threads, threads of a warp adding to the same bin are combined */
+            blockHistogram.add(calcParticle, binNumber, normedWeighting);
+
             __syncthreads();
             if (linearThreadIdx == 0)
             {
@@ -172,12 +158,7 @@ struct KernelBinEnergyParticles
             __syncthreads();
         }
 
-        __syncthreads();
-        for (int i = linearThreadIdx; i < realNumBins; i += threads)
-        {
-            atomicAddWrapper(&(gBins[i]), float_64(shBin[i]));
-        }
-        __syncthreads();
+        blockHistogram.flush();
     }
 };
 
@@ -190,14 +171,17 @@ private:
 
     ParticlesType *particles;
 
-    GridBuffer<float_64, DIM1> *gBins;
+    /* energy histogram of the local particles in units of TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE */
+    typedef algorithms::histogram::Histogram<algorithms::histogram::accumulation::FixedPoint> EnergyHistogram;
+    EnergyHistogram *gBins;
     MappingDesc *cellDescription;
 
     std::string analyzerName;
     std::string analyzerPrefix;
     std::string filename;
 
-    float_64 * binReduced;
+    /* local histogram in number of real particles */
+    float_64 * binLocal;
 
     uint32_t notifyPeriod;
     int numBins;
@@ -216,7 +200,7 @@ private:
     /* only rank 0 create a file */
     bool writeToFile;
 
-    mpi::MPIReduce reduce;
+    ReductionService::QuantityId quantityId;
 
 public:
 
@@ -318,18 +302,33 @@ private:
 
             realNumBins = numBins + 2;
 
-            /* create an array of float_64 on gpu und host */
-            gBins = new GridBuffer<float_64, DIM1 > (DataSpace<DIM1 > (realNumBins));
-            binReduced = new float_64[realNumBins];
+            gBins = new EnergyHistogram(realNumBins);
+            binLocal = new float_64[realNumBins];
             for (int i = 0; i < realNumBins; ++i)
             {
-                binReduced[i] = 0.0;
+                binLocal[i] = 0.0;
             }
 
-            writeToFile = reduce.hasResult(mpi::reduceMethods::Reduce());
+            ReductionService& reductionService = ReductionService::getInstance();
+            writeToFile = reductionService.hasResult();
             if( writeToFile )
                 openNewFile();
 
+            std::vector<std::string> columns;
+            columns.push_back("underflow");
+            for (int i = 0; i < numBins; ++i)
+                columns.push_back(std::string("bin") + std::to_string(i));
+            columns.push_back("overflow");
+            quantityId = reductionService.registerQuantity(
+                analyzerPrefix,
+                columns,
+                NotificationSchedule(notifyPeriod),
+                ReductionService::sum,
+                [this](uint32_t currentStep, const float_64* binReduced)
+                {
+                    this->writeHistogram(currentStep, binReduced);
+                });
+
             Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyPeriod);
         }
     }
@@ -338,6 +337,9 @@ private:
     {
         if (notifyPeriod > 0)
         {
+            /* write the results of the last reduction */
+            ReductionService::getInstance().unregisterQuantity(quantityId);
+
             if (writeToFile)
             {
                 outFile.flush();
@@ -348,7 +350,7 @@ private:
             }
 
             __delete(gBins);
-            __deleteArray(binReduced);
+            __deleteArray(binLocal);
         }
     }
 
@@ -377,7 +379,7 @@ private:
     template< uint32_t AREA>
     void calBinEnergyParticles(uint32_t currentStep)
     {
-        gBins->getDeviceBuffer().setValue(0);
+        gBins->reset();
         auto block = MappingDesc::SuperCellSize::toRT();
 
         /** Assumption: distanceToDetector >> simulated Area in y-Direction
@@ -397,19 +399,29 @@ private:
 
         AreaMapping<AREA, MappingDesc> mapper(*cellDescription);
         PMACC_KERNEL(KernelBinEnergyParticles{})
-            (mapper.getGridDim(), block, (realNumBins) * sizeof (float_X))
+            (mapper.getGridDim(), block, gBins->getSharedMemBytes())
             (particles->getDeviceParticlesBox(),
-             gBins->getDeviceBuffer().getDataBox(), numBins, minEnergy,
+             gBins->getDeviceHistogram(), numBins, minEnergy,
              maxEnergy, maximumSlopeToDetectorX, maximumSlopeToDetectorZ, mapper);
 
-        gBins->deviceToHost();
+        const float_64* binGPU = gBins->merge();
 
-        reduce(nvidia::functors::Add(),
-               binReduced,
-               gBins->getHostBuffer().getBasePointer(),
-               realNumBins, mpi::reduceMethods::Reduce());
+        /* histogram in number of real particles, added over all GPUs by the reduction service */
+        for (int i = 0; i < realNumBins; ++i)
+        {
+            binLocal[i] = binGPU[i] *
+                float_64(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
+        }
 
+        ReductionService::getInstance().contribute(quantityId, currentStep, binLocal);
+    }
 
+    /** write one histogram to file
+     *
+     * called by the reduction service on the rank with writeToFile == true
+     */
+    void writeHistogram(uint32_t currentStep, const float_64* binReduced)
+    {
         if (writeToFile)
         {
             typedef std::numeric_limits< float_64 > dbl;
@@ -424,9 +436,9 @@ private:
             for (int i = 0; i < realNumBins; ++i)
             {
                 count_particles += float_64( binReduced[i]);
-                outFile << std::scientific << (binReduced[i]) * float_64(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE) << " ";
+                outFile << std::scientific << binReduced[i] << " ";
             }
-            outFile << std::scientific << count_particles * float_64(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE)
+            outFile << std::scientific << count_particles
                 << std::endl;
             /* endl: Flush any step to the file.
              * Thus, we will have data if the program should crash. */
@@ -34,16 +34,12 @@
 
 #include "plugins/ISimulationPlugin.hpp"
 
-#include "mpi/reduceMethods/Reduce.hpp"
-#include "mpi/MPIReduce.hpp"
-#include "nvidia/functors/Add.hpp"
-#include "nvidia/functors/Max.hpp"
-
 #include "simulation_classTypes.hpp"
 
 #include "particles/operations/CountParticles.hpp"
 
 #include "common/txtFileHandling.hpp"
+#include "plugins/common/ReductionService.hpp"
 
 namespace picongpu
 {
@@ -68,7 +64,10 @@ private:
     /*only rank 0 create a file*/
     bool writeToFile;
 
-    mpi::MPIReduce reduce;
+    /* number of particles added over all GPUs */
+    ReductionService::QuantityId countId;
+    /* maximum number of particles per GPU, only with log level CRITICAL */
+    ReductionService::QuantityId maxCountId;
 public:
 
     CountParticles() :
@@ -120,7 +119,32 @@ private:
     {
         if (notifyPeriod > 0)
         {
-            writeToFile = reduce.hasResult(mpi::reduceMethods::Reduce());
+            ReductionService& reductionService = ReductionService::getInstance();
+            writeToFile = reductionService.hasResult();
+
+            countId = reductionService.registerQuantity(
+                analyzerPrefix,
+                std::vector<std::string>(1, "count"),
+                NotificationSchedule(notifyPeriod),
+                ReductionService::sum,
+                [this](uint32_t currentStep, const float_64* reducedValue)
+                {
+                    this->writeCount(currentStep, *reducedValue);
+                });
+
+            if (picLog::log_level & picLog::CRITICAL::lvl)
+            {
+                maxCountId = reductionService.registerQuantity(
+                    analyzerPrefix,
+                    std::vector<std::string>(1, "maxPerGPU"),
+                    NotificationSchedule(notifyPeriod),
+                    ReductionService::max,
+                    [](uint32_t, const float_64* reducedValueMax)
+                    {
+                        log<picLog::CRITICAL > ("maximum number of  particles on a GPU : %d\n") %
+                            static_cast<uint64_cu>(*reducedValueMax);
+                    });
+            }
 
             if (writeToFile)
             {
@@ -142,6 +166,12 @@ private:
     {
         if (notifyPeriod > 0)
         {
+            /* write the results of the last reduction */
+            ReductionService& reductionService = ReductionService::getInstance();
+            reductionService.unregisterQuantity(countId);
+            if (picLog::log_level & picLog::CRITICAL::lvl)
+                reductionService.unregisterQuantity(maxCountId);
+
             if (writeToFile)
             {
                 outFile.flush();
@@ -188,31 +218,21 @@ private:
                                                           *cellDescription,
                                                           DataSpace<simDim>(),
                                                           localSize);
-        uint64_cu reducedValueMax;
-        if (picLog::log_level & picLog::CRITICAL::lvl)
-        {
-            reduce(nvidia::functors::Max(),
-                   &reducedValueMax,
-                   &size,
-                   1,
-                   mpi::reduceMethods::Reduce());
-        }
-
+        /* counts are exact in float_64 up to 2^53 particles */
+        const float_64 localCount = static_cast<float_64>(size);
 
-        uint64_cu reducedValue;
-        reduce(nvidia::functors::Add(),
-               &reducedValue,
-               &size,
-               1,
-               mpi::reduceMethods::Reduce());
+        ReductionService& reductionService = ReductionService::getInstance();
+        if (picLog::log_level & picLog::CRITICAL::lvl)
+            reductionService.contribute(maxCountId, currentStep, &localCount);
+        reductionService.contribute(countId, currentStep, &localCount);
+    }
 
+    /** called by the reduction service on the rank with writeToFile == true */
+    void writeCount(uint32_t currentStep, const float_64 reducedCount)
+    {
         if (writeToFile)
         {
-            if (picLog::log_level & picLog::CRITICAL::lvl)
-            {
-                log<picLog::CRITICAL > ("maximum number of  particles on a GPU : %d\n") % reducedValueMax;
-            }
-
+            const uint64_cu reducedValue = static_cast<uint64_cu>(reducedCount);
             outFile << currentStep << " " << reducedValue << " " << std::scientific << (float_64) reducedValue << std::endl;
         }
     }
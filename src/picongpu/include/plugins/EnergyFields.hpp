@@ -37,14 +37,13 @@
 #include "dimensions/DataSpaceOperations.hpp"
 #include "plugins/ISimulationPlugin.hpp"
 
-#include "mpi/reduceMethods/Reduce.hpp"
-#include "mpi/MPIReduce.hpp"
 #include "nvidia/functors/Add.hpp"
 #include "nvidia/reduce/Reduce.hpp"
 #include "memory/boxes/DataBoxDim1Access.hpp"
 #include "memory/boxes/DataBoxUnaryTransform.hpp"
 
 #include "common/txtFileHandling.hpp"
+#include "plugins/common/ReductionService.hpp"
 
 namespace picongpu
 {
@@ -95,7 +94,7 @@ private:
     /*only rank 0 create a file*/
     bool writeToFile;
 
-    mpi::MPIReduce mpiReduce;
+    ReductionService::QuantityId quantityId;
 
     nvidia::reduce::Reduce* localReduce;
 
@@ -155,7 +154,26 @@ private:
         if (notifyFrequency > 0)
         {
             localReduce = new nvidia::reduce::Reduce(1024);
-            writeToFile = mpiReduce.hasResult(mpi::reduceMethods::Reduce());
+
+            ReductionService& reductionService = ReductionService::getInstance();
+            writeToFile = reductionService.hasResult();
+
+            std::vector<std::string> columns;
+            columns.push_back("Bx[Joule]");
+            columns.push_back("By[Joule]");
+            columns.push_back("Bz[Joule]");
+            columns.push_back("Ex[Joule]");
+            columns.push_back("Ey[Joule]");
+            columns.push_back("Ez[Joule]");
+            quantityId = reductionService.registerQuantity(
+                analyzerPrefix,
+                columns,
+                NotificationSchedule(notifyFrequency),
+                ReductionService::sum,
+                [this](uint32_t currentStep, const float_64* energy)
+                {
+                    this->writeEnergyFields(currentStep, energy);
+                });
 
             if (writeToFile)
             {
@@ -176,6 +194,9 @@ private:
     {
         if (notifyFrequency > 0)
         {
+            /* write the results of the last reduction */
+            ReductionService::getInstance().unregisterQuantity(quantityId);
+
             if (writeToFile)
             {
                 outFile.flush();
@@ -215,33 +236,41 @@ private:
         /* idx == 0 -> fieldB
          * idx == 1 -> fieldE
          */
-        EneVectorType globalFieldEnergy[2];
-        globalFieldEnergy[0]=EneVectorType::create(0.0);
-        globalFieldEnergy[1]=EneVectorType::create(0.0);
-
         EneVectorType localReducedFieldEnergy[2];
         localReducedFieldEnergy[0] = reduceField(fieldB);
         localReducedFieldEnergy[1] = reduceField(fieldE);
 
-        mpiReduce(nvidia::functors::Add(),
-                  &globalFieldEnergy,
-                  &localReducedFieldEnergy,
-                  2,
-                  mpi::reduceMethods::Reduce());
+        /* energy components in Joule, added over all GPUs by the reduction service */
+        float_64 localFieldEnergy[2 * FieldB::numComponents];
+        for(int d=0; d<FieldB::numComponents; ++d)
+        {
+            /* B field convert */
+            localFieldEnergy[d] = localReducedFieldEnergy[0][d] *
+                float_64(0.5 / MUE0 * CELL_VOLUME) * UNIT_ENERGY;
+            /* E field convert */
+            localFieldEnergy[FieldB::numComponents + d] = localReducedFieldEnergy[1][d] *
+                float_64(EPS0 * CELL_VOLUME * 0.5) * UNIT_ENERGY;
+        }
+
+        ReductionService::getInstance().contribute(quantityId, currentStep, localFieldEnergy);
+    }
 
+    /** write the energy of both fields to file
+     *
+     * called by the reduction service on the rank with writeToFile == true
+     *
+     * @param globalFieldEnergy B components followed by E components in Joule
+     */
+    void writeEnergyFields(uint32_t currentStep, const float_64* globalFieldEnergy)
+    {
         float_64 energyFieldBReduced=0.0;
         float_64 energyFieldEReduced=0.0;
 
         for(int d=0; d<FieldB::numComponents; ++d)
         {
-            /* B field convert */
-            globalFieldEnergy[0][d] *= float_64(0.5 / MUE0 * CELL_VOLUME);
-            /* E field convert */
-            globalFieldEnergy[1][d] *= float_64(EPS0 * CELL_VOLUME * 0.5);
-
             /* add all to one */
-            energyFieldBReduced+= globalFieldEnergy[0][d];
-            energyFieldEReduced+= globalFieldEnergy[1][d];
+            energyFieldBReduced+= globalFieldEnergy[d];
+            energyFieldEReduced+= globalFieldEnergy[FieldB::numComponents + d];
         }
 
         float_64 globalEnergy = energyFieldEReduced + energyFieldBReduced;
@@ -252,9 +281,10 @@ private:
             typedef std::numeric_limits< float_64 > dbl;
 
             outFile.precision(dbl::digits10);
-            outFile << currentStep << " " << std::scientific << globalEnergy * UNIT_ENERGY << " "
-                    << (globalFieldEnergy[0] * UNIT_ENERGY).toString(" ","") << " "
-                    << (globalFieldEnergy[1] * UNIT_ENERGY).toString(" ","") << std::endl;
+            outFile << currentStep << " " << std::scientific << globalEnergy;
+            for(int d=0; d<2 * FieldB::numComponents; ++d)
+                outFile << " " << globalFieldEnergy[d];
+            outFile << std::endl;
         }
     }
 
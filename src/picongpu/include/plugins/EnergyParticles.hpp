@@ -35,14 +35,11 @@
 #include "mappings/kernel/AreaMapping.hpp"
 #include "plugins/ISimulationPlugin.hpp"
 
-#include "mpi/reduceMethods/Reduce.hpp"
-#include "mpi/MPIReduce.hpp"
-#include "nvidia/functors/Add.hpp"
-
 #include "algorithms/KinEnergy.hpp"
 #include "memory/shared/Allocate.hpp"
 
 #include "common/txtFileHandling.hpp"
+#include "plugins/common/ReductionService.hpp"
 
 namespace picongpu
 {
@@ -162,7 +159,7 @@ private:
     std::ofstream outFile; /* file output stream */
     bool writeToFile;   /* only rank 0 creates a file */
 
-    mpi::MPIReduce reduce; /* MPI reduce to add all energies over several GPUs */
+    ReductionService::QuantityId quantityId; /* energies in the shared reduction over all GPUs */
 
 public:
 
@@ -226,8 +223,23 @@ private:
     {
         if (notifyFrequency > 0) /* only if plugin is called at least once */
         {
+            ReductionService& reductionService = ReductionService::getInstance();
+
             /* decide which MPI-rank writes output: */
-            writeToFile = reduce.hasResult(mpi::reduceMethods::Reduce());
+            writeToFile = reductionService.hasResult();
+
+            std::vector<std::string> columns;
+            columns.push_back("Ekin_Joule");
+            columns.push_back("E_Joule");
+            quantityId = reductionService.registerQuantity(
+                analyzerPrefix,
+                columns,
+                NotificationSchedule(notifyFrequency),
+                ReductionService::sum,
+                [this](uint32_t currentStep, const float_64* energy)
+                {
+                    this->writeEnergy(currentStep, energy);
+                });
 
             /* create two ints on gpu and host: */
             gEnergy = new GridBuffer<float_64, DIM1 > (DataSpace<DIM1 > (2));
@@ -259,6 +271,9 @@ private:
     {
         if (notifyFrequency > 0) /* only if plugin is called at least once */
         {
+            /* write the results of the last reduction */
+            ReductionService::getInstance().unregisterQuantity(quantityId);
+
             if (writeToFile)
             {
                 outFile.flush();
@@ -313,16 +328,20 @@ private:
 
         gEnergy->deviceToHost(); /* get energy from GPU */
 
-        float_64 reducedEnergy[2]; /* create storage for kinetic and total energy */
+        /* energies in Joule, added over all GPUs by the reduction service */
+        float_64 localEnergy[2];
+        for (int i = 0; i < 2; ++i)
+            localEnergy[i] = gEnergy->getHostBuffer().getDataBox()[i] * UNIT_ENERGY;
 
-        /* add energies from all GPUs using MPI: */
-        reduce(nvidia::functors::Add(),
-               reducedEnergy,
-               gEnergy->getHostBuffer().getBasePointer(),
-               2,
-               mpi::reduceMethods::Reduce());
+        ReductionService::getInstance().contribute(quantityId, currentStep, localEnergy);
+    }
 
-        /* print timestep, kinetic energy and total energy to file: */
+    /** print timestep, kinetic energy and total energy to file
+     *
+     * called by the reduction service on the rank with writeToFile == true
+     */
+    void writeEnergy(uint32_t currentStep, const float_64* reducedEnergy)
+    {
         if (writeToFile)
         {
             typedef std::numeric_limits< float_64 > dbl;
@@ -330,8 +349,8 @@ private:
             outFile.precision(dbl::digits10);
             outFile << currentStep << " "
                     << std::scientific
-                    << reducedEnergy[0] * UNIT_ENERGY << " "
-                    << reducedEnergy[1] * UNIT_ENERGY << std::endl;
+                    << reducedEnergy[0] << " "
+                    << reducedEnergy[1] << std::endl;
         }
     }
 
@@ -29,6 +29,7 @@
 #include "simulation_types.hpp"
 #include "assert.hpp"
 
+#include "plugins/common/ReductionService.hpp"
 #include "plugins/CountParticles.hpp"
 #include "plugins/EnergyParticles.hpp"
 #include "plugins/EnergyFields.hpp"
@@ -206,6 +207,10 @@ private:
      */
     virtual void init()
     {
+        /* the shared reduction must be loaded and checkpointed before
+         * the plugins using it */
+        ReductionService::getInstance();
+
         ForEach<AllPlugins, PushBack<bmpl::_1> > pushBack;
         pushBack(forward(plugins));
     }
@@ -71,16 +71,11 @@ namespace picongpu
 
         void pluginRegisterHelp(po::options_description& desc)
         {
-#if( PIC_ENABLE_PNG == 1 )
             desc.add_options()
                     ((analyzerPrefix + ".period").c_str(), po::value<std::vector<uint32_t> > (&notifyFrequencys)->multitoken(), "enable data output [for each n-th step]")
                     ((analyzerPrefix + ".axis").c_str(), po::value<std::vector<std::string > > (&axis)->multitoken(), "axis which are shown [valid values x,y,z] example: yz")
                     ((analyzerPrefix + ".slicePoint").c_str(), po::value<std::vector<float_32> > (&slicePoints)->multitoken(), "value range: 0 <= x <= 1 , point of the slice")
                     ((analyzerPrefix + ".folder").c_str(), po::value<std::vector<std::string> > (&folders)->multitoken(), "folder for output files");
-#else
-            desc.add_options()
-                    ((analyzerPrefix).c_str(), "plugin disabled [compiled without dependency PNGwriter]");
-#endif
         }
 
         void setMappingDescription(MappingDesc *cellDescription)
@@ -34,6 +34,7 @@
 #include "dimensions/DataSpaceOperations.hpp"
 #include "plugins/ILightweightPlugin.hpp"
 #include "memory/shared/Allocate.hpp"
+#include "plugins/common/ReductionService.hpp"
 
 namespace picongpu
 {
@@ -93,6 +94,9 @@ private:
 
     GridBuffer<float3_X, DIM1> *sumcurrents;
 
+    /* current summed over all GPUs */
+    ReductionService::QuantityId quantityId;
+
 public:
 
     SumCurrents() :
@@ -116,7 +120,6 @@ public:
         fieldJ = &(dc.getData<FieldJ > (FieldJ::getName(), true));
 
 
-        const int rank = Environment<simDim>::get().GridController().getGlobalRank();
         const float3_X gCurrent = getSumCurrents();
 
         // gCurrent is just j
@@ -132,19 +135,12 @@ public:
                                    gCurrent.y() * CELL_WIDTH,
                                    gCurrent.z() * CELL_WIDTH * CELL_HEIGHT);
 #endif
-        float3_64 realCurrent_SI(
+        const float_64 realCurrent_SI[3] = {
                                  float_64(realCurrent.x()) * (UNIT_CHARGE / UNIT_TIME),
                                  float_64(realCurrent.y()) * (UNIT_CHARGE / UNIT_TIME),
-                                 float_64(realCurrent.z()) * (UNIT_CHARGE / UNIT_TIME));
+                                 float_64(realCurrent.z()) * (UNIT_CHARGE / UNIT_TIME)};
 
-        /*FORMAT OUTPUT*/
-        typedef std::numeric_limits< float_64 > dbl;
-
-        std::cout.precision(dbl::digits10);
-        if (math::abs(gCurrent.x()) + math::abs(gCurrent.y()) + math::abs(gCurrent.z()) != float_X(0.0))
-            std::cout << "[ANALYSIS] [" << rank << "] [COUNTER] [SumCurrents] [" << currentStep
-            << std::scientific << "] " <<
-            realCurrent_SI << " Abs:" << math::abs(realCurrent_SI) << std::endl;
+        ReductionService::getInstance().contribute(quantityId, currentStep, realCurrent_SI);
     }
 
     void pluginRegisterHelp(po::options_description& desc)
@@ -171,6 +167,17 @@ private:
         {
             sumcurrents = new GridBuffer<float3_X, DIM1 > (DataSpace<DIM1 > (1)); //create one int on gpu und host
 
+            std::vector<std::string> columns;
+            columns.push_back("Ix[A]");
+            columns.push_back("Iy[A]");
+            columns.push_back("Iz[A]");
+            quantityId = ReductionService::getInstance().registerQuantity(
+                "sumcurr",
+                columns,
+                NotificationSchedule(notifyFrequency),
+                ReductionService::sum,
+                &SumCurrents::printSumCurrents);
+
             Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyFrequency);
         }
     }
@@ -179,10 +186,30 @@ private:
     {
         if (notifyFrequency > 0)
         {
+            /* print the results of the last reduction */
+            ReductionService::getInstance().unregisterQuantity(quantityId);
             __delete(sumcurrents);
         }
     }
 
+    /** print the current summed over all GPUs
+     *
+     * called by the reduction service on the root rank
+     */
+    static void printSumCurrents(uint32_t currentStep, const float_64* current)
+    {
+        const float3_64 realCurrent_SI(current[0], current[1], current[2]);
+
+        /*FORMAT OUTPUT*/
+        typedef std::numeric_limits< float_64 > dbl;
+
+        std::cout.precision(dbl::digits10);
+        if (math::abs(realCurrent_SI.x()) + math::abs(realCurrent_SI.y()) + math::abs(realCurrent_SI.z()) != float_64(0.0))
+            std::cout << "[ANALYSIS] [COUNTER] [SumCurrents] [" << currentStep
+            << std::scientific << "] " <<
+            realCurrent_SI << " Abs:" << math::abs(realCurrent_SI) << std::endl;
+    }
+
     float3_X getSumCurrents()
     {
         sumcurrents->getDeviceBuffer().setValue(float3_X::create(0.0));
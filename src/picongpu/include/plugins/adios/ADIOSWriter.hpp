@@ -529,7 +529,7 @@ public:
     restartFilename(""), /* set to checkpointFilename by default */
     /* select MPI method, #OSTs and #aggregators */
     mpiTransportParams(""),
-    notifyPeriod(0),
+    notifyPeriod("0"),
     lastSpeciesSyncStep(PMacc::traits::limits::Max<uint32_t>::value)
     {
         Environment<>::get().PluginConnector().registerPlugin(this);
@@ -543,8 +543,8 @@ public:
     void pluginRegisterHelp(po::options_description& desc)
     {
         desc.add_options()
-            ("adios.period", po::value<uint32_t > (&notifyPeriod)->default_value(0),
-             "enable ADIOS IO [for each n-th step]")
+            ("adios.period", po::value<std::string > (&notifyPeriod)->default_value(notifyPeriod),
+             "enable ADIOS IO [for each n-th step or `start:end:period,...`]")
             ("adios.aggregators", po::value<uint32_t >
              (&mThreadParams.adiosAggregators)->default_value(0), "Number of aggregators [0 == number of MPI processes]")
             ("adios.ost", po::value<uint32_t > (&mThreadParams.adiosOST)->default_value(1),
@@ -715,6 +715,8 @@ public:
         /* load all particles */
         ForEach<FileCheckpointParticles, LoadSpecies<bmpl::_1> > forEachLoadSpecies;
         forEachLoadSpecies(&mThreadParams, restartChunkSize);
+        /* the restart buffers are not reused */
+        PinnedMemoryPool::getInstance().releaseUnused();
 
         IdProvider<simDim>::State idProvState;
         ReadNDScalars<uint64_t, uint64_t>()(mThreadParams,
@@ -813,19 +815,16 @@ private:
         /* copy species only one time per timestep to the host */
         if( lastSpeciesSyncStep != currentStep )
         {
-            DataConnector &dc = Environment<>::get().DataConnector();
-
-            /* synchronizes the MallocMCBuffer to the host side */
-            dc.getData<MallocMCBuffer> (MallocMCBuffer::getName());
-
             /* here we are copying all species to the host side since we
              * can not say at this point if this time step will need all of them
              * for sure (checkpoint) or just some user-defined species (dump)
+             *
+             * the frames in the MallocMCBuffer are downloaded per species
+             * by WriteSpecies
              */
             ForEach<FileCheckpointParticles, CopySpeciesToHost<bmpl::_1> > copySpeciesToHost;
             copySpeciesToHost();
             lastSpeciesSyncStep = currentStep;
-            dc.releaseData(MallocMCBuffer::getName());
         }
 
         beginAdios(mThreadParams.adiosFilename);
@@ -850,7 +849,7 @@ private:
         if( mThreadParams.adiosAggregators == 0 )
            mThreadParams.adiosAggregators=mpi_size.productOfComponents();
 
-        if (notifyPeriod > 0)
+        if (!NotificationSchedule(notifyPeriod).empty())
         {
             Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyPeriod);
 
@@ -887,7 +886,7 @@ private:
 
     void pluginUnload()
     {
-        if (notifyPeriod > 0)
+        if (!NotificationSchedule(notifyPeriod).empty())
         {
             if (mThreadParams.adiosComm != MPI_COMM_NULL)
             {
@@ -1125,7 +1124,7 @@ private:
 
     MappingDesc *cellDescription;
 
-    uint32_t notifyPeriod;
+    std::string notifyPeriod;
     std::string filename;
     std::string checkpointFilename;
     std::string restartFilename;
@@ -128,6 +128,8 @@ public:
 
             DataConnector &dc = Environment<>::get().DataConnector();
             MallocMCBuffer& mallocMCBuffer = dc.getData<MallocMCBuffer> (MallocMCBuffer::getName(),true);
+            /* download only the frames of this species */
+            mallocMCBuffer.synchronizeFrames<CORE + BORDER>(*speciesTmp, *(params->cellDescription));
 
             int globalParticleOffset = 0;
             AreaMapping < CORE + BORDER, MappingDesc > mapper(*(params->cellDescription));
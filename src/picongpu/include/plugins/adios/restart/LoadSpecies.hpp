@@ -43,6 +43,9 @@
 #include "plugins/output/WriteSpeciesCommon.hpp"
 #include "plugins/adios/restart/LoadParticleAttributesFromADIOS.hpp"
 
+#include <sstream>
+#include <stdexcept>
+
 namespace picongpu
 {
 
@@ -109,13 +112,30 @@ public:
            particlesInfo is (part-count, scalar pos, x, y, z) */
         uint64_t particlesInfo[5];
 
+        /* the table only holds GPU positions and no cell offsets, particles
+         * can not be assigned to a different domain decomposition */
+        const std::string particlesInfoName( particlePath + std::string("particles_info") );
+        ADIOS_VARINFO* varInfo = adios_inq_var( params->fp, particlesInfoName.c_str() );
+        if( varInfo == NULL )
+            throw std::runtime_error( std::string("ADIOS: can not read ") + particlesInfoName );
+        const uint64_t numCheckpointRanks = varInfo->dims[0] / 5;
+        adios_free_varinfo( varInfo );
+        if( numCheckpointRanks != gc.getGlobalSize() )
+        {
+            std::stringstream msg;
+            msg << "ADIOS: checkpoint was written by " << numCheckpointRanks
+                << " ranks, a restart with " << gc.getGlobalSize()
+                << " ranks is only supported by the HDF5 plugin";
+            throw std::runtime_error( msg.str() );
+        }
+
         uint64_t start = 5 * gc.getGlobalRank();
         uint64_t count = 5; // ADIOSCountParticles: uint64_t
         ADIOS_SELECTION* piSel = adios_selection_boundingbox( 1, &start, &count );
 
         ADIOS_CMD(adios_schedule_read( params->fp,
                                        piSel,
-                                       (particlePath + std::string("particles_info")).c_str(),
+                                       particlesInfoName.c_str(),
                                        0,
                                        1,
                                        (void*)particlesInfo ));
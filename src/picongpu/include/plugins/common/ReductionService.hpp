@@ -0,0 +1,425 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "simulation_defines.hpp"
+#include "plugins/ISimulationPlugin.hpp"
+#include "pluginSystem/NotificationSchedule.hpp"
+#include "plugins/common/txtFileHandling.hpp"
+
+#include <mpi.h>
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace picongpu
+{
+using namespace PMacc;
+
+/** shared global reduction of scalar and histogram quantities
+ *
+ * Plugins register their quantities once (collective, same order on all
+ * ranks) and contribute the local values of each step. As soon as all
+ * quantities which are due in a step have contributed, the values of all
+ * quantities are packed and reduced with one non-blocking `MPI_Ireduce`
+ * per operation (blocking `MPI_Reduce` without MPI-3). The reduction is
+ * completed lazily with the next contribution, a checkpoint or flush(), so
+ * the collective overlaps with the simulation.
+ *
+ * On the root rank the result of each quantity is passed to the callback
+ * of the registering plugin and all quantities are written as one row to
+ * the columnar output file `reductions.dat` (`nan` for quantities which
+ * were not due).
+ *
+ * Rows are therefore written one period late: the row of step `n` is
+ * written (and the callbacks are called) when the next values are
+ * contributed. Each row carries its own step. Plugins must call
+ * unregisterQuantity() (or flush()) in pluginUnload() before they close
+ * their files, otherwise the last period is lost.
+ *
+ * Singleton class, registers itself as plugin to take part in
+ * checkpoint/restart. It must be created before the plugins using it are
+ * registered (see PluginController) to be loaded and checkpointed first.
+ */
+class ReductionService : public ISimulationPlugin
+{
+public:
+
+    /** reduction operation of a quantity */
+    enum Operation
+    {
+        sum = 0, max = 1
+    };
+
+    /** called on the root rank with the reduced values of a quantity
+     *
+     * @param currentStep step of the contributed values
+     * @param values reduced values, one per column
+     */
+    typedef std::function<void (uint32_t, const float_64*)> ResultCallback;
+
+    typedef size_t QuantityId;
+
+    static ReductionService& getInstance()
+    {
+        static ReductionService instance;
+        return instance;
+    }
+
+    /** register a quantity
+     *
+     * Must be called by all ranks in the same order.
+     *
+     * @param name prefix of the columns in the output file
+     * @param columns name of each value of the quantity
+     * @param schedule steps at which the quantity contributes
+     * @param op reduction operation
+     * @param callback result handler on the root rank (can be empty)
+     * @return id to contribute values
+     */
+    QuantityId registerQuantity(const std::string& name,
+                                const std::vector<std::string>& columns,
+                                const NotificationSchedule& schedule,
+                                const Operation op,
+                                const ResultCallback& callback = ResultCallback())
+    {
+        Quantity quantity;
+        quantity.name = name;
+        quantity.columns = columns;
+        quantity.schedule = schedule;
+        quantity.op = op;
+        quantity.callback = callback;
+        quantity.isActive = true;
+        quantity.hasContributed = false;
+        quantity.localValues.resize(columns.size(), float_64(0.0));
+        quantities.push_back(quantity);
+
+        return quantities.size() - 1;
+    }
+
+    /** remove a quantity
+     *
+     * Delivers pending results first, afterwards the callback of the
+     * quantity is never called again. Must be called by all ranks.
+     */
+    void unregisterQuantity(const QuantityId id)
+    {
+        flush();
+        quantities.at(id).isActive = false;
+    }
+
+    /** reduce all contributed values and deliver all pending results
+     *
+     * Must be called by all ranks.
+     */
+    void flush()
+    {
+        startReduction();
+        finishReduction();
+    }
+
+    /** contribute the local values of a quantity
+     *
+     * @param id quantity id from registerQuantity()
+     * @param currentStep current simulation step
+     * @param values one value per column
+     */
+    void contribute(const QuantityId id, const uint32_t currentStep, const float_64* values)
+    {
+        Quantity& quantity = quantities.at(id);
+        if (!quantity.isActive)
+            throw std::runtime_error("ReductionService: contribution to an unregistered quantity " + quantity.name);
+
+        /* a quantity due in the collected step did not contribute, reduce what we have */
+        if (isCollecting && collectStep != currentStep)
+            startReduction();
+
+        if (!isCollecting)
+        {
+            /* results of the last step are delivered before new values are packed */
+            finishReduction();
+            collectStep = currentStep;
+            isCollecting = true;
+        }
+
+        std::copy(values, values + quantity.columns.size(), quantity.localValues.begin());
+        quantity.hasContributed = true;
+
+        for (size_t i = 0; i < quantities.size(); ++i)
+        {
+            const Quantity& other = quantities[i];
+            if (other.isActive && !other.hasContributed && other.schedule.isDue(currentStep))
+                return;
+        }
+        startReduction();
+    }
+
+    /** true if this rank receives the reduced results */
+    bool hasResult() const
+    {
+        return mpiRank == root;
+    }
+
+    void notify(uint32_t)
+    {
+    }
+
+    void pluginRegisterHelp(po::options_description&)
+    {
+    }
+
+    std::string pluginGetName() const
+    {
+        return "ReductionService";
+    }
+
+    void setMappingDescription(MappingDesc*)
+    {
+    }
+
+    void checkpoint(uint32_t currentStep, const std::string checkpointDirectory)
+    {
+        flush();
+
+        if (!outFile.is_open())
+            return;
+
+        checkpointTxtFile(outFile,
+                          filename,
+                          currentStep,
+                          checkpointDirectory);
+    }
+
+    void restart(uint32_t restartStep, const std::string restartDirectory)
+    {
+        if (!hasResult())
+            return;
+
+        if (!restoreTxtFile(outFile,
+                            filename,
+                            restartStep,
+                            restartDirectory))
+            throw std::runtime_error("ReductionService: can not restore " + filename);
+    }
+
+private:
+
+    struct Quantity
+    {
+        std::string name;
+        std::vector<std::string> columns;
+        NotificationSchedule schedule;
+        Operation op;
+        ResultCallback callback;
+        bool isActive;
+        bool hasContributed;
+        std::vector<float_64> localValues;
+    };
+
+    /** position of a quantity in the packed buffers */
+    struct PackedQuantity
+    {
+        QuantityId id;
+        Operation op;
+        size_t offset;
+    };
+
+    static constexpr int numOperations = 2;
+    static constexpr int root = 0;
+
+    ReductionService() :
+        filename("reductions.dat"),
+        isCollecting(false),
+        collectStep(0),
+        isPending(false),
+        pendingStep(0),
+        comm(MPI_COMM_NULL),
+        mpiRank(0)
+    {
+        for (int op = 0; op < numOperations; ++op)
+            requests[op] = MPI_REQUEST_NULL;
+
+        Environment<>::get().PluginConnector().registerPlugin(this);
+    }
+
+    ReductionService(const ReductionService&);
+    ReductionService& operator=(const ReductionService&);
+
+    void pluginLoad()
+    {
+        comm = Environment<simDim>::get().GridController().getCommunicator().getMPIComm();
+        MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
+    }
+
+    void pluginUnload()
+    {
+        flush();
+
+        if (outFile.is_open())
+        {
+            outFile.flush();
+            if (outFile.fail())
+                std::cerr << "Error on flushing file [" << filename << "]. " << std::endl;
+            outFile.close();
+        }
+    }
+
+    /** pack all contributed values and start the reduction */
+    void startReduction()
+    {
+        if (!isCollecting)
+            return;
+
+        finishReduction();
+
+        packedQuantities.clear();
+        for (int op = 0; op < numOperations; ++op)
+            sendBuffer[op].clear();
+
+        for (size_t i = 0; i < quantities.size(); ++i)
+        {
+            Quantity& quantity = quantities[i];
+            if (!quantity.hasContributed)
+                continue;
+
+            PackedQuantity packed;
+            packed.id = i;
+            packed.op = quantity.op;
+            packed.offset = sendBuffer[quantity.op].size();
+            packedQuantities.push_back(packed);
+
+            sendBuffer[quantity.op].insert(sendBuffer[quantity.op].end(),
+                                           quantity.localValues.begin(),
+                                           quantity.localValues.end());
+            quantity.hasContributed = false;
+        }
+
+        const MPI_Op mpiOps[numOperations] = {MPI_SUM, MPI_MAX};
+        for (int op = 0; op < numOperations; ++op)
+        {
+            const int count = static_cast<int>(sendBuffer[op].size());
+            if (count == 0)
+                continue;
+            resultBuffer[op].resize(count);
+#if (MPI_VERSION >= 3)
+            MPI_CHECK(MPI_Ireduce(&(sendBuffer[op][0]), &(resultBuffer[op][0]), count,
+                                  MPI_DOUBLE, mpiOps[op], root, comm, &requests[op]));
+#else
+            /* the null request completes immediately in finishReduction() */
+            MPI_CHECK(MPI_Reduce(&(sendBuffer[op][0]), &(resultBuffer[op][0]), count,
+                                 MPI_DOUBLE, mpiOps[op], root, comm));
+            requests[op] = MPI_REQUEST_NULL;
+#endif
+        }
+
+        isCollecting = false;
+        isPending = true;
+        pendingStep = collectStep;
+    }
+
+    /** wait for the running reduction and deliver the results */
+    void finishReduction()
+    {
+        if (!isPending)
+            return;
+
+        MPI_CHECK(MPI_Waitall(numOperations, requests, MPI_STATUSES_IGNORE));
+        isPending = false;
+
+        if (!hasResult())
+            return;
+
+        std::vector<const float_64*> results(quantities.size(), NULL);
+        for (size_t i = 0; i < packedQuantities.size(); ++i)
+        {
+            const PackedQuantity& packed = packedQuantities[i];
+            results[packed.id] = &(resultBuffer[packed.op][packed.offset]);
+
+            const Quantity& quantity = quantities[packed.id];
+            if (quantity.isActive && quantity.callback)
+                quantity.callback(pendingStep, results[packed.id]);
+        }
+
+        writeRow(results);
+    }
+
+    /** append the results of the pending step to the columnar file */
+    void writeRow(const std::vector<const float_64*>& results)
+    {
+        if (!outFile.is_open())
+        {
+            outFile.open(filename.c_str(), std::ofstream::out | std::ostream::trunc);
+            if (!outFile)
+            {
+                std::cerr << "Can't open file [" << filename << "] for output, disable reduction output. " << std::endl;
+                return;
+            }
+
+            outFile << "#step";
+            for (size_t i = 0; i < quantities.size(); ++i)
+                for (size_t c = 0; c < quantities[i].columns.size(); ++c)
+                    outFile << " " << quantities[i].name << "." << quantities[i].columns[c];
+            outFile << std::endl;
+        }
+
+        typedef std::numeric_limits< float_64 > dbl;
+
+        outFile.precision(dbl::digits10);
+        outFile << pendingStep << std::scientific;
+        for (size_t i = 0; i < quantities.size(); ++i)
+            for (size_t c = 0; c < quantities[i].columns.size(); ++c)
+            {
+                if (results[i] != NULL)
+                    outFile << " " << results[i][c];
+                else
+                    outFile << " nan";
+            }
+        /* endl: flush each step, the data survives a crash */
+        outFile << std::endl;
+    }
+
+    std::vector<Quantity> quantities;
+
+    std::string filename;
+    std::ofstream outFile;
+
+    /** true if values of `collectStep` were contributed but not reduced */
+    bool isCollecting;
+    uint32_t collectStep;
+
+    /** true if the reduction of `pendingStep` is running */
+    bool isPending;
+    uint32_t pendingStep;
+    std::vector<PackedQuantity> packedQuantities;
+    std::vector<float_64> sendBuffer[numOperations];
+    std::vector<float_64> resultBuffer[numOperations];
+    MPI_Request requests[numOperations];
+
+    MPI_Comm comm;
+    int mpiRank;
+};
+
+} // namespace picongpu
@@ -93,9 +93,47 @@ namespace openPMD
          */
         size_t size() const;
 
+        /** Sort the patches by their offset for findOverlapping()
+         *
+         * Must be called again after the patches changed.
+         *
+         * @param dimensionality number of used offset/extent components
+         */
+        void buildIndex( const uint32_t dimensionality );
+
+        /** Find all patches which overlap with a box of cells
+         *
+         * A patch with exactly the offset and extent of the box is found
+         * by a binary search, otherwise only the patches in the range of
+         * the slowest varying component are compared.
+         *
+         * @param offset begin of the box, `dimensionality` components
+         * @param extent size of the box, `dimensionality` components
+         * @return ascending ids of the overlapping patches
+         */
+        std::vector<size_t> findOverlapping(
+            const uint64_t* const offset,
+            const uint64_t* const extent
+        ) const;
+
         /** Helper function printing to std::cout
          */
         void print();
+
+    private:
+        /** patch ids, sorted lexicographically by offset with the slowest
+         *  varying component first */
+        std::vector<size_t> sortedIds;
+        /** dimensionality used to build sortedIds */
+        uint32_t indexDim;
+        /** largest extent in the slowest varying component */
+        uint64_t maxOuterExtent;
+
+        const std::vector<uint64_t>& offsetComp( const uint32_t comp ) const;
+        const std::vector<uint64_t>& extentComp( const uint32_t comp ) const;
+
+        /** lexicographic compare of the offset of a patch with `offset` */
+        int compareOffset( const size_t id, const uint64_t* const offset ) const;
     };
 
 } // namespace openPMD
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <pthread.h>
+#include <atomic>
+#include <exception>
 #include <sstream>
 #include <string>
 #include <list>
@@ -45,6 +47,7 @@
 #include "particles/particleFilter/PositionFilter.hpp"
 #include "particles/operations/CountParticles.hpp"
 #include "particles/IdProvider.def"
+#include "algorithms/reverseBits.hpp"
 
 #include "dataManagement/DataConnector.hpp"
 #include "mappings/simulation/GridController.hpp"
@@ -64,6 +67,7 @@
 #include <boost/mpl/find.hpp>
 
 #include <boost/type_traits.hpp>
+#include <boost/thread.hpp>
 
 #include "plugins/hdf5/WriteMeta.hpp"
 #include "plugins/hdf5/WriteFields.hpp"
@@ -99,7 +103,11 @@ public:
     outputDirectory("h5"),
     checkpointFilename("checkpoint"),
     restartFilename(""), /* set to checkpointFilename by default */
-    notifyPeriod(0)
+    notifyPeriod("0"),
+    compression(false),
+    checkpointBackground(false),
+    writerComm(MPI_COMM_NULL),
+    writerFinished(true)
     {
         Environment<>::get().PluginConnector().registerPlugin(this);
     }
@@ -112,8 +120,8 @@ public:
     void pluginRegisterHelp(po::options_description& desc)
     {
         desc.add_options()
-            ("hdf5.period", po::value<uint32_t > (&notifyPeriod)->default_value(0),
-             "enable HDF5 IO [for each n-th step]")
+            ("hdf5.period", po::value<std::string > (&notifyPeriod)->default_value(notifyPeriod),
+             "enable HDF5 IO [for each n-th step or `start:end:period,...`]")
             ("hdf5.file", po::value<std::string > (&filename)->default_value(filename),
              "HDF5 output filename (prefix)")
             ("hdf5.checkpoint-file", po::value<std::string > (&checkpointFilename),
@@ -126,7 +134,13 @@ public:
              * frame overflow in our memory manager if we process all particles in one kernel.
              **/
             ("hdf5.restart-chunkSize", po::value<uint32_t > (&restartChunkSize)->default_value(1000000),
-             "Number of particles processed in one kernel call during restart to prevent frame count blowup");
+             "Number of particles processed in one kernel call during restart to prevent frame count blowup")
+            ("hdf5.compression", po::bool_switch(&compression),
+             "Enable deflate compression of the chunked datasets (requires parallel filter support of HDF5)")
+            ("hdf5.checkpoint-background", po::bool_switch(&checkpointBackground),
+             "Copy checkpoints to host memory and write them from a background thread "
+             "(requires MPI_THREAD_MULTIPLE, see PIC_MPI_THREAD_MULTIPLE, "
+             "and no other plugin writing HDF5 files while a checkpoint is written)");
     }
 
     std::string pluginGetName() const
@@ -134,6 +148,15 @@ public:
         return "HDF5Writer";
     }
 
+    bool checkpointWritten(const bool wait)
+    {
+        if (!wait && !writerFinished)
+            return false;
+
+        waitForWriter();
+        return true;
+    }
+
     void setMappingDescription(MappingDesc *cellDescription)
     {
 
@@ -159,6 +182,10 @@ public:
 
     void restart(uint32_t restartStep, const std::string restartDirectory)
     {
+        waitForWriter();
+
+        /* particle numbers of dumps before the restart are meaningless */
+        mThreadParams.lastNumParticles.clear();
 #if(ENABLE_ADIOS == 1)
         log<picLog::INPUT_OUTPUT > ("HDF5: Restart skipped since ADIOS is enabled.");
 #else
@@ -183,6 +210,8 @@ public:
         {
             restartFilename = restartDirectory + std::string("/") + restartFilename;
         }
+        /* the particle patches are read by rank 0 from a file handle of its own */
+        mThreadParams.h5Filename = restartFilename;
 
         /* open datacollector */
         try
@@ -228,13 +257,48 @@ public:
         /* load all particles */
         ForEach<FileCheckpointParticles, LoadSpecies<bmpl::_1> > forEachLoadSpecies;
         forEachLoadSpecies(params, restartChunkSize);
+        /* the restart buffers are not reused */
+        PinnedMemoryPool::getInstance().releaseUnused();
+
+        /* the checkpoint can be written by a different grid of GPUs:
+         * the id range of a GPU is continued by the rank at the same position,
+         * ranks outside of the stored grid start a new range behind all
+         * ranges of the checkpoint
+         */
+        const Dimensions checkpointGpus = ReadNDScalars<uint64_t>::getGridSize(mThreadParams,
+                                                                               "picongpu/idProvider/startId");
+        bool isSameGrid = true;
+        bool isInCheckpoint = true;
+        Dimensions readOffset(0, 0, 0);
+        for (uint32_t d = 0; d < simDim; ++d)
+        {
+            isSameGrid = isSameGrid && uint64_t(gc.getGpuNodes()[d]) == checkpointGpus[d];
+            isInCheckpoint = isInCheckpoint && uint64_t(gc.getPosition()[d]) < checkpointGpus[d];
+            readOffset[d] = gc.getPosition()[d];
+        }
+        /* reads are collective, ranks outside read a valid position and drop the value */
+        if (!isInCheckpoint)
+            readOffset = Dimensions(0, 0, 0);
 
         IdProvider<simDim>::State idProvState;
-        ReadNDScalars<uint64_t, uint64_t>()(mThreadParams,
+        ReadNDScalars<uint64_t, uint64_t>().readAt(mThreadParams, readOffset,
                 "picongpu/idProvider/startId", &idProvState.startId,
                 "maxNumProc", &idProvState.maxNumProc);
-        ReadNDScalars<uint64_t>()(mThreadParams,
+        ReadNDScalars<uint64_t>().readAt(mThreadParams, readOffset,
                 "picongpu/idProvider/nextId", &idProvState.nextId);
+
+        if (!isSameGrid)
+        {
+            const uint64_t checkpointMaxNumProc = idProvState.maxNumProc;
+            if (!isInCheckpoint)
+            {
+                idProvState.startId = reverseBits(checkpointMaxNumProc + gc.getScalarPosition());
+                idProvState.nextId = idProvState.startId;
+            }
+            idProvState.maxNumProc = checkpointMaxNumProc + gc.getGpuNodes().productOfComponents();
+            log<picLog::INPUT_OUTPUT > ("HDF5: checkpoint was written by %1% GPUs, new maxNumProc for ids: %2%") %
+                checkpointGpus.toString() % idProvState.maxNumProc;
+        }
         log<picLog::INPUT_OUTPUT > ("Setting next free id on current rank: %1%") % idProvState.nextId;
         IdProvider<simDim>::setState(idProvState);
 
@@ -251,6 +315,43 @@ public:
 
 private:
 
+    /** join the background writer of the last checkpoint
+     *
+     * Errors of the background writer are rethrown.
+     */
+    void waitForWriter()
+    {
+        if (writerThread.joinable())
+            writerThread.join();
+
+        if (writerError)
+        {
+            std::exception_ptr error = writerError;
+            writerError = std::exception_ptr();
+            std::rethrow_exception(error);
+        }
+    }
+
+    /** execute the staged writes and close the file, runs in the background */
+    void writeStaged()
+    {
+        try
+        {
+            for (size_t i = 0; i < mThreadParams.stagedWrites.size(); ++i)
+                mThreadParams.stagedWrites[i]();
+            closeH5File();
+        }
+        catch (...)
+        {
+            writerError = std::current_exception();
+        }
+        /* free the host copies */
+        mThreadParams.stagedWrites.clear();
+        log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) background write of checkpoint %1%") %
+            mThreadParams.currentStep;
+        writerFinished = true;
+    }
+
     void closeH5File()
     {
         if (mThreadParams.dataCollector != NULL)
@@ -267,14 +368,14 @@ private:
         {
             GridController<simDim> &gc = Environment<simDim>::get().GridController();
             mThreadParams.dataCollector = new ParallelDomainCollector(
-                                                                      gc.getCommunicator().getMPIComm(),
+                                                                      writerComm,
                                                                       gc.getCommunicator().getMPIInfo(),
                                                                       splashMpiSize,
                                                                       maxOpenFilesPerNode);
         }
         // set attributes for datacollector files
         DataCollector::FileCreationAttr attr;
-        attr.enableCompression = false;
+        attr.enableCompression = compression;
         attr.fileAccType = DataCollector::FAT_CREATE;
         attr.mpiPosition.set(splashMpiPos);
         attr.mpiSize.set(splashMpiSize);
@@ -300,10 +401,15 @@ private:
      */
     void notificationReceived(uint32_t currentStep, bool isCheckpoint)
     {
+        /* the background writer uses mThreadParams and the data collector */
+        waitForWriter();
+
         const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
         mThreadParams.isCheckpoint = isCheckpoint;
+        mThreadParams.isStaged = isCheckpoint && checkpointBackground;
         mThreadParams.currentStep = currentStep;
         mThreadParams.cellDescription = this->cellDescription;
+        mThreadParams.numSlides = MovingWindow::getInstance().getSlideCounter(currentStep);
 
         __getTransactionEvent().waitForFinished();
 
@@ -342,12 +448,40 @@ private:
 
         writeHDF5((void*) &mThreadParams);
 
-        closeH5File();
+        if (mThreadParams.isStaged)
+        {
+            /* all data is on the host, the simulation can continue */
+            log<picLog::INPUT_OUTPUT > ("HDF5: (begin) background write of checkpoint %1%") % currentStep;
+            writerFinished = false;
+            writerThread = boost::thread(&HDF5Writer::writeStaged, this);
+        }
+        else
+            closeH5File();
     }
 
     void pluginLoad()
     {
+        mThreadParams.lastNumParticles.clear();
+
         GridController<simDim> &gc = Environment<simDim>::get().GridController();
+
+        /* the collective I/O can run in the background writer, apart from
+         * the collectives of the simulation */
+        MPI_CHECK(MPI_Comm_dup(gc.getCommunicator().getMPIComm(), &writerComm));
+
+        if (checkpointBackground)
+        {
+            int threadLevel = MPI_THREAD_SINGLE;
+            MPI_CHECK(MPI_Query_thread(&threadLevel));
+            if (threadLevel < MPI_THREAD_MULTIPLE)
+            {
+                if (gc.getGlobalRank() == 0)
+                    std::cerr << "Warning: MPI does not provide MPI_THREAD_MULTIPLE, "
+                        "HDF5 checkpoints are written without background thread "
+                        "(build with PIC_MPI_THREAD_MULTIPLE=ON)" << std::endl;
+                checkpointBackground = false;
+            }
+        }
         /* It is important that we never change the mpi_pos after this point
          * because we get problems with the restart.
          * Otherwise we do not know which gpu must load the ghost parts around
@@ -367,7 +501,7 @@ private:
 
 
         /* only register for notify callback when .period is set on command line */
-        if (notifyPeriod > 0)
+        if (!NotificationSchedule(notifyPeriod).empty())
         {
             Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyPeriod);
 
@@ -385,10 +519,15 @@ private:
 
     void pluginUnload()
     {
+        waitForWriter();
+
         if (mThreadParams.dataCollector)
             mThreadParams.dataCollector->finalize();
 
         __delete(mThreadParams.dataCollector);
+
+        if (writerComm != MPI_COMM_NULL)
+            MPI_CHECK(MPI_Comm_free(&writerComm));
     }
 
     static void *writeHDF5(void *p_args)
@@ -427,20 +566,25 @@ private:
             ForEach<FileOutputParticles, WriteSpecies<bmpl::_1> > writeSpecies;
             writeSpecies(threadParams, domainOffset);
         }
+        /* keep only the host memory which was needed by this dump */
+        PinnedMemoryPool::getInstance().trim();
         log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) writing particle species.");
 
         auto idProviderState = IdProvider<simDim>::getState();
-        log<picLog::INPUT_OUTPUT>("HDF5: Writing IdProvider state (StartId: %1%, NextId: %2%, maxNumProc: %3%)")
-                % idProviderState.startId % idProviderState.nextId % idProviderState.maxNumProc;
-        WriteNDScalars<uint64_t, uint64_t>()(*threadParams,
-                "picongpu/idProvider/startId", idProviderState.startId,
-                "maxNumProc", idProviderState.maxNumProc);
-        WriteNDScalars<uint64_t>()(*threadParams,
-                "picongpu/idProvider/nextId", idProviderState.nextId);
-
-        // write global meta attributes
-        WriteMeta writeMetaAttributes;
-        writeMetaAttributes(threadParams);
+        threadParams->scheduleWrite([=]()
+        {
+            log<picLog::INPUT_OUTPUT>("HDF5: Writing IdProvider state (StartId: %1%, NextId: %2%, maxNumProc: %3%)")
+                    % idProviderState.startId % idProviderState.nextId % idProviderState.maxNumProc;
+            WriteNDScalars<uint64_t, uint64_t>()(*threadParams,
+                    "picongpu/idProvider/startId", idProviderState.startId,
+                    "maxNumProc", idProviderState.maxNumProc);
+            WriteNDScalars<uint64_t>()(*threadParams,
+                    "picongpu/idProvider/nextId", idProviderState.nextId);
+
+            // write global meta attributes
+            WriteMeta writeMetaAttributes;
+            writeMetaAttributes(threadParams);
+        });
 
         return NULL;
     }
@@ -449,7 +593,7 @@ private:
 
     MappingDesc *cellDescription;
 
-    uint32_t notifyPeriod;
+    std::string notifyPeriod;
     int64_t lastCheckpoint;
     std::string filename;
     std::string checkpointFilename;
@@ -458,6 +602,19 @@ private:
     std::string checkpointDirectory;
 
     uint32_t restartChunkSize;
+    /** compress the datasets of dumps and checkpoints */
+    bool compression;
+
+    /** write checkpoints from a background thread */
+    bool checkpointBackground;
+    /** communicator of the data collector */
+    MPI_Comm writerComm;
+    /** background writer of the last checkpoint */
+    boost::thread writerThread;
+    /** background writer is done, polled by checkpointWritten() */
+    std::atomic<bool> writerFinished;
+    /** error of the background writer, rethrown by waitForWriter() */
+    std::exception_ptr writerError;
 
     DataSpace<simDim> mpi_pos;
     DataSpace<simDim> mpi_size;
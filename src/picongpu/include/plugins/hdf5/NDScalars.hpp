@@ -101,12 +101,24 @@ struct ReadNDScalars
                 const std::string& name, T_Scalar* value,
                 const std::string& attrName = "", T_Attribute* attribute = NULL)
     {
-        log<picLog::INPUT_OUTPUT>("HDF5: read %1%D scalars: %2%") % simDim % name;
-
         Dimensions domain_offset(0, 0, 0);
         for (uint32_t d = 0; d < simDim; ++d)
             domain_offset[d] = Environment<simDim>::get().GridController().getPosition()[d];
 
+        readAt(params, domain_offset, name, value, attrName, attribute);
+    }
+
+    /** read the scalar of the process at `domain_offset` in the stored grid
+     *
+     * Collective, all processes must take part even if the value is
+     * discarded.
+     */
+    void readAt(ThreadParams& params, const Dimensions& domain_offset,
+                const std::string& name, T_Scalar* value,
+                const std::string& attrName = "", T_Attribute* attribute = NULL)
+    {
+        log<picLog::INPUT_OUTPUT>("HDF5: read %1%D scalars: %2%") % simDim % name;
+
         DomainCollector::DomDataClass data_class;
         DataContainer *dataContainer =
             params.dataCollector->readDomain(params.currentStep,
@@ -125,6 +137,22 @@ struct ReadNDScalars
             log<picLog::INPUT_OUTPUT>("HDF5: attribute %1% = %2%") % attrName % *attribute;
         }
     }
+
+    /** @return size of the process grid which wrote the scalars */
+    static Dimensions getGridSize(ThreadParams& params, const std::string& name)
+    {
+        /* only the meta data is read, an empty buffer adopts the size of the data set */
+        Dimensions dstBuffer(0, 0, 0);
+        Dimensions dstOffset(0, 0, 0);
+        Dimensions sizeRead(0, 0, 0);
+        splash::CollectionType* colType = params.dataCollector->readMeta(params.currentStep,
+                                                                         name.c_str(),
+                                                                         dstBuffer,
+                                                                         dstOffset,
+                                                                         sizeRead);
+        __delete(colType);
+        return sizeRead;
+    }
 };
 
 }  // namespace hdf5
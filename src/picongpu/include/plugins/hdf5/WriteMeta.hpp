@@ -273,12 +273,8 @@ namespace writeMeta
                 "chargeCorrection", chargeCorrection.c_str() );
 
             /* write number of slides */
-            const uint32_t slides = MovingWindow::getInstance().getSlideCounter(
-                threadParams->currentStep
-            );
-
             dc->writeAttribute( threadParams->currentStep,
-                                ctUInt32, NULL, "sim_slides", &slides );
+                                ctUInt32, NULL, "sim_slides", &(threadParams->numSlides) );
 
 
             /* openPMD: required time attributes */
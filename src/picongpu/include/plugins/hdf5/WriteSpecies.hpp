@@ -110,71 +110,87 @@ public:
         /* load particle without copy particle data to host */
         ThisSpecies* speciesTmp = &(dc.getData<ThisSpecies >(ThisSpecies::FrameType::getName(), true));
 
-        /* count number of particles for this species on the device */
-        uint64_t numParticles = 0;
+        log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) copy particle to host: %1%") % Hdf5FrameType::getName();
+        typedef bmpl::vector< typename GetPositionFilter<simDim>::type > usedFilters;
+        typedef typename FilterFactory<usedFilters>::FilterType MyParticleFilter;
+        MyParticleFilter filter;
+        /* activate filter pipeline if moving window is activated */
+        filter.setStatus(MovingWindow::getInstance().isSlidingWindowActive());
+        filter.setWindowPosition(params->localWindowToDomainOffset,
+                                 params->window.localDimensions.size);
 
-        log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) count particles: %1%") % Hdf5FrameType::getName();
-        /* at this point we cast to uint64_t, before we assume that per GPU
-         * less then 1e9 (int range) particles will be counted
-         */
-        numParticles = uint64_t( PMacc::CountParticles::countOnDevice< CORE + BORDER >(
-            *speciesTmp,
-            *(params->cellDescription),
-            params->localWindowToDomainOffset,
-            params->window.localDimensions.size
-        ));
+        auto block = PMacc::math::CT::volume<SuperCellSize>::type::value;
 
+        /* int: assume < 2e9 particles per GPU */
+        GridBuffer<int, DIM1> counterBuffer(DataSpace<DIM1>(1));
+        AreaMapping < CORE + BORDER, MappingDesc > mapper(*(params->cellDescription));
 
-        log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) count particles: %1% = %2%") % Hdf5FrameType::getName() % numParticles;
-        Hdf5FrameType hostFrame;
-        log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) malloc mapped memory: %1%") % Hdf5FrameType::getName();
-        /*malloc mapped memory*/
         ForEach<typename Hdf5FrameType::ValueTypeSeq, MallocMemory<bmpl::_1> > mallocMem;
-        mallocMem(forward(hostFrame), numParticles);
-        log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) malloc mapped memory: %1%") % Hdf5FrameType::getName();
-
-        if (numParticles != 0)
+        ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
+        ForEach<typename Hdf5FrameType::ValueTypeSeq, GetDevicePtr<bmpl::_1> > getDevicePtr;
+
+        /* The particles are counted while they are copied. The mapped memory
+         * is sized by the particle number of the previous dump of this
+         * species by this writer (+10%), only if the particles do not fit the
+         * copy is repeated with the exact number. Checkpoints and output
+         * dumps are tracked separately. The first dump counts the particles
+         * before the copy.
+         */
+        const std::string countKey = Hdf5FrameType::getName() +
+            (params->isCheckpoint ? std::string("/checkpoint") : std::string("/output"));
+        std::map<std::string, uint64_t>::const_iterator lastCount = params->lastNumParticles.find(countKey);
+        uint64_t capacity = 0;
+        if (lastCount != params->lastNumParticles.end())
+            capacity = lastCount->second + lastCount->second / 10;
+        else
+        {
+            /* at this point we cast to uint64_t, before we assume that per GPU
+             * less then 1e9 (int range) particles will be counted
+             */
+            capacity = uint64_t( PMacc::CountParticles::countOnDevice< CORE + BORDER >(
+                *speciesTmp,
+                *(params->cellDescription),
+                params->localWindowToDomainOffset,
+                params->window.localDimensions.size
+            ));
+        }
+        uint64_t numParticles = 0;
+        Hdf5FrameType hostFrame;
+        while (true)
         {
+            /*malloc mapped memory*/
+            mallocMem(forward(hostFrame), capacity);
 
-            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) get mapped memory device pointer: %1%") % Hdf5FrameType::getName();
             /*load device pointer of mapped memory*/
             Hdf5FrameType deviceFrame;
-            ForEach<typename Hdf5FrameType::ValueTypeSeq, GetDevicePtr<bmpl::_1> > getDevicePtr;
             getDevicePtr(forward(deviceFrame), forward(hostFrame));
-            log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) get mapped memory device pointer: %1%") % Hdf5FrameType::getName();
-
-            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) copy particle to host: %1%") % Hdf5FrameType::getName();
-            typedef bmpl::vector< typename GetPositionFilter<simDim>::type > usedFilters;
-            typedef typename FilterFactory<usedFilters>::FilterType MyParticleFilter;
-            MyParticleFilter filter;
-            /* activate filter pipeline if moving window is activated */
-            filter.setStatus(MovingWindow::getInstance().isSlidingWindowActive());
-            filter.setWindowPosition(params->localWindowToDomainOffset,
-                                     params->window.localDimensions.size);
-
-            auto block = PMacc::math::CT::volume<SuperCellSize>::type::value;
 
-            /* int: assume < 2e9 particles per GPU */
-            GridBuffer<int, DIM1> counterBuffer(DataSpace<DIM1>(1));
-            AreaMapping < CORE + BORDER, MappingDesc > mapper(*(params->cellDescription));
-
-            /* this sanity check costs a little bit of time but hdf5 writing is slower */
+            counterBuffer.getDeviceBuffer().setValue(0);
             PMACC_KERNEL(CopySpecies{})
                 (mapper.getGridDim(), block)
                 (counterBuffer.getDeviceBuffer().getPointer(),
-                 deviceFrame, speciesTmp->getDeviceParticlesBox(),
+                 deviceFrame,
+                 (int) capacity,
+                 speciesTmp->getDeviceParticlesBox(),
                  filter,
                  domainOffset,
                  totalCellIdx_,
                  mapper
                  );
             counterBuffer.deviceToHost();
-            log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) copy particle to host: %1%") % Hdf5FrameType::getName();
             __getTransactionEvent().waitForFinished();
-            log<picLog::INPUT_OUTPUT > ("HDF5:  all events are finished: %1%") % Hdf5FrameType::getName();
 
-            PMACC_ASSERT((uint64_t) counterBuffer.getHostBuffer().getDataBox()[0] == numParticles);
+            numParticles = (uint64_t) counterBuffer.getHostBuffer().getDataBox()[0];
+            if (numParticles <= capacity)
+                break;
+
+            log<picLog::INPUT_OUTPUT > ("HDF5:  copy again, %1% particles do not fit into %2%: %3%") %
+                numParticles % capacity % Hdf5FrameType::getName();
+            freeMem(forward(hostFrame));
+            capacity = numParticles;
         }
+        params->lastNumParticles[countKey] = numParticles;
+        log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) copy particle to host: %1% = %2%") % Hdf5FrameType::getName() % numParticles;
 
         /* We rather do an allgather at this point then letting libSplash
          * do an allgather during write to find out the global number of
@@ -182,8 +198,6 @@ public:
          */
         log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) collect particle sizes for %1%") % Hdf5FrameType::getName();
 
-        ColTypeUInt64 ctUInt64;
-        ColTypeDouble ctDouble;
         GridController<simDim>& gc = Environment<simDim>::get().GridController();
 
         const uint64_t numRanks( gc.getGlobalSize() );
@@ -225,208 +239,219 @@ public:
         }
         log<picLog::INPUT_OUTPUT > ("HDF5:  (end) collect particle sizes for %1%") % Hdf5FrameType::getName();
 
-        /* dump non-constant particle records to hdf5 file */
-        log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) write particle records for %1%") % Hdf5FrameType::getName();
-
-        const std::string speciesPath( std::string("particles/") + FrameType::getName() );
-
-        ForEach<typename Hdf5FrameType::ValueTypeSeq, hdf5::ParticleAttribute<bmpl::_1> > writeToHdf5;
-        writeToHdf5(
-            params,
-            forward(hostFrame),
-            speciesPath,
-            numParticles,
-            numParticlesOffset,
-            numParticlesGlobal
-        );
-
-        /* write constant particle records to hdf5 file */
-        const float_64 charge( frame::getCharge<FrameType>() );
-        std::vector<float_64> chargeUnitDimension( NUnitDimension, 0.0 );
-        chargeUnitDimension.at(SIBaseUnits::time) = 1.0;
-        chargeUnitDimension.at(SIBaseUnits::electricCurrent) = 1.0;
-
-        writeConstantRecord(
-            params,
-            speciesPath + std::string("/charge"),
-            numParticlesGlobal,
-            charge,
-            UNIT_CHARGE,
-            chargeUnitDimension
-        );
-
-        const float_64 mass( frame::getMass<FrameType>() );
-        std::vector<float_64> massUnitDimension( NUnitDimension, 0.0 );
-        massUnitDimension.at(SIBaseUnits::mass) = 1.0;
-
-        writeConstantRecord(
-            params,
-            speciesPath + std::string("/mass"),
-            numParticlesGlobal,
-            mass,
-            UNIT_MASS,
-            massUnitDimension
-        );
-
-        /* openPMD ED-PIC: write additional attributes */
-        const float_64 particleShape( GetShape<T_Species>::type::support - 1 );
-        params->dataCollector->writeAttribute( params->currentStep,
-                            ctDouble,
-                            speciesPath.c_str(),
-                            "particleShape",
-                            &particleShape );
-
-        traits::GetSpeciesFlagName<T_Species, current<> > currentDepositionName;
-        const std::string currentDeposition( currentDepositionName() );
-        ColTypeString ctCurrentDeposition( currentDeposition.length() );
-        params->dataCollector->writeAttribute( params->currentStep,
-                            ctCurrentDeposition,
-                            speciesPath.c_str(),
-                            "currentDeposition",
-                            currentDeposition.c_str() );
-
-        traits::GetSpeciesFlagName<T_Species, particlePusher<> > particlePushName;
-        const std::string particlePush( particlePushName() );
-        ColTypeString ctParticlePush( particlePush.length() );
-        params->dataCollector->writeAttribute( params->currentStep,
-                            ctParticlePush,
-                            speciesPath.c_str(),
-                            "particlePush",
-                            particlePush.c_str() );
-
-        traits::GetSpeciesFlagName<T_Species, interpolation<> > particleInterpolationName;
-        const std::string particleInterpolation( particleInterpolationName() );
-        ColTypeString ctParticleInterpolation( particleInterpolation.length() );
-        params->dataCollector->writeAttribute( params->currentStep,
-                            ctParticleInterpolation,
-                            speciesPath.c_str(),
-                            "particleInterpolation",
-                            particleInterpolation.c_str() );
-
-        const std::string particleSmoothing("none");
-        ColTypeString ctParticleSmoothing(particleSmoothing.length());
-        params->dataCollector->writeAttribute( params->currentStep,
-                            ctParticleSmoothing,
-                            speciesPath.c_str(),
-                            "particleSmoothing",
-                            particleSmoothing.c_str() );
-
-        log<picLog::INPUT_OUTPUT > ("HDF5:  (end) write particle records for %1%") % Hdf5FrameType::getName();
-
-        /* write species particle patch meta information */
-        log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) writing particlePatches for %1%") % Hdf5FrameType::getName();
-
-        std::string particlePatchesPath( speciesPath + std::string("/particlePatches") );
-
-        /* offset and size of our particle patches
-         *   - numPatches: we write as many patches as MPI ranks
-         *   - myPatchOffset: we write in the order of the MPI ranks
-         *   - myPatchEntries: every MPI rank writes exactly one patch
-         */
-        const Dimensions numPatches( numRanks, 1, 1 );
-        const Dimensions myPatchOffset( myRank, 0, 0 );
-        const Dimensions myPatchEntries( 1, 1, 1 );
+        /* the window can slide before a staged write is executed */
+        const DataSpace<simDim> globalDomainOffset(
+            Environment<simDim>::get().SubGrid().getGlobalDomain().offset);
 
-        /* numParticles: number of particles in this patch */
-        params->dataCollector->write(
-            params->currentStep,
-            numPatches,
-            myPatchOffset,
-            ctUInt64, 1,
-            myPatchEntries,
-            (particlePatchesPath + std::string("/numParticles")).c_str(),
-            &numParticles);
-
-        /* numParticlesOffset: number of particles before this patch */
-        params->dataCollector->write(
-            params->currentStep,
-            numPatches,
-            myPatchOffset,
-            ctUInt64, 1,
-            myPatchEntries,
-            (particlePatchesPath + std::string("/numParticlesOffset")).c_str(),
-            &numParticlesOffset);
-
-        /* offset: absolute position where this particle patch begins including
-         *         global domain offsets (slides), etc.
-         * extent: size of this particle patch, upper bound is excluded
+        /* all further data is owned by the write, the host frame of a staged
+         * checkpoint is freed by the background writer
          */
-        const PMacc::Selection<simDim>& globalDomain = Environment<simDim>::get().SubGrid().getGlobalDomain();
-        const std::string name_lookup[] = {"x", "y", "z"};
-        for (uint32_t d = 0; d < simDim; ++d)
+        params->scheduleWrite([=]() mutable
         {
-            const uint64_t patchOffset =
-                globalDomain.offset[d] +
-                params->window.globalDimensions.offset[d] +
-                params->window.localDimensions.offset[d];
-            const uint64_t patchExtent =
-                params->window.localDimensions.size[d];
+            ColTypeUInt64 ctUInt64;
+            ColTypeDouble ctDouble;
+
+            /* dump non-constant particle records to hdf5 file */
+            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) write particle records for %1%") % Hdf5FrameType::getName();
+
+            const std::string speciesPath( std::string("particles/") + FrameType::getName() );
+
+            ForEach<typename Hdf5FrameType::ValueTypeSeq, hdf5::ParticleAttribute<bmpl::_1> > writeToHdf5;
+            writeToHdf5(
+                params,
+                forward(hostFrame),
+                speciesPath,
+                numParticles,
+                numParticlesOffset,
+                numParticlesGlobal
+            );
+
+            /* write constant particle records to hdf5 file */
+            const float_64 charge( frame::getCharge<FrameType>() );
+            std::vector<float_64> chargeUnitDimension( NUnitDimension, 0.0 );
+            chargeUnitDimension.at(SIBaseUnits::time) = 1.0;
+            chargeUnitDimension.at(SIBaseUnits::electricCurrent) = 1.0;
+
+            writeConstantRecord(
+                params,
+                speciesPath + std::string("/charge"),
+                numParticlesGlobal,
+                charge,
+                UNIT_CHARGE,
+                chargeUnitDimension
+            );
+
+            const float_64 mass( frame::getMass<FrameType>() );
+            std::vector<float_64> massUnitDimension( NUnitDimension, 0.0 );
+            massUnitDimension.at(SIBaseUnits::mass) = 1.0;
+
+            writeConstantRecord(
+                params,
+                speciesPath + std::string("/mass"),
+                numParticlesGlobal,
+                mass,
+                UNIT_MASS,
+                massUnitDimension
+            );
+
+            /* openPMD ED-PIC: write additional attributes */
+            const float_64 particleShape( GetShape<T_Species>::type::support - 1 );
+            params->dataCollector->writeAttribute( params->currentStep,
+                                ctDouble,
+                                speciesPath.c_str(),
+                                "particleShape",
+                                &particleShape );
+
+            traits::GetSpeciesFlagName<T_Species, current<> > currentDepositionName;
+            const std::string currentDeposition( currentDepositionName() );
+            ColTypeString ctCurrentDeposition( currentDeposition.length() );
+            params->dataCollector->writeAttribute( params->currentStep,
+                                ctCurrentDeposition,
+                                speciesPath.c_str(),
+                                "currentDeposition",
+                                currentDeposition.c_str() );
+
+            traits::GetSpeciesFlagName<T_Species, particlePusher<> > particlePushName;
+            const std::string particlePush( particlePushName() );
+            ColTypeString ctParticlePush( particlePush.length() );
+            params->dataCollector->writeAttribute( params->currentStep,
+                                ctParticlePush,
+                                speciesPath.c_str(),
+                                "particlePush",
+                                particlePush.c_str() );
+
+            traits::GetSpeciesFlagName<T_Species, interpolation<> > particleInterpolationName;
+            const std::string particleInterpolation( particleInterpolationName() );
+            ColTypeString ctParticleInterpolation( particleInterpolation.length() );
+            params->dataCollector->writeAttribute( params->currentStep,
+                                ctParticleInterpolation,
+                                speciesPath.c_str(),
+                                "particleInterpolation",
+                                particleInterpolation.c_str() );
+
+            const std::string particleSmoothing("none");
+            ColTypeString ctParticleSmoothing(particleSmoothing.length());
+            params->dataCollector->writeAttribute( params->currentStep,
+                                ctParticleSmoothing,
+                                speciesPath.c_str(),
+                                "particleSmoothing",
+                                particleSmoothing.c_str() );
+
+            log<picLog::INPUT_OUTPUT > ("HDF5:  (end) write particle records for %1%") % Hdf5FrameType::getName();
+
+            /* write species particle patch meta information */
+            log<picLog::INPUT_OUTPUT > ("HDF5:  (begin) writing particlePatches for %1%") % Hdf5FrameType::getName();
+
+            std::string particlePatchesPath( speciesPath + std::string("/particlePatches") );
+
+            /* offset and size of our particle patches
+             *   - numPatches: we write as many patches as MPI ranks
+             *   - myPatchOffset: we write in the order of the MPI ranks
+             *   - myPatchEntries: every MPI rank writes exactly one patch
+             */
+            const Dimensions numPatches( numRanks, 1, 1 );
+            const Dimensions myPatchOffset( myRank, 0, 0 );
+            const Dimensions myPatchEntries( 1, 1, 1 );
 
+            /* numParticles: number of particles in this patch */
             params->dataCollector->write(
                 params->currentStep,
                 numPatches,
                 myPatchOffset,
                 ctUInt64, 1,
                 myPatchEntries,
-                (particlePatchesPath + std::string("/offset/") +
-                 name_lookup[d]).c_str(),
-                &patchOffset);
+                (particlePatchesPath + std::string("/numParticles")).c_str(),
+                &numParticles);
+
+            /* numParticlesOffset: number of particles before this patch */
             params->dataCollector->write(
                 params->currentStep,
                 numPatches,
                 myPatchOffset,
                 ctUInt64, 1,
                 myPatchEntries,
-                (particlePatchesPath + std::string("/extent/") +
-                 name_lookup[d]).c_str(),
-                &patchExtent);
+                (particlePatchesPath + std::string("/numParticlesOffset")).c_str(),
+                &numParticlesOffset);
 
-            /* offsets and extent of the patch are positions (lengths)
-             * and need to be scaled like the cell idx of a particle
+            /* offset: absolute position where this particle patch begins including
+             *         global domain offsets (slides), etc.
+             * extent: size of this particle patch, upper bound is excluded
              */
-            OpenPMDUnit<totalCellIdx> openPMDUnitCellIdx;
-            std::vector<float_64> unitCellIdx = openPMDUnitCellIdx();
+            const std::string name_lookup[] = {"x", "y", "z"};
+            for (uint32_t d = 0; d < simDim; ++d)
+            {
+                const uint64_t patchOffset =
+                    globalDomainOffset[d] +
+                    params->window.globalDimensions.offset[d] +
+                    params->window.localDimensions.offset[d];
+                const uint64_t patchExtent =
+                    params->window.localDimensions.size[d];
+
+                params->dataCollector->write(
+                    params->currentStep,
+                    numPatches,
+                    myPatchOffset,
+                    ctUInt64, 1,
+                    myPatchEntries,
+                    (particlePatchesPath + std::string("/offset/") +
+                     name_lookup[d]).c_str(),
+                    &patchOffset);
+                params->dataCollector->write(
+                    params->currentStep,
+                    numPatches,
+                    myPatchOffset,
+                    ctUInt64, 1,
+                    myPatchEntries,
+                    (particlePatchesPath + std::string("/extent/") +
+                     name_lookup[d]).c_str(),
+                    &patchExtent);
+
+                /* offsets and extent of the patch are positions (lengths)
+                 * and need to be scaled like the cell idx of a particle
+                 */
+                OpenPMDUnit<totalCellIdx> openPMDUnitCellIdx;
+                std::vector<float_64> unitCellIdx = openPMDUnitCellIdx();
+
+                params->dataCollector->writeAttribute(
+                    params->currentStep,
+                    ctDouble,
+                    (particlePatchesPath + std::string("/offset/") +
+                     name_lookup[d]).c_str(),
+                    "unitSI",
+                    &(unitCellIdx.at(d)));
+                params->dataCollector->writeAttribute(
+                    params->currentStep,
+                    ctDouble,
+                    (particlePatchesPath + std::string("/extent/") +
+                     name_lookup[d]).c_str(),
+                    "unitSI",
+                    &(unitCellIdx.at(d)));
+            }
+
+            OpenPMDUnitDimension<totalCellIdx> openPMDUnitDimension;
+            std::vector<float_64> unitDimensionCellIdx = openPMDUnitDimension();
 
             params->dataCollector->writeAttribute(
                 params->currentStep,
                 ctDouble,
-                (particlePatchesPath + std::string("/offset/") +
-                 name_lookup[d]).c_str(),
-                "unitSI",
-                &(unitCellIdx.at(d)));
+                (particlePatchesPath + std::string("/offset")).c_str(),
+                "unitDimension",
+                1u, Dimensions(7,0,0),
+                &(*unitDimensionCellIdx.begin()));
             params->dataCollector->writeAttribute(
                 params->currentStep,
                 ctDouble,
-                (particlePatchesPath + std::string("/extent/") +
-                 name_lookup[d]).c_str(),
-                "unitSI",
-                &(unitCellIdx.at(d)));
-        }
+                (particlePatchesPath + std::string("/extent")).c_str(),
+                "unitDimension",
+                1u, Dimensions(7,0,0),
+                &(*unitDimensionCellIdx.begin()));
 
-        OpenPMDUnitDimension<totalCellIdx> openPMDUnitDimension;
-        std::vector<float_64> unitDimensionCellIdx = openPMDUnitDimension();
-
-        params->dataCollector->writeAttribute(
-            params->currentStep,
-            ctDouble,
-            (particlePatchesPath + std::string("/offset")).c_str(),
-            "unitDimension",
-            1u, Dimensions(7,0,0),
-            &(*unitDimensionCellIdx.begin()));
-        params->dataCollector->writeAttribute(
-            params->currentStep,
-            ctDouble,
-            (particlePatchesPath + std::string("/extent")).c_str(),
-            "unitDimension",
-            1u, Dimensions(7,0,0),
-            &(*unitDimensionCellIdx.begin()));
 
+            log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) writing particlePatches for %1%") % Hdf5FrameType::getName();
 
-        log<picLog::INPUT_OUTPUT > ("HDF5:  ( end ) writing particlePatches for %1%") % Hdf5FrameType::getName();
-
-        /*free host memory*/
-        ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
-        freeMem(forward(hostFrame));
+            /*free host memory*/
+            freeMem(forward(hostFrame));
+        });
         log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) writing species: %1%") % Hdf5FrameType::getName();
     }
 
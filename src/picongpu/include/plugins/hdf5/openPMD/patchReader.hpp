@@ -24,12 +24,14 @@
 
 #if( ENABLE_HDF5 == 1 )
 #  include <splash/splash.h>
+#  include <mpi.h>
 #endif
 
 #include <vector>
 #include <list>
 #include <string>
 #include <iostream>
+#include <stdexcept>
 #include <typeinfo>
 
 namespace picongpu
@@ -54,20 +56,16 @@ namespace openPMD
          *
          * @note currently we force the type to be `uint64_t`,
          *       we can implement type conversions later on
-         * @note currently we force the number of patches
-         *       to stay constant during restarts
          *
          * @param dc parallel libSplash DataCollector
-         * @param availableRanks MPI ranks in the restarted simulation
-         *        that are currently waiting to find patches
          * @param id iteration in file
          * @param particlePatchPathComponent string such as
          *             "particles/e/particlePatches/numParticles" or
          *             "particles/e/particlePatches/offset/x"
+         * @return number of patches in the file
          */
-        void checkSpatialTypeSize(
+        uint32_t checkSpatialTypeSize(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
             const int32_t id,
             const std::string particlePatchPathComponent
         ) const;
@@ -77,8 +75,7 @@ namespace openPMD
          * Read for example: numParticles or offset/x
          *
          * @param[in]  dc pointer to an open splash::DataCollector
-         * @param[in]  availableRanks MPI ranks in the restarted simulation
-         *             that are currently waiting to find patches
+         * @param[in]  numPatches number of patches in the file
          * @param[in]  id time step to read
          * @param[in]  particlePatchPathComponent string such as
          *             "particles/e/particlePatches/numParticles" or
@@ -88,18 +85,53 @@ namespace openPMD
          */
         void readPatchAttribute(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
+            const uint32_t numPatches,
             const int32_t id,
             const std::string particlePatchPathComponent,
             uint64_t* const dest
         ) const;
 
+        /** Read the full patch table of a species from the checkpoint
+         *
+         * Opens the file with a DataCollector of its own on MPI_COMM_SELF,
+         * therefore this is not collective and can be called by one rank.
+         *
+         * @param[in]  filename base name of the checkpoint files
+         * @param[in]  info MPI info for the file access
+         * @param[in]  dimensionality the PIConGPU simDim
+         * @param[in]  id iteration in file
+         * @param[in]  particlePatchPath in-file path to a specific particle patch dir
+         * @param[out] table numParticles, numParticlesOffset, offset and
+         *             extent components, one column of numPatches
+         *             entries each
+         */
+        void readTable(
+            const std::string& filename,
+            MPI_Info info,
+            const uint32_t dimensionality,
+            const int32_t id,
+            const std::string& particlePatchPath,
+            std::vector<uint64_t>& table
+        ) const;
+
     public:
         /** Build up the global list of patches
          *
-         * @param dc parallel libSplash DataCollector
-         * @param availableRanks MPI ranks in the restarted simulation
-         *        that are currently waiting to find patches
+         * The number of patches is taken from the file, it is the number
+         * of MPI ranks of the simulation which wrote the checkpoint and can
+         * differ from the number of ranks in the restarted simulation.
+         *
+         * Collective: rank 0 of `comm` reads the table from the file and
+         * broadcasts it, the other ranks do not access the file.
+         * The reads of the DataCollector which is shared by all ranks are
+         * collective, therefore rank 0 opens the file a second time
+         * for itself.
+         * The result is indexed for ParticlePatches::findOverlapping().
+         *
+         * @param filename base name of the checkpoint files, as passed
+         *                 to the parallel DataCollector of the restart
+         * @param comm all ranks which load the patches
+         * @param info MPI info for the file access of rank 0
          * @param dimensionality the PIConGPU simDim
          * @param id iteration in file
          * @param particlePatchPath in-file path to a specific particle patch dir
@@ -107,8 +139,9 @@ namespace openPMD
          * @return picongpu::openPMD::ParticlePatches struct of arrays with patches
          */
         picongpu::openPMD::ParticlePatches operator()(
-            splash::DataCollector* const dc,
-            const uint32_t availableRanks,
+            const std::string& filename,
+            MPI_Comm comm,
+            MPI_Info info,
             const uint32_t dimensionality,
             const int32_t id,
             const std::string particlePatchPath
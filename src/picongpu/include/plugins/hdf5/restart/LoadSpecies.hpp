@@ -49,6 +49,10 @@
 #include "plugins/common/particlePatches.hpp"
 #include "plugins/hdf5/openPMD/patchReader.hpp"
 
+#include <mpi.h>
+#include <vector>
+#include <algorithm>
+
 namespace picongpu
 {
 
@@ -111,10 +115,6 @@ public:
         // load particle without copying particle data to host
         ThisSpecies* speciesTmp = &(dc.getData<ThisSpecies >(ThisSpecies::FrameType::getName(), true));
 
-        // count total number of particles on the device
-        uint64_cu totalNumParticles = 0;
-        uint64_t particleOffset = 0;
-
         // load particle patches offsets to find own patch
         const std::string particlePatchesPath(
             speciesSubGroup + std::string("particlePatches/")
@@ -125,20 +125,17 @@ public:
 
         picongpu::openPMD::ParticlePatches particlePatches(
             patchReader(
-                params->dataCollector,
-                gc.getGlobalSize(),
+                params->h5Filename,
+                gc.getCommunicator().getMPIComm(),
+                gc.getCommunicator().getMPIInfo(),
                 simDim,
                 params->currentStep,
                 particlePatchesPath
             )
         );
 
-        /** search my entry (using my cell offset and my local grid size)
-         *
-         * \note if you want to restart with a changed GPU configuration, either
-         * post-process the particle-patches in the file or implement to find
-         * all contributing patches and then filter the particles inside those
-         * by position
+        /* cells of the local domain, in the coordinates of the patches and
+         * of the totalCellIdx of each particle
          *
          * \see plugins/hdf5/WriteSpecies.hpp `WriteSpecies::operator()`
          *      as its counterpart
@@ -150,34 +147,66 @@ public:
         const DataSpace<simDim> patchExtent =
             params->window.localDimensions.size;
 
-        for( size_t i = 0; i < gc.getGlobalSize(); ++i )
+        /* search all patches which overlap with my domain
+         *
+         * With the GPU configuration of the checkpoint this is exactly my
+         * own patch. Otherwise, particles of patches which are only partly
+         * inside my domain are filtered by their totalCellIdx.
+         */
+        uint64_t myBegin[ simDim ];
+        uint64_t myExtent[ simDim ];
+        for( uint32_t d = 0; d < simDim; ++d )
+        {
+            myBegin[ d ] = patchOffset[ d ];
+            myExtent[ d ] = patchExtent[ d ];
+        }
+        const std::vector<size_t> overlappingPatches =
+            particlePatches.findOverlapping( myBegin, myExtent );
+
+        std::vector<ChunkInfo> chunks;
+        uint64_t maxChunkSize = 0;
+        for( size_t p = 0; p < overlappingPatches.size(); ++p )
         {
-            bool exactlyMyPatch = true;
+            const size_t i = overlappingPatches[ p ];
+            bool isInside = true;
 
             for( uint32_t d = 0; d < simDim; ++d )
             {
-                if( particlePatches.getOffsetComp( d )[ i ] != (uint64_t)patchOffset[ d ] )
-                    exactlyMyPatch = false;
-                if( particlePatches.getExtentComp( d )[ i ] != (uint64_t)patchExtent[ d ] )
-                    exactlyMyPatch = false;
+                const uint64_t begin = particlePatches.getOffsetComp( d )[ i ];
+                const uint64_t end = begin + particlePatches.getExtentComp( d )[ i ];
+
+                if( begin < myBegin[ d ] || end > myBegin[ d ] + myExtent[ d ] )
+                    isInside = false;
             }
 
-            if( exactlyMyPatch )
+            /* read big patches in chunks to bound the host memory */
+            const uint64_t numParticles = particlePatches.numParticles[ i ];
+            for( uint64_t offset = 0; offset < numParticles; offset += restartChunkSize )
             {
-                totalNumParticles = particlePatches.numParticles[ i ];
-                particleOffset = particlePatches.numParticlesOffset[ i ];
-                break;
+                ChunkInfo chunk;
+                chunk.offset = particlePatches.numParticlesOffset[ i ] + offset;
+                chunk.size = std::min( numParticles - offset, uint64_t( restartChunkSize ) );
+                chunk.isInside = isInside;
+                chunks.push_back( chunk );
+                maxChunkSize = std::max( maxChunkSize, chunk.size );
             }
         }
 
-        log<picLog::INPUT_OUTPUT > ("Loading %1% particles from offset %2%") %
-            (long long unsigned) totalNumParticles % (long long unsigned) particleOffset;
+        /* reads can be collective, therefore all ranks read the same number
+         * of chunks, ranks with less chunks read empty ones */
+        uint64_t numLocalChunks = chunks.size();
+        uint64_t numChunks = 0;
+        MPI_CHECK(MPI_Allreduce( &numLocalChunks, &numChunks, 1, MPI_UINT64_T, MPI_MAX,
+                                 gc.getCommunicator().getMPIComm() ));
+
+        log<picLog::INPUT_OUTPUT > ("HDF5: load %1% chunks of overlapping particle patches (max %2% on a rank)") %
+            numLocalChunks % numChunks;
 
         Hdf5FrameType hostFrame;
         log<picLog::INPUT_OUTPUT > ("HDF5:  malloc mapped memory: %1%") % Hdf5FrameType::getName();
         /*malloc mapped memory*/
         ForEach<typename Hdf5FrameType::ValueTypeSeq, MallocMemory<bmpl::_1> > mallocMem;
-        mallocMem(forward(hostFrame), totalNumParticles);
+        mallocMem(forward(hostFrame), maxChunkSize);
 
         log<picLog::INPUT_OUTPUT > ("HDF5:  get mapped memory device pointer: %1%") % Hdf5FrameType::getName();
         /*load device pointer of mapped memory*/
@@ -185,28 +214,81 @@ public:
         ForEach<typename Hdf5FrameType::ValueTypeSeq, GetDevicePtr<bmpl::_1> > getDevicePtr;
         getDevicePtr(forward(deviceFrame), forward(hostFrame));
 
-        ForEach<typename Hdf5FrameType::ValueTypeSeq, LoadParticleAttributesFromHDF5<bmpl::_1> > loadAttributes;
-        loadAttributes(forward(params), forward(hostFrame), speciesSubGroup, particleOffset, totalNumParticles);
+        const DataSpace<simDim> localDomainCellOffset = globalDomain.offset + localDomain.offset;
+        uint64_t totalNumParticles = 0;
+        std::vector<uint32_t> keep;
 
-        if (totalNumParticles != 0)
+        for( uint64_t c = 0; c < numChunks; ++c )
         {
-            PMacc::particles::operations::splitIntoListOfFrames(
-                *speciesTmp,
-                deviceFrame,
-                totalNumParticles,
-                restartChunkSize,
-                globalDomain.offset + localDomain.offset,
-                totalCellIdx_,
-                *(params->cellDescription),
-                picLog::INPUT_OUTPUT()
-            );
-
-            /*free host memory*/
-            ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
-            freeMem(forward(hostFrame));
-            log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) load species: %1%") % Hdf5FrameType::getName();
+            ChunkInfo chunk;
+            chunk.offset = 0;
+            chunk.size = 0;
+            chunk.isInside = true;
+            if( c < chunks.size() )
+                chunk = chunks[ c ];
+
+            log<picLog::INPUT_OUTPUT > ("Loading %1% particles from offset %2%") %
+                (long long unsigned) chunk.size % (long long unsigned) chunk.offset;
+
+            ForEach<typename Hdf5FrameType::ValueTypeSeq, LoadParticleAttributesFromHDF5<bmpl::_1> > loadAttributes;
+            loadAttributes(forward(params), forward(hostFrame), speciesSubGroup, chunk.offset, chunk.size);
+
+            uint64_t numParticles = chunk.size;
+            if( !chunk.isInside )
+            {
+                /* keep only the particles inside my domain */
+                const DataSpace<simDim>* cellIdx = hostFrame.getIdentifier( totalCellIdx_ ).getPointer();
+                keep.clear();
+                for( uint64_t i = 0; i < chunk.size; ++i )
+                {
+                    const DataSpace<simDim> cellInDomain = cellIdx[ i ] - localDomainCellOffset;
+                    bool isMine = true;
+                    for( uint32_t d = 0; d < simDim; ++d )
+                        if( cellInDomain[ d ] < 0 || cellInDomain[ d ] >= localDomain.size[ d ] )
+                            isMine = false;
+                    if( isMine )
+                        keep.push_back( i );
+                }
+
+                ForEach<typename Hdf5FrameType::ValueTypeSeq, CompactMemory<bmpl::_1> > compactMem;
+                compactMem(forward(hostFrame), keep);
+                numParticles = keep.size();
+            }
+
+            if( numParticles != 0 )
+            {
+                PMacc::particles::operations::splitIntoListOfFrames(
+                    *speciesTmp,
+                    deviceFrame,
+                    numParticles,
+                    restartChunkSize,
+                    localDomainCellOffset,
+                    totalCellIdx_,
+                    *(params->cellDescription),
+                    picLog::INPUT_OUTPUT()
+                );
+            }
+            totalNumParticles += numParticles;
         }
+
+        /*free host memory*/
+        ForEach<typename Hdf5FrameType::ValueTypeSeq, FreeMemory<bmpl::_1> > freeMem;
+        freeMem(forward(hostFrame));
+
+        log<picLog::INPUT_OUTPUT > ("HDF5: ( end ) load species: %1%, %2% particles") %
+            Hdf5FrameType::getName() % (long long unsigned) totalNumParticles;
     }
+
+private:
+
+    /** contiguous range of particles in the file */
+    struct ChunkInfo
+    {
+        uint64_t offset;
+        uint64_t size;
+        /** the patch of the chunk is completely inside the local domain */
+        bool isInside;
+    };
 };
 
 
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <sstream>
+#include <stdexcept>
 #include <splash/splash.h>
 
 #include "pmacc_types.hpp"
@@ -81,7 +82,8 @@ public:
         for (uint32_t i = 0; i < numComponents; ++i)
         {
             // Read the subdomain which belongs to our mpi position.
-            // The total grid size must match the grid size of the stored data.
+            // The total grid size must match the grid size of the stored data,
+            // the decomposition into subdomains can differ from the checkpoint.
             log<picLog::INPUT_OUTPUT > ("Read from domain: offset=%1% size=%2%") %
                 domain_offset.toString() % local_domain_size.toString();
             DomainCollector::DomDataClass data_class;
@@ -93,6 +95,12 @@ public:
                                            &data_class);
 
             int elementCount = params->window.localDimensions.size.productOfComponents();
+            if (field_container->getIndex(0)->getSize().getScalarSize() != size_t(elementCount))
+            {
+                delete field_container;
+                throw std::runtime_error(std::string("HDF5: region of field ") + objectName +
+                                         std::string(" is outside of the checkpoint, global domain size changed?"));
+            }
 
             for (int linearId = 0; linearId < elementCount; ++linearId)
             {
@@ -28,7 +28,12 @@
 #include "traits/GetNComponents.hpp"
 #include "assert.hpp"
 
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace picongpu
 {
@@ -65,10 +70,6 @@ struct Field
 
         const uint32_t nComponents = GetNComponents<ValueType>::value;
 
-        SplashType splashType;
-        ColTypeDouble ctDouble;
-        SplashFloatXType splashFloatXType;
-
         log<picLog::INPUT_OUTPUT > ("HDF5 write field: %1% %2%") %
             name % nComponents;
 
@@ -99,51 +100,38 @@ struct Field
          */
         DataSpace<simDim> globalSlideOffset;
         const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
-        const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(params->currentStep);
-        globalSlideOffset.y() += numSlides * localDomain.size.y();
+        globalSlideOffset.y() += params->numSlides * localDomain.size.y();
 
         Dimensions splashGlobalDomainOffset(0, 0, 0);
         Dimensions splashGlobalOffsetFile(0, 0, 0);
         Dimensions splashGlobalDomainSize(1, 1, 1);
+        Dimensions sizeSrcData(1, 1, 1);
 
         for (uint32_t d = 0; d < simDim; ++d)
         {
             splashGlobalOffsetFile[d] = localDomain.offset[d];
             splashGlobalDomainOffset[d] = params->window.globalDimensions.offset[d] + globalSlideOffset[d];
             splashGlobalDomainSize[d] = params->window.globalDimensions.size[d];
+            sizeSrcData[d] = field_no_guard[d];
         }
 
         splashGlobalOffsetFile[1] = std::max(0, localDomain.offset[1] -
                                              params->window.globalDimensions.offset[1]);
 
-        size_t tmpArraySize = field_no_guard.productOfComponents();
-        ComponentType* tmpArray = new ComponentType[tmpArraySize];
-
-        typedef DataBoxDim1Access<NativeDataBoxType > D1Box;
-        D1Box d1Access(dataBox.shift(field_guard), field_no_guard);
+        const size_t tmpArraySize = field_no_guard.productOfComponents();
 
-        for (uint32_t n = 0; n < nComponents; n++)
+        /* write component n from a contiguous array */
+        const auto writeComponent = [=](const uint32_t n, const ComponentType* data)
         {
-            /* copy data to temp array
-             * tmpArray has the size of the data without any offsets
-             */
-            for (size_t i = 0; i < tmpArraySize; ++i)
-            {
-                tmpArray[i] = d1Access[i][n];
-            }
+            SplashType splashType;
+            ColTypeDouble ctDouble;
+            SplashFloatXType splashFloatXType;
 
             std::stringstream datasetName;
             datasetName << recordName;
             if (nComponents > 1)
                 datasetName << "/" << name_lookup.at(n);
 
-            Dimensions sizeSrcData(1, 1, 1);
-
-            for (uint32_t d = 0; d < simDim; ++d)
-            {
-                sizeSrcData[d] = field_no_guard[d];
-            }
-
             params->dataCollector->writeDomain(params->currentStep,             /* id == time step */
                                                splashGlobalDomainSize,          /* total size of dataset over all processes */
                                                splashGlobalOffsetFile,          /* write offset for this process */
@@ -156,7 +144,7 @@ struct Field
                                                       splashGlobalDomainSize    /* size of the global domain */
                                                ),
                                                DomainCollector::GridType,
-                                               tmpArray);
+                                               data);
 
             /* attributes */
             params->dataCollector->writeAttribute(params->currentStep,
@@ -168,73 +156,185 @@ struct Field
             params->dataCollector->writeAttribute(params->currentStep,
                                                   ctDouble, datasetName.str().c_str(),
                                                   "unitSI", &(unit.at(n)));
+        };
+
+        const auto writeRecordAttributes = [=]()
+        {
+            ColTypeDouble ctDouble;
+            SplashFloatXType splashFloatXType;
+
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctDouble, recordName.c_str(),
+                                                  "unitDimension",
+                                                  1u, Dimensions(7,0,0),
+                                                  &(*unitDimension.begin()));
+
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  splashFloatXType, recordName.c_str(),
+                                                  "timeOffset", &timeOffset);
+
+            const std::string geometry("cartesian");
+            ColTypeString ctGeometry(geometry.length());
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctGeometry, recordName.c_str(),
+                                                  "geometry", geometry.c_str());
+
+            const std::string dataOrder("C");
+            ColTypeString ctDataOrder(dataOrder.length());
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctDataOrder, recordName.c_str(),
+                                                  "dataOrder", dataOrder.c_str());
+
+            char axisLabels[simDim][2];
+            ColTypeString ctAxisLabels(1);
+            for( uint32_t d = 0; d < simDim; ++d )
+            {
+                axisLabels[simDim-1-d][0] = char('x' + d); // 3D: F[z][y][x], 2D: F[y][x]
+                axisLabels[simDim-1-d][1] = '\0';          // terminator is important!
+            }
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctAxisLabels, recordName.c_str(),
+                                                  "axisLabels",
+                                                  1u, Dimensions(simDim,0,0),
+                                                  axisLabels);
+
+            std::vector<float_X> gridSpacing(simDim, 0.0);
+            for( uint32_t d = 0; d < simDim; ++d )
+                gridSpacing.at(d) = cellSize[d];
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  splashFloatXType, recordName.c_str(),
+                                                  "gridSpacing",
+                                                  1u, Dimensions(simDim,0,0),
+                                                  &(*gridSpacing.begin()));
+
+            std::vector<float_64> gridGlobalOffset(simDim, 0.0);
+            for( uint32_t d = 0; d < simDim; ++d )
+                gridGlobalOffset.at(d) = float_64(cellSize[d]) *
+                                         float_64(splashGlobalDomainOffset[d]);
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctDouble, recordName.c_str(),
+                                                  "gridGlobalOffset",
+                                                  1u, Dimensions(simDim,0,0),
+                                                  &(*gridGlobalOffset.begin()));
+
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctDouble, recordName.c_str(),
+                                                  "gridUnitSI", &UNIT_LENGTH);
+
+            const std::string fieldSmoothing("none");
+            ColTypeString ctFieldSmoothing(fieldSmoothing.length());
+            params->dataCollector->writeAttribute(params->currentStep,
+                                                  ctFieldSmoothing, recordName.c_str(),
+                                                  "fieldSmoothing", fieldSmoothing.c_str());
+        };
+
+        const NativeDataBoxType srcBox = dataBox.shift(field_guard);
+
+        if (params->isStaged)
+        {
+            /* host snapshot of all components, the field can change before
+             * the background writer is finished
+             */
+            std::shared_ptr<std::vector<ComponentType> > snapshot(
+                new std::vector<ComponentType>(nComponents * tmpArraySize));
+            for (uint32_t n = 0; n < nComponents; n++)
+                copyComponent(snapshot->data() + n * tmpArraySize, srcBox, field_no_guard, n);
+
+            params->scheduleWrite([=]()
+            {
+                for (uint32_t n = 0; n < nComponents; n++)
+                    writeComponent(n, snapshot->data() + n * tmpArraySize);
+                writeRecordAttributes();
+            });
+            return;
         }
-        __deleteArray(tmpArray);
-
-
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctDouble, recordName.c_str(),
-                                              "unitDimension",
-                                              1u, Dimensions(7,0,0),
-                                              &(*unitDimension.begin()));
-
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              splashFloatXType, recordName.c_str(),
-                                              "timeOffset", &timeOffset);
-
-        const std::string geometry("cartesian");
-        ColTypeString ctGeometry(geometry.length());
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctGeometry, recordName.c_str(),
-                                              "geometry", geometry.c_str());
-
-        const std::string dataOrder("C");
-        ColTypeString ctDataOrder(dataOrder.length());
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctDataOrder, recordName.c_str(),
-                                              "dataOrder", dataOrder.c_str());
-
-        char axisLabels[simDim][2];
-        ColTypeString ctAxisLabels(1);
-        for( uint32_t d = 0; d < simDim; ++d )
+
+        /* two staging buffers: the next component is de-interleaved while
+         * the current one is written
+         */
+        ComponentType* tmpArray[2];
+        for (uint32_t i = 0; i < 2; ++i)
+            tmpArray[i] = (ComponentType*) getStagingBuffer(i, tmpArraySize * sizeof (ComponentType));
+
+        copyComponent(tmpArray[0], srcBox, field_no_guard, 0);
+
+        for (uint32_t n = 0; n < nComponents; n++)
         {
-            axisLabels[simDim-1-d][0] = char('x' + d); // 3D: F[z][y][x], 2D: F[y][x]
-            axisLabels[simDim-1-d][1] = '\0';          // terminator is important!
+            boost::thread copyNextComponent;
+            if (n + 1 < nComponents)
+                copyNextComponent = boost::thread(
+                    boost::bind(&Field::copyComponent<ComponentType, NativeDataBoxType>,
+                                tmpArray[(n + 1) % 2], srcBox, field_no_guard, n + 1));
+
+            writeComponent(n, tmpArray[n % 2]);
+
+            if (copyNextComponent.joinable())
+                copyNextComponent.join();
+        }
+
+        writeRecordAttributes();
+    }
+
+private:
+
+    /** staging memory for the de-interleaved field components
+     *
+     * The buffers are shared by all fields and kept between dumps.
+     *
+     * @param i buffer index (0 or 1)
+     * @param bytes minimal size of the buffer
+     */
+    static char* getStagingBuffer(uint32_t i, size_t bytes)
+    {
+        static std::vector<char> buffers[2];
+        if (buffers[i].size() < bytes)
+            buffers[i].resize(bytes);
+        return buffers[i].empty() ? NULL : &(buffers[i][0]);
+    }
+
+    /** copy one component of a vector field to a contiguous array
+     *
+     * rows (x direction) are copied in parallel with a fixed stride
+     *
+     * @param dst destination with size.productOfComponents() elements
+     * @param srcBox field without guard
+     * @param size number of cells per direction
+     * @param component index of the component
+     */
+    template<typename T_ComponentType, typename T_DataBoxType>
+    static void copyComponent(T_ComponentType* dst,
+                              const T_DataBoxType srcBox,
+                              const DataSpace<simDim> size,
+                              const uint32_t component)
+    {
+        typedef typename T_DataBoxType::ValueType ValueType;
+        const uint32_t nComponents = GetNComponents<ValueType>::value;
+        PMACC_CASSERT_MSG(
+            _please_use_a_value_type_with_contiguous_components,
+            sizeof (ValueType) == nComponents * sizeof (T_ComponentType)
+        );
+
+        const int rowSize = size.x();
+        if (rowSize == 0)
+            return;
+        const int numRows = size.productOfComponents() / rowSize;
+
+        #pragma omp parallel for
+        for (int row = 0; row < numRows; ++row)
+        {
+            DataSpace<simDim> rowStart;
+            int remainingRows = row;
+            for (uint32_t d = 1; d < simDim; ++d)
+            {
+                rowStart[d] = remainingRows % size[d];
+                remainingRows /= size[d];
+            }
+
+            const T_ComponentType* src = reinterpret_cast<const T_ComponentType*>(&(srcBox(rowStart))) + component;
+            T_ComponentType* dstRow = dst + size_t(row) * rowSize;
+            for (int x = 0; x < rowSize; ++x)
+                dstRow[x] = src[x * nComponents];
         }
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctAxisLabels, recordName.c_str(),
-                                              "axisLabels",
-                                              1u, Dimensions(simDim,0,0),
-                                              axisLabels);
-
-        std::vector<float_X> gridSpacing(simDim, 0.0);
-        for( uint32_t d = 0; d < simDim; ++d )
-            gridSpacing.at(d) = cellSize[d];
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              splashFloatXType, recordName.c_str(),
-                                              "gridSpacing",
-                                              1u, Dimensions(simDim,0,0),
-                                              &(*gridSpacing.begin()));
-
-        std::vector<float_64> gridGlobalOffset(simDim, 0.0);
-        for( uint32_t d = 0; d < simDim; ++d )
-            gridGlobalOffset.at(d) = float_64(cellSize[d]) *
-                                     float_64(splashGlobalDomainOffset[d]);
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctDouble, recordName.c_str(),
-                                              "gridGlobalOffset",
-                                              1u, Dimensions(simDim,0,0),
-                                              &(*gridGlobalOffset.begin()));
-
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctDouble, recordName.c_str(),
-                                              "gridUnitSI", &UNIT_LENGTH);
-
-        const std::string fieldSmoothing("none");
-        ColTypeString ctFieldSmoothing(fieldSmoothing.length());
-        params->dataCollector->writeAttribute(params->currentStep,
-                                              ctFieldSmoothing, recordName.c_str(),
-                                              "fieldSmoothing", fieldSmoothing.c_str());
     }
 
 };
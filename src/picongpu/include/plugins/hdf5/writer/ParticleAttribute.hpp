@@ -109,8 +109,7 @@ struct ParticleAttribute
          */
         DataSpace<simDim> globalSlideOffset;
         const PMacc::Selection<simDim>& localDomain = Environment<simDim>::get().SubGrid().getLocalDomain();
-        const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(threadParams->currentStep);
-        globalSlideOffset.y() += numSlides * localDomain.size.y();
+        globalSlideOffset.y() += threadParams->numSlides * localDomain.size.y();
 
         Dimensions splashDomainOffset(0, 0, 0);
         Dimensions splashGlobalDomainOffset(0, 0, 0);
@@ -23,6 +23,7 @@
 #include "mappings/simulation/GridController.hpp"
 #include "memory/boxes/PitchedBox.hpp"
 #include "header/MessageHeader.hpp"
+#include "mpi/CommunicatorCache.hpp"
 
 #include "simulation_defines.hpp"
 
@@ -31,6 +32,8 @@
 #include <mpi.h>
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
 
 #include <sys/stat.h>
 
@@ -38,16 +41,26 @@ namespace picongpu
 {
 using namespace PMacc;
 
+/** gather the 2D slices of all active ranks on one master rank
+ *
+ * The slices are collected along a binomial tree over the active ranks:
+ * in round k every rank whose (master relative) rank is an odd multiple
+ * of 2^k sends all slices collected so far to the rank 2^k below.
+ * The master receives log2(numRanks) messages instead of one message per
+ * rank and the packing is spread over the inner nodes of the tree.
+ *
+ * All buffers are page-locked and kept between calls; they only grow if
+ * a larger slice arrives.
+ */
 struct GatherSlice
 {
 
     GatherSlice() :
         mpiRank(-1),
         numRanks(0),
-        filteredData(NULL),
         comm(MPI_COMM_NULL),
-        fullData(NULL),
         masterRank(0),
+        partBytes(0),
         isMPICommInitialized(false)
     {
     }
@@ -58,6 +71,7 @@ struct GatherSlice
     }
 
     /*
+     * @param isActive true if this rank contributes a slice
      * @return true if object has reduced data after reduce call else false
      */
     bool init(bool isActive)
@@ -70,130 +84,114 @@ struct GatherSlice
             reset();
         }
 
-        int countRanks = Environment<simDim>::get().GridController().getGpuNodes().productOfComponents();
-        std::vector<int> gatherRanks(countRanks);
-        std::vector<int> groupRanks(countRanks);
-        mpiRank = Environment<simDim>::get().GridController().getGlobalRank();
-        if (!isActive)
-            mpiRank = -1;
-
-        MPI_CHECK(MPI_Allgather(&mpiRank, 1, MPI_INT, &gatherRanks[0], 1, MPI_INT, MPI_COMM_WORLD));
-
-        for (int i = 0; i < countRanks; ++i)
-        {
-            if (gatherRanks[i] != -1)
-            {
-                groupRanks[numRanks] = gatherRanks[i];
-                numRanks++;
-            }
-        }
-
-        MPI_Group group = MPI_GROUP_NULL;
-        MPI_Group newgroup = MPI_GROUP_NULL;
-        MPI_CHECK(MPI_Comm_group(MPI_COMM_WORLD, &group));
-        MPI_CHECK(MPI_Group_incl(group, numRanks, &groupRanks[0], &newgroup));
-
-        MPI_CHECK(MPI_Comm_create(MPI_COMM_WORLD, newgroup, &comm));
+        /* communicators of the same active ranks are shared, e.g. with the
+         * MPIReduce of the visualization or after a window slide */
+        comm = mpi::CommunicatorCache::getInstance().getCommunicator(isActive);
 
-        if (mpiRank != -1)
+        if (comm != MPI_COMM_NULL)
         {
-            MPI_Comm_rank(comm, &mpiRank);
+            MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
+            MPI_CHECK(MPI_Comm_size(comm, &numRanks));
             isMPICommInitialized = true;
         }
-        MPI_CHECK(MPI_Group_free(&group));
-        MPI_CHECK(MPI_Group_free(&newgroup));
 
         masterRankOffset++;
         /* avoid that only rank zero is the master
          * this reduces the load of rank zero
          */
-        masterRank = (masterRankOffset % numRanks);
+        masterRank = numRanks > 0 ? (masterRankOffset % numRanks) : 0;
 
-        return mpiRank == masterRank;
+        return isMPICommInitialized && mpiRank == masterRank;
     }
 
+    /** gather the slices
+     *
+     * @param data local slice with the size header.node.maxSize
+     * @param header header of the local slice
+     * @return on the master rank a box with the size header.sim.size which
+     *         contains the whole image, the memory is valid until the next
+     *         call, on all other ranks a box without valid memory
+     */
     template<class Box >
     Box operator()(Box & data, const MessageHeader & header)
     {
         typedef typename Box::ValueType ValueType;
 
-        Box dstBox = Box(PitchedBox<ValueType, DIM2 > (
-                                                       (ValueType*) filteredData,
-                                                       DataSpace<DIM2 > (),
-                                                       header.sim.size,
-                                                       header.sim.size.x() * sizeof (ValueType)
-                                                       ));
-
-        MessageHeader* fakeHeader = MessageHeader::create();
-        memcpy(fakeHeader, &header, sizeof (MessageHeader));
+        const Size2D resultSize = header.sim.size;
 
-        char* recvHeader = new char[ MessageHeader::bytes * numRanks];
+        parts.clear();
+        partBytes = 0;
+        packLocalSlice<ValueType>(data, header.node.offset, header.node.maxSize);
 
-        if (fullData == NULL && mpiRank == masterRank)
-            fullData = (char*) new ValueType[header.sim.size.productOfComponents()];
+        /* rank relative to the master, the master is the root of the tree */
+        const int treeRank = (mpiRank - masterRank + numRanks) % numRanks;
 
-
-        MPI_CHECK(MPI_Gather(fakeHeader, MessageHeader::bytes, MPI_CHAR, recvHeader, MessageHeader::bytes,
-                             MPI_CHAR, masterRank, comm));
-
-        std::vector<int> counts(numRanks);
-        std::vector<int> displs(numRanks);
-        int offset = 0;
-        for (int i = 0; i < numRanks; ++i)
+        for (int distance = 1; distance < numRanks; distance *= 2)
         {
-            MessageHeader* head = (MessageHeader*) (recvHeader + MessageHeader::bytes * i);
-            counts[i] = head->node.maxSize.productOfComponents() * sizeof (ValueType);
-            displs[i] = offset;
-            offset += counts[i];
-        }
-
-        const size_t elementsCount = header.node.maxSize.productOfComponents() * sizeof (ValueType);
-
-        MPI_CHECK(MPI_Gatherv(
-                              (char*) (data.getPointer()), elementsCount, MPI_CHAR,
-                              fullData, &counts[0], &displs[0], MPI_CHAR,
-                              masterRank, comm));
+            if (treeRank % (2 * distance) != 0)
+            {
+                /* send everything collected so far to the parent and leave */
+                const int parent = (treeRank - distance + masterRank) % numRanks;
+                MPI_CHECK(MPI_Send(&parts[0], parts.size() * sizeof (Part), MPI_CHAR,
+                                   parent, tagParts, comm));
+                MPI_CHECK(MPI_Send(partData.getPointer(), partBytes, MPI_CHAR,
+                                   parent, tagData, comm));
+                break;
+            }
 
+            if (treeRank + distance < numRanks)
+            {
+                const int child = (treeRank + distance + masterRank) % numRanks;
+                receiveParts<ValueType>(child);
+            }
+        }
 
+        Box dstBox = Box(PitchedBox<ValueType, DIM2 > (
+                                                       (ValueType*) NULL,
+                                                       DataSpace<DIM2 > (),
+                                                       resultSize,
+                                                       resultSize.x() * sizeof (ValueType)
+                                                       ));
 
         if (mpiRank == masterRank)
         {
-            log<picLog::DOMAINS > ("Master create image");
-            if (filteredData == NULL)
-                filteredData = (char*) new ValueType[header.sim.size.productOfComponents()];
+            log<picLog::DOMAINS > ("Master create image from %1% parts") % parts.size();
+
+            result.reserve(resultSize.productOfComponents() * sizeof (ValueType));
 
             /*create box with valid memory*/
             dstBox = Box(PitchedBox<ValueType, DIM2 > (
-                                                       (ValueType*) filteredData,
+                                                       (ValueType*) result.getPointer(),
                                                        DataSpace<DIM2 > (),
-                                                       header.sim.size,
-                                                       header.sim.size.x() * sizeof (ValueType)
+                                                       resultSize,
+                                                       resultSize.x() * sizeof (ValueType)
                                                        ));
 
-            for (int i = 0; i < numRanks; ++i)
+            std::vector<size_t> partOffsets(parts.size());
+            size_t offset = 0;
+            for (size_t i = 0; i < parts.size(); ++i)
             {
-                MessageHeader* head = (MessageHeader*) (recvHeader + MessageHeader::bytes * i);
+                partOffsets[i] = offset;
+                offset += parts[i].getSize().productOfComponents() * sizeof (ValueType);
+            }
 
-                log<picLog::DOMAINS > ("part image with offset %1%byte=%2%elements | size %3%  | offset %4%") %
-                    displs[i] % (displs[i] / sizeof (ValueType)) %
-                    head->node.maxSize.toString() %
-                    head->node.offset.toString();
+            /* the parts are disjoint, each thread inserts whole parts */
+            const int numParts = parts.size();
+            #pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < numParts; ++i)
+            {
+                const Size2D partSize = parts[i].getSize();
                 Box srcBox = Box(PitchedBox<ValueType, DIM2 > (
-                                                               (ValueType*) (fullData + displs[i]),
+                                                               (ValueType*) (partData.getPointer() + partOffsets[i]),
                                                                DataSpace<DIM2 > (),
-                                                               head->node.maxSize,
-                                                               head->node.maxSize.x() * sizeof (ValueType)
+                                                               partSize,
+                                                               partSize.x() * sizeof (ValueType)
                                                                ));
 
-                insertData(dstBox, srcBox, head->node.offset, head->node.maxSize);
+                insertData(dstBox, srcBox, parts[i].getOffset(), partSize);
             }
-
-            __deleteArray(fullData);
         }
 
-        delete[] recvHeader;
-        MessageHeader::destroy(fakeHeader);
-
         return dstBox;
     }
 
@@ -211,24 +209,156 @@ struct GatherSlice
 
 private:
 
+    /** page-locked host memory which is only reallocated if it must grow */
+    class PinnedBuffer
+    {
+    public:
+
+        PinnedBuffer() : pointer(NULL), capacity(0)
+        {
+        }
+
+        ~PinnedBuffer()
+        {
+            release();
+        }
+
+        /** ensure a capacity of at least `bytes`, the content is kept */
+        void reserve(size_t bytes)
+        {
+            if (bytes <= capacity)
+                return;
+            /* grow geometrically to avoid a reallocation for each new part */
+            const size_t newCapacity = std::max(bytes, capacity + capacity / 2);
+            char* newPointer = NULL;
+            CUDA_CHECK(cudaMallocHost((void**) &newPointer, newCapacity));
+            if (pointer != NULL)
+            {
+                memcpy(newPointer, pointer, capacity);
+                CUDA_CHECK(cudaFreeHost(pointer));
+            }
+            pointer = newPointer;
+            capacity = newCapacity;
+        }
+
+        void release()
+        {
+            if (pointer != NULL)
+                CUDA_CHECK(cudaFreeHost(pointer));
+            pointer = NULL;
+            capacity = 0;
+        }
+
+        char* getPointer()
+        {
+            return pointer;
+        }
+
+    private:
+
+        PinnedBuffer(const PinnedBuffer&);
+        PinnedBuffer& operator=(const PinnedBuffer&);
+
+        char* pointer;
+        size_t capacity;
+    };
+
+    /** rectangle of the image stored in partData */
+    struct Part
+    {
+        int offset[2];
+        int size[2];
+
+        Size2D getOffset() const
+        {
+            return Size2D(offset[0], offset[1]);
+        }
+
+        Size2D getSize() const
+        {
+            return Size2D(size[0], size[1]);
+        }
+    };
+
+    enum
+    {
+        tagParts = 0,
+        tagData = 1
+    };
+
+    /** copy the local slice to partData */
+    template<typename ValueType, class Box>
+    void packLocalSlice(Box & data, const Size2D & offset, const Size2D & size)
+    {
+        Part part;
+        for (uint32_t d = 0; d < DIM2; ++d)
+        {
+            part.offset[d] = offset[d];
+            part.size[d] = size[d];
+        }
+        const size_t bytes = size_t(part.size[0]) * part.size[1] * sizeof (ValueType);
+
+        partData.reserve(bytes);
+        ValueType* dst = (ValueType*) partData.getPointer();
+        for (int y = 0; y < part.size[1]; ++y)
+        {
+            for (int x = 0; x < part.size[0]; ++x)
+            {
+                dst[y * part.size[0] + x] = data[y][x];
+            }
+        }
+
+        parts.push_back(part);
+        partBytes = bytes;
+    }
+
+    /** append all parts collected by a child rank */
+    template<typename ValueType>
+    void receiveParts(int child)
+    {
+        MPI_Status status;
+        MPI_CHECK(MPI_Probe(child, tagParts, comm, &status));
+        int recvBytes = 0;
+        MPI_CHECK(MPI_Get_count(&status, MPI_CHAR, &recvBytes));
+
+        const size_t firstNewPart = parts.size();
+        parts.resize(firstNewPart + recvBytes / sizeof (Part));
+        MPI_CHECK(MPI_Recv(&parts[firstNewPart], recvBytes, MPI_CHAR,
+                           child, tagParts, comm, MPI_STATUS_IGNORE));
+
+        size_t dataBytes = 0;
+        for (size_t i = firstNewPart; i < parts.size(); ++i)
+            dataBytes += parts[i].getSize().productOfComponents() * sizeof (ValueType);
+
+        /* receive directly behind the already collected data */
+        partData.reserve(partBytes + dataBytes);
+        MPI_CHECK(MPI_Recv(partData.getPointer() + partBytes, dataBytes, MPI_CHAR,
+                           child, tagData, comm, MPI_STATUS_IGNORE));
+        partBytes += dataBytes;
+    }
+
     /*reset this object und set all values to initial state*/
     void reset()
     {
         mpiRank = -1;
         numRanks = 0;
-        if (filteredData != NULL)
-            delete[] filteredData;
-        filteredData = NULL;
-        if (fullData != NULL)
-            delete[] fullData;
-        fullData = NULL;
-        if (isMPICommInitialized)
-            MPI_CHECK(MPI_Comm_free(&comm));
+        parts.clear();
+        partBytes = 0;
+        partData.release();
+        result.release();
+        mpi::CommunicatorCache::getInstance().release(comm);
+        comm = MPI_COMM_NULL;
         isMPICommInitialized = false;
     }
 
-    char* filteredData;
-    char* fullData;
+    /** parts collected by this rank (own slice first) */
+    std::vector<Part> parts;
+    /** data of all parts, stored one after another */
+    PinnedBuffer partData;
+    /** used bytes in partData */
+    size_t partBytes;
+    /** gathered image (master only) */
+    PinnedBuffer result;
     MPI_Comm comm;
     int mpiRank;
     int numRanks;
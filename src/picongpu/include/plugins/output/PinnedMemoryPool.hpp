@@ -0,0 +1,194 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <map>
+#include <set>
+#include <stdexcept>
+
+namespace picongpu
+{
+
+    /** pool of page-locked, device mapped host memory
+     *
+     * Blocks are rounded up to a multiple of minBlockBytes and are kept
+     * after free() for the next allocation which fits into the block. The
+     * expensive page-locking is done only if the pool has to grow.
+     *
+     * The writers call trim() after each dump: blocks which were not used
+     * since the previous trim() are returned to the operating system, so the
+     * pool holds at most the memory which was needed during the last dump.
+     *
+     * Singleton class, shared by all species writers and readers. The
+     * methods are thread-safe, blocks of a staged HDF5 checkpoint are
+     * returned by the background writer.
+     */
+    class PinnedMemoryPool
+    {
+    public:
+
+        /** granularity of the block size in byte */
+        static constexpr size_t minBlockBytes = 1024 * 1024;
+
+        static PinnedMemoryPool& getInstance()
+        {
+            static PinnedMemoryPool instance;
+            return instance;
+        }
+
+        /** get a block of at least `bytes` byte
+         *
+         * An unused block is only taken if it is at most twice as large as
+         * requested.
+         *
+         * @return pointer to mapped pinned memory, NULL if bytes is zero
+         */
+        void* allocate(size_t bytes)
+        {
+            if (bytes == 0)
+                return NULL;
+
+            boost::lock_guard<boost::mutex> lock(mutex);
+            const size_t blockBytes = (bytes + minBlockBytes - 1) / minBlockBytes * minBlockBytes;
+
+            /* smallest unused block which is large enough */
+            std::multimap<size_t, void*>::iterator freeBlock = freeBlocks.lower_bound(blockBytes);
+            if (freeBlock != freeBlocks.end() && freeBlock->first <= 2 * blockBytes)
+            {
+                void* ptr = freeBlock->second;
+                usedBlocks[ptr] = freeBlock->first;
+                freeBlocks.erase(freeBlock);
+                recentBlocks.insert(ptr);
+                return ptr;
+            }
+
+            void* ptr = NULL;
+            if (cudaHostAlloc(&ptr, blockBytes, cudaHostAllocMapped) != cudaSuccess)
+            {
+                /* clear the error and retry after returning unused blocks */
+                cudaGetLastError();
+                releaseUnusedLocked();
+                CUDA_CHECK(cudaHostAlloc(&ptr, blockBytes, cudaHostAllocMapped));
+            }
+            reservedBytes += blockBytes;
+            usedBlocks[ptr] = blockBytes;
+            recentBlocks.insert(ptr);
+            return ptr;
+        }
+
+        /** return a block to the pool
+         *
+         * @param ptr pointer from allocate(), NULL is ignored
+         */
+        void free(void* ptr)
+        {
+            if (ptr == NULL)
+                return;
+
+            boost::lock_guard<boost::mutex> lock(mutex);
+            std::map<void*, size_t>::iterator block = usedBlocks.find(ptr);
+            if (block == usedBlocks.end())
+                throw std::runtime_error("PinnedMemoryPool: pointer was not allocated by the pool");
+
+            freeBlocks.insert(std::make_pair(block->second, ptr));
+            usedBlocks.erase(block);
+        }
+
+        /** release all unused blocks which were not allocated since the
+         *  previous call of trim()
+         */
+        void trim()
+        {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            std::multimap<size_t, void*>::iterator it = freeBlocks.begin();
+            while (it != freeBlocks.end())
+            {
+                if (recentBlocks.find(it->second) == recentBlocks.end())
+                {
+                    CUDA_CHECK(cudaFreeHost(it->second));
+                    reservedBytes -= it->first;
+                    freeBlocks.erase(it++);
+                }
+                else
+                    ++it;
+            }
+            recentBlocks.clear();
+        }
+
+        /** release all unused blocks to the operating system */
+        void releaseUnused()
+        {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            releaseUnusedLocked();
+        }
+
+        /** page-locked memory held by the pool (used and unused) in byte */
+        size_t getReservedBytes() const
+        {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            return reservedBytes;
+        }
+
+    private:
+
+        /** release all unused blocks, the caller holds the lock */
+        void releaseUnusedLocked()
+        {
+            for (std::multimap<size_t, void*>::iterator it = freeBlocks.begin();
+                 it != freeBlocks.end(); ++it)
+            {
+                CUDA_CHECK(cudaFreeHost(it->second));
+                reservedBytes -= it->first;
+            }
+            freeBlocks.clear();
+        }
+
+        PinnedMemoryPool() : reservedBytes(0)
+        {
+        }
+
+        ~PinnedMemoryPool()
+        {
+            /* the CUDA context can be destroyed already, errors are ignored */
+            for (std::multimap<size_t, void*>::iterator it = freeBlocks.begin();
+                 it != freeBlocks.end(); ++it)
+                cudaFreeHost(it->second);
+        }
+
+        PinnedMemoryPool(const PinnedMemoryPool&);
+        PinnedMemoryPool& operator=(const PinnedMemoryPool&);
+
+        /** unused blocks sorted by size */
+        std::multimap<size_t, void*> freeBlocks;
+        /** size of each handed out block */
+        std::map<void*, size_t> usedBlocks;
+        /** blocks handed out since the last trim() */
+        std::set<void*> recentBlocks;
+        size_t reservedBytes;
+        mutable boost::mutex mutex;
+    };
+
+} //namespace picongpu
@@ -39,6 +39,9 @@
 
 #include "compileTime/conversion/RemoveFromSeq.hpp"
 #include "traits/Resolve.hpp"
+#include "plugins/output/PinnedMemoryPool.hpp"
+
+#include <vector>
 
 namespace picongpu
 {
@@ -47,6 +50,11 @@ using namespace PMacc;
 
 
 
+/** allocate mapped host memory
+ *
+ * The memory is taken from the PinnedMemoryPool and must be freed with
+ * FreeMemory.
+ */
 template<typename T_Type>
 struct MallocMemory
 {
@@ -55,11 +63,7 @@ struct MallocMemory
     {
         typedef typename PMacc::traits::Resolve<T_Type>::type::type type;
 
-        type* ptr = NULL;
-        if (size != 0)
-        {
-            CUDA_CHECK(cudaHostAlloc(&ptr, size * sizeof (type), cudaHostAllocMapped));
-        }
+        type* ptr = (type*) PinnedMemoryPool::getInstance().allocate(size * sizeof (type));
         v1.getIdentifier(T_Type()) = VectorDataBox<type>(ptr);
 
     }
@@ -134,11 +138,8 @@ struct FreeMemory
         typedef typename PMacc::traits::Resolve<T_Type>::type::type type;
 
         type* ptr = value.getIdentifier(T_Type()).getPointer();
-        if (ptr != NULL)
-        {
-            CUDA_CHECK(cudaFreeHost(ptr));
-            ptr=NULL;
-        }
+        /* the memory is kept by the pool for the next allocation */
+        PinnedMemoryPool::getInstance().free(ptr);
     }
 };
 
@@ -165,6 +166,24 @@ struct FreeHostMemory
     }
 };
 
+/** keep only selected elements of an attribute
+ *
+ * Moves element `keep[i]` to position `i`, the indices must be ascending.
+ */
+template<typename T_Type>
+struct CompactMemory
+{
+    template<typename ValueType >
+    HINLINE void operator()(ValueType& value, const std::vector<uint32_t>& keep) const
+    {
+        typedef typename PMacc::traits::Resolve<T_Type>::type::type type;
+
+        type* ptr = value.getIdentifier(T_Type()).getPointer();
+        for (size_t i = 0; i < keep.size(); ++i)
+            ptr[i] = ptr[keep[i]];
+    }
+};
+
 /*functor to create a pair for a MapTuple map*/
 struct OperatorCreateVectorBox
 {
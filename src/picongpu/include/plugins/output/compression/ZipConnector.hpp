@@ -23,69 +23,401 @@
 #include "assert.hpp"
 
 #include <string>
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 #include "zlib.h"
 
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+/** zlib compression of large buffers with multiple threads
+ *
+ * The input is split into blocks of blockSize bytes. Each block is compressed
+ * independently (raw deflate, no dictionary from the previous block) by an
+ * OpenMP thread and terminated with a full flush. The blocks are concatenated
+ * to a single standard zlib stream (header, deflate data, adler32 of the
+ * whole input), therefore the output can be read by any zlib inflate.
+ *
+ * The z_stream state of each thread is kept between calls.
+ *
+ * The compressed size of each block of the last compress() call is available
+ * via getCompressedBlockSizes(). If these sizes are known to the receiver the
+ * blocks can be decompressed in parallel.
+ */
 class ZipConnector
 {
 public:
 
-    size_t compress(void* out, void* in, size_t sizeIn, int compressLevel)
+    /** constructor
+     *
+     * @param blockSize uncompressed size of an independently compressed block
+     *                  in byte, smaller blocks increase parallelism but
+     *                  decrease the compression ratio
+     */
+    ZipConnector(size_t blockSize = 1024 * 1024) :
+        blockSize(blockSize > 0 ? blockSize : 1)
     {
-        int ret;
+    }
 
-        z_stream strm;
+    virtual ~ZipConnector()
+    {
+        for (size_t i = 0; i < deflateStreams.size(); ++i)
+            if (deflateStreams[i].isInitialized)
+                (void) deflateEnd(&deflateStreams[i].strm);
+        for (size_t i = 0; i < inflateStreams.size(); ++i)
+            if (inflateStreams[i].isInitialized)
+                (void) inflateEnd(&inflateStreams[i].strm);
+    }
 
-        strm.zalloc = Z_NULL;
-        strm.zfree = Z_NULL;
-        strm.opaque = Z_NULL;
-        ret = deflateInit(&strm, compressLevel);
-        if (ret != Z_OK)
-            return 0;
+    /** upper bound of the compressed size
+     *
+     * @param sizeIn number of bytes which should be compressed
+     * @return size in byte the output buffer of compress() must provide
+     */
+    size_t compressBound(size_t sizeIn) const
+    {
+        /* zlib header and adler32 trailer */
+        return headerBytes + trailerBytes + getNumBlocks(sizeIn) * getBlockBound(blockSize);
+    }
 
-        strm.avail_in = sizeIn;
-        strm.next_in = (Bytef*) in;
+    /** compress a buffer to a zlib stream
+     *
+     * @param out destination, must provide at least compressBound(sizeIn) bytes
+     * @param sizeOut size of out in byte
+     * @param in source
+     * @param sizeIn number of bytes to compress
+     * @param compressLevel zlib compression level [0;9]
+     * @return number of compressed bytes
+     */
+    size_t compress(void* out, size_t sizeOut, void* in, size_t sizeIn, int compressLevel)
+    {
+        const size_t neededBytes = compressBound(sizeIn);
+        if (sizeOut < neededBytes)
+            throw std::runtime_error(
+                std::string("ZipConnector: output buffer too small, compressBound() is ") +
+                std::to_string(neededBytes) + std::string(" byte")
+            );
 
-        strm.avail_out = sizeIn;
-        strm.next_out = (Bytef*) out;
+        const int numBlocks = getNumBlocks(sizeIn);
+        const size_t blockBound = getBlockBound(blockSize);
 
-        ret = deflate(&strm, Z_FINISH);
-        PMACC_ASSERT(ret != Z_STREAM_ERROR);
+        Bytef* outBytes = (Bytef*) out;
+        const Bytef* inBytes = (const Bytef*) in;
+
+        compressedBlockSizes.resize(numBlocks);
+        std::vector<uLong> blockChecksums(numBlocks);
+        std::vector<int> blockErrors(numBlocks, Z_OK);
+
+        prepareStreams(deflateStreams);
+
+        /* each block is written to an own region of the output buffer and
+         * compacted afterwards
+         */
+        #pragma omp parallel for
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            z_stream& strm = getDeflateStream(compressLevel);
+            const size_t blockOffset = size_t(b) * blockSize;
+            const size_t blockBytes = getBlockBytes(b, sizeIn);
+
+            blockChecksums[b] = adler32(adler32(0L, Z_NULL, 0), inBytes + blockOffset, blockBytes);
+
+            strm.next_in = (Bytef*) inBytes + blockOffset;
+            strm.avail_in = blockBytes;
+            strm.next_out = outBytes + headerBytes + size_t(b) * blockBound;
+            strm.avail_out = blockBound;
 
-        size_t compressedBytes = strm.total_out;
+            /* the last block terminates the deflate stream */
+            const int flush = (b == numBlocks - 1) ? Z_FINISH : Z_FULL_FLUSH;
+            const int ret = deflate(&strm, flush);
+            const int expectedRet = (flush == Z_FINISH) ? Z_STREAM_END : Z_OK;
+            if (ret != expectedRet || strm.avail_in != 0 || strm.avail_out == 0)
+                blockErrors[b] = (ret == expectedRet) ? Z_BUF_ERROR : ret;
 
-        (void) deflateEnd(&strm);
-        return compressedBytes;
+            compressedBlockSizes[b] = blockBound - strm.avail_out;
+        }
+
+        for (int b = 0; b < numBlocks; ++b)
+            if (blockErrors[b] != Z_OK)
+                throw std::runtime_error(
+                    std::string("ZipConnector: deflate failed with error ") +
+                    std::to_string(blockErrors[b])
+                );
+
+        writeHeader(outBytes, compressLevel);
+
+        size_t outPos = headerBytes;
+        uLong checksum = adler32(0L, Z_NULL, 0);
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            /* moves always to lower addresses, regions can overlap */
+            memmove(outBytes + outPos, outBytes + headerBytes + size_t(b) * blockBound, compressedBlockSizes[b]);
+            outPos += compressedBlockSizes[b];
+            checksum = adler32_combine(checksum, blockChecksums[b], getBlockBytes(b, sizeIn));
+        }
+
+        writeBigEndian32(outBytes + outPos, checksum);
+        outPos += trailerBytes;
+
+        return outPos;
     }
 
-    size_t decompress(void* out, void* in, size_t sizeIn,size_t sizeOut)
+    /** compressed size of each block of the last call of compress()
+     *
+     * The zlib header (2 byte) and trailer (4 byte) are not included.
+     */
+    const std::vector<size_t>& getCompressedBlockSizes() const
     {
-        int ret;
+        return compressedBlockSizes;
+    }
 
-        z_stream strm;
-        /* allocate deflate state */
-        strm.zalloc = Z_NULL;
-        strm.zfree = Z_NULL;
-        strm.opaque = Z_NULL;
-        ret = inflateInit(&strm);
-        if (ret != Z_OK)
-            return 0;
+    /** decompress a zlib stream
+     *
+     * @param out destination
+     * @param in zlib stream
+     * @param sizeIn size of the zlib stream in byte
+     * @param sizeOut size of out in byte
+     * @return number of decompressed bytes
+     */
+    size_t decompress(void* out, void* in, size_t sizeIn, size_t sizeOut)
+    {
+        prepareStreams(inflateStreams);
+        z_stream& strm = getInflateStream(inflateStreams[0], MAX_WBITS);
 
         strm.avail_in = sizeIn;
-
         strm.next_in = (Bytef*) in;
-
         strm.avail_out = sizeOut;
         strm.next_out = (Bytef*) out;
-        ret = inflate(&strm, Z_FINISH);
+
+        const int ret = inflate(&strm, Z_FINISH);
         PMACC_ASSERT(ret != Z_STREAM_ERROR);
 
-        size_t uncompressedBytes = strm.total_out;
+        return sizeOut - strm.avail_out;
+    }
+
+    /** decompress the blocks of a zlib stream created by compress() in parallel
+     *
+     * @param out destination
+     * @param in zlib stream
+     * @param sizeIn size of the zlib stream in byte
+     * @param sizeOut number of uncompressed bytes
+     * @param blockSizes compressed size of each block (see getCompressedBlockSizes())
+     *                   of the ZipConnector which created the stream, the block
+     *                   size of both ZipConnector instances must be equal
+     * @return number of decompressed bytes
+     */
+    size_t decompress(void* out, void* in, size_t sizeIn, size_t sizeOut, const std::vector<size_t>& blockSizes)
+    {
+        const int numBlocks = getNumBlocks(sizeOut);
+        if (blockSizes.size() != size_t(numBlocks))
+            throw std::runtime_error("ZipConnector: number of blocks does not match the uncompressed size");
+
+        std::vector<size_t> blockOffsets(numBlocks);
+        size_t inPos = headerBytes;
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            blockOffsets[b] = inPos;
+            inPos += blockSizes[b];
+        }
+        if (inPos + trailerBytes > sizeIn)
+            throw std::runtime_error("ZipConnector: compressed block sizes exceed the input size");
+
+        Bytef* outBytes = (Bytef*) out;
+        const Bytef* inBytes = (const Bytef*) in;
+
+        std::vector<uLong> blockChecksums(numBlocks);
+        std::vector<int> blockErrors(numBlocks, Z_OK);
+
+        prepareStreams(inflateStreams);
+
+        #pragma omp parallel for
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            /* raw inflate, blocks do not contain a zlib header */
+            z_stream& strm = getInflateStream(inflateStreams[getThreadId()], -MAX_WBITS);
+            const size_t blockBytes = getBlockBytes(b, sizeOut);
+            Bytef* blockOut = outBytes + size_t(b) * blockSize;
+
+            strm.next_in = (Bytef*) inBytes + blockOffsets[b];
+            strm.avail_in = blockSizes[b];
+            strm.next_out = blockOut;
+            strm.avail_out = blockBytes;
+
+            const int ret = inflate(&strm, Z_SYNC_FLUSH);
+            const int expectedRet = (b == numBlocks - 1) ? Z_STREAM_END : Z_OK;
+            if (ret != expectedRet)
+                blockErrors[b] = ret;
+            else if (strm.avail_out != 0)
+                blockErrors[b] = Z_DATA_ERROR;
 
-        (void) inflateEnd(&strm);
-        return uncompressedBytes;
+            blockChecksums[b] = adler32(adler32(0L, Z_NULL, 0), blockOut, blockBytes);
+        }
+
+        for (int b = 0; b < numBlocks; ++b)
+            if (blockErrors[b] != Z_OK)
+                throw std::runtime_error(
+                    std::string("ZipConnector: inflate failed with error ") +
+                    std::to_string(blockErrors[b])
+                );
+
+        uLong checksum = adler32(0L, Z_NULL, 0);
+        for (int b = 0; b < numBlocks; ++b)
+            checksum = adler32_combine(checksum, blockChecksums[b], getBlockBytes(b, sizeOut));
+        if (checksum != readBigEndian32(inBytes + inPos))
+            throw std::runtime_error("ZipConnector: adler32 checksum mismatch");
+
+        return sizeOut;
     }
 
 private:
 
-};
+    /** z_stream with initialization state */
+    struct Stream
+    {
+        z_stream strm;
+        bool isInitialized;
+        /** compression level or window bits used for the initialization */
+        int parameter;
+
+        Stream() : isInitialized(false), parameter(0)
+        {
+            strm.zalloc = Z_NULL;
+            strm.zfree = Z_NULL;
+            strm.opaque = Z_NULL;
+        }
+    };
+
+    enum
+    {
+        headerBytes = 2,
+        trailerBytes = 4
+    };
+
+    static int getThreadId()
+    {
+#ifdef _OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+    }
+
+    /** provide one stream per thread, must be called outside of a parallel region */
+    static void prepareStreams(std::deque<Stream>& streams)
+    {
+#ifdef _OPENMP
+        const size_t numThreads = omp_get_max_threads();
+#else
+        const size_t numThreads = 1;
+#endif
+        if (streams.size() < numThreads)
+            streams.resize(numThreads);
+    }
+
+    z_stream& getDeflateStream(int compressLevel)
+    {
+        Stream& stream = deflateStreams[getThreadId()];
+        if (!stream.isInitialized)
+        {
+            /* raw deflate, header and checksum are written by compress() */
+            const int ret = deflateInit2(&stream.strm, compressLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            PMACC_ASSERT(ret == Z_OK);
+            stream.isInitialized = (ret == Z_OK);
+        }
+        else
+        {
+            (void) deflateReset(&stream.strm);
+            /* changing parameters is valid before any input was consumed */
+            if (stream.parameter != compressLevel)
+                (void) deflateParams(&stream.strm, compressLevel, Z_DEFAULT_STRATEGY);
+        }
+        stream.parameter = compressLevel;
+        return stream.strm;
+    }
+
+    static z_stream& getInflateStream(Stream& stream, int windowBits)
+    {
+        if (stream.isInitialized && stream.parameter != windowBits)
+        {
+            (void) inflateEnd(&stream.strm);
+            stream.isInitialized = false;
+        }
+        if (!stream.isInitialized)
+        {
+            stream.strm.next_in = Z_NULL;
+            stream.strm.avail_in = 0;
+            const int ret = inflateInit2(&stream.strm, windowBits);
+            PMACC_ASSERT(ret == Z_OK);
+            stream.isInitialized = (ret == Z_OK);
+            stream.parameter = windowBits;
+        }
+        else
+            (void) inflateReset(&stream.strm);
+        return stream.strm;
+    }
 
+    int getNumBlocks(size_t size) const
+    {
+        /* an empty input is stored as one empty block */
+        return size == 0 ? 1 : int((size + blockSize - 1) / blockSize);
+    }
+
+    size_t getBlockBytes(int block, size_t size) const
+    {
+        const size_t blockOffset = size_t(block) * blockSize;
+        return std::min(blockSize, size - blockOffset);
+    }
+
+    /** upper bound of the compressed size of one block
+     *
+     * ::compressBound() covers the deflate data and the zlib wrapper, the
+     * full flush adds an empty stored block (up to 6 byte).
+     */
+    static size_t getBlockBound(size_t bytes)
+    {
+        return ::compressBound(bytes) + 6;
+    }
+
+    /** zlib header (RFC 1950) with deflate, 32K window and no dictionary */
+    static void writeHeader(Bytef* out, int compressLevel)
+    {
+        int levelFlag = 3;
+        if (compressLevel == Z_DEFAULT_COMPRESSION || compressLevel == 6)
+            levelFlag = 2;
+        else if (compressLevel < 2)
+            levelFlag = 0;
+        else if (compressLevel < 6)
+            levelFlag = 1;
+
+        const unsigned int cmf = 0x78;
+        unsigned int flg = levelFlag << 6;
+        flg += 31 - (cmf * 256 + flg) % 31;
+        out[0] = Bytef(cmf);
+        out[1] = Bytef(flg);
+    }
+
+    static void writeBigEndian32(Bytef* out, uLong value)
+    {
+        out[0] = Bytef((value >> 24) & 0xFF);
+        out[1] = Bytef((value >> 16) & 0xFF);
+        out[2] = Bytef((value >> 8) & 0xFF);
+        out[3] = Bytef(value & 0xFF);
+    }
+
+    static uLong readBigEndian32(const Bytef* in)
+    {
+        return (uLong(in[0]) << 24) | (uLong(in[1]) << 16) | (uLong(in[2]) << 8) | uLong(in[3]);
+    }
+
+    size_t blockSize;
+    /* a z_stream must not be moved after its initialization, growing a
+     * deque keeps the existing elements in place
+     */
+    std::deque<Stream> deflateStreams;
+    std::deque<Stream> inflateStreams;
+    std::vector<size_t> compressedBlockSizes;
+};
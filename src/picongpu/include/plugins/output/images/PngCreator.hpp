@@ -31,7 +31,7 @@
 #include "memory/boxes/DataBox.hpp"
 #include "plugins/output/header/MessageHeader.hpp"
 
-#include <boost/thread.hpp>
+#include "plugins/output/images/PngEncoder.hpp"
 
 
 namespace picongpu
@@ -39,14 +39,20 @@ namespace picongpu
     using namespace PMacc;
 
 
+    /** write images as PNG files
+     *
+     * The image data is converted to PNG scanlines by the calling thread,
+     * compression and file output is done by the worker threads of
+     * PngEncoderPool. Therefore the input data can be reused directly after
+     * `operator()` returned.
+     */
     struct PngCreator
     {
 
         PngCreator(std::string name, std::string folder) :
             m_name(folder + "/" + name),
             m_folder(folder),
-            m_createFolder(true),
-            m_isThreadActive(false)
+            m_createFolder(true)
         {
         }
 
@@ -59,38 +65,24 @@ namespace picongpu
          *
          * take care that all resources used by `operator()`
          * can safely used without conflicts
+         *
+         * The input data is copied within `operator()`, nothing to wait for.
          */
         void join()
         {
-            if(m_isThreadActive)
-            {
-                workerThread.join();
-                m_isThreadActive = false;
-            }
         }
 
         ~PngCreator()
         {
-            if(m_isThreadActive)
-            {
-                workerThread.join();
-                m_isThreadActive = false;
-            }
-        }
-
-        PngCreator(const PngCreator& other)
-        {
-            m_name = other.m_name;
-            m_folder = other.m_folder;
-            m_createFolder = other.m_createFolder;
-            m_isThreadActive = false;
+            /* all images must be written before the simulation ends */
+            PngEncoderPool::getInstance().waitForAll();
         }
 
         /** create image
+         *
+         * blocks only if the queue of PngEncoderPool is full
          *
          * @param data input data for png
-         *             this object must be alive until destructor
-         *             of `PngCreator` or method `join()` is called
          * @param size size of data
          * @param header meta information about the simulation
          */
@@ -100,12 +92,7 @@ namespace picongpu
                         const Size2D size,
                         const MessageHeader  header)
         {
-            if(m_isThreadActive)
-            {
-                workerThread.join();
-            }
-            m_isThreadActive = true;
-            workerThread = boost::thread(&PngCreator::createImage<Box>, this, data, size, header);
+            createImage(data, size, header);
         }
 
     private:
@@ -118,12 +105,6 @@ namespace picongpu
         std::string m_name;
         std::string m_folder;
         bool m_createFolder;
-        /* boost::thread is not copy able,
-         * therefore we must define an own copy constructor
-         */
-        boost::thread workerThread;
-        /* status whether a thread is currently active */
-        bool m_isThreadActive;
 
     };
 
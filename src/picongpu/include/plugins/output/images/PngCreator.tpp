@@ -31,11 +31,9 @@
 #include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <boost/core/ignore_unused.hpp>
-
-#if( PIC_ENABLE_PNG == 1 )
-#   include <pngwriter.h>
-#endif
+#include <cmath>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
 
 namespace picongpu
 {
@@ -46,7 +44,6 @@ namespace picongpu
         const MessageHeader header
     )
     {
-#if( PIC_ENABLE_PNG == 1 )
         if ( m_createFolder )
         {
             Environment< simDim >::get( ).Filesystem( ).createDirectoryWithPermissions( m_folder );
@@ -57,23 +54,6 @@ namespace picongpu
         step << std::setw( 6 ) << std::setfill( '0' ) << header.sim.step;
         std::string filename( m_name + "_" + step.str( ) + ".png" );
 
-        pngwriter png( size.x( ), size.y( ), 0, filename.c_str( ) );
-
-        /* default compression: 6
-         * zlib level 1 is ~12% bigger but ~2.3x faster in write_png( )
-         */
-        png.setcompressionlevel( 1 );
-
-        //PngWriter coordinate system begin with 1,1
-        for( int y = 0; y < size.y( ); ++y)
-        {
-            for( int x = 0; x < size.x( ); ++x )
-            {
-                float3_X p = data[ y ][ x ];
-                png.plot( x + 1, size.y( ) - y, p.x( ), p.y( ), p.z( ) );
-            }
-        }
-
         /* scale the image by a user defined relative factor
          * `scale_image` is defined in `visualization.param`
          */
@@ -91,11 +71,56 @@ namespace picongpu
         /* to prevent artifacts scale only, if at least one of scale_x and
          * scale_y is != 1.0
          */
-        if( ( scale_x != float_X( 1.0 ) ) ||
-            ( scale_y != float_X( 1.0 ) )
-        )
-            //process the cell size and by factor scaling within one step
-            png.scale_kxky( scale_x, scale_y );
+        const bool isScaled = ( scale_x != float_X( 1.0 ) ) ||
+            ( scale_y != float_X( 1.0 ) );
+
+        Size2D imageSize( size );
+        if( isScaled )
+        {
+            imageSize.x( ) = int( std::ceil( scale_x * float_X( size.x( ) ) ) );
+            imageSize.y( ) = int( std::ceil( scale_y * float_X( size.y( ) ) ) );
+        }
+
+        boost::shared_ptr< PngImage > png( new PngImage( imageSize.x( ), imageSize.y( ) ) );
+
+        /* the first row of data is the top row of the image
+         * each row is filled and filtered independently
+         */
+        #pragma omp parallel for
+        for( int y = 0; y < imageSize.y( ); ++y )
+        {
+            uint8_t* row = png->getRow( y );
+            if( !isScaled )
+            {
+                for( int x = 0; x < imageSize.x( ); ++x )
+                {
+                    float3_X p = data[ y ][ x ];
+                    png->setPixel( row, x, p.x( ), p.y( ), p.z( ) );
+                }
+            }
+            else
+            {
+                /* bilinear interpolation at the center of the scaled pixel */
+                const float_X srcY = ( float_X( y ) + float_X( 0.5 ) ) * float_X( size.y( ) ) / float_X( imageSize.y( ) ) - float_X( 0.5 );
+                const int y0 = std::max( 0, std::min( int( std::floor( srcY ) ), size.y( ) - 1 ) );
+                const int y1 = std::min( y0 + 1, size.y( ) - 1 );
+                const float_X wy = std::max( float_X( 0.0 ), std::min( srcY - float_X( y0 ), float_X( 1.0 ) ) );
+
+                for( int x = 0; x < imageSize.x( ); ++x )
+                {
+                    const float_X srcX = ( float_X( x ) + float_X( 0.5 ) ) * float_X( size.x( ) ) / float_X( imageSize.x( ) ) - float_X( 0.5 );
+                    const int x0 = std::max( 0, std::min( int( std::floor( srcX ) ), size.x( ) - 1 ) );
+                    const int x1 = std::min( x0 + 1, size.x( ) - 1 );
+                    const float_X wx = std::max( float_X( 0.0 ), std::min( srcX - float_X( x0 ), float_X( 1.0 ) ) );
+
+                    const float3_X top = data[ y0 ][ x0 ] * ( float_X( 1.0 ) - wx ) + data[ y0 ][ x1 ] * wx;
+                    const float3_X bottom = data[ y1 ][ x0 ] * ( float_X( 1.0 ) - wx ) + data[ y1 ][ x1 ] * wx;
+                    const float3_X p = top * ( float_X( 1.0 ) - wy ) + bottom * wy;
+                    png->setPixel( row, x, p.x( ), p.y( ), p.z( ) );
+                }
+            }
+            png->filterRow( y );
+        }
 
         // add some meta information
         //header.writeToConsole( std::cout );
@@ -103,20 +128,14 @@ namespace picongpu
         std::ostringstream description( std::ostringstream::out );
         header.writeToConsole( description );
 
-        char title[ ] = "PIConGPU preview image";
-        std::string author = Environment<>::get().SimulationDescription().getAuthor( );
-        char software[ ] = "PIConGPU with PNGwriter";
-
-        png.settext( title, author.c_str( ), description.str( ).c_str( ), software );
-
-        // write to disk and close object
-        png.close( );
-#else
-        boost::ignore_unused( data, size, header );
-        /* always fail with an exception at runtime */
-        PMACC_VERIFY_MSG( false, "not allowed to call createImage (missing dependency PNGwriter)" );
-#endif
+        png->fileName = filename;
+        png->title = "PIConGPU preview image";
+        png->author = Environment<>::get().SimulationDescription().getAuthor( );
+        png->description = description.str( );
+        png->software = "PIConGPU";
 
+        // compress and write to disk in the background
+        PngEncoderPool::getInstance( ).push( png );
     }
 
 } /* namespace picongpu */
@@ -641,7 +641,8 @@ public:
 
             bool isDrawing = doDrawing();
             isMaster = gather.init(isDrawing);
-            reduce.participate(isDrawing);
+            /* the communicator is needed with the first reduce only */
+            reduce.participateAsync(isDrawing);
 
             /* create memory for the local picture if the gpu participate on the visualization */
             if(isDrawing)
@@ -37,6 +37,7 @@
 
 #include "plugins/output/compression/ZipConnector.hpp"
 #include <sstream>
+#include <vector>
 
 namespace picongpu
 {
@@ -103,15 +104,19 @@ public:
     {
         if (connectOK)
         {
-            char* tmp = new char[size];
+            const size_t dataSize = size - MessageHeader::bytes;
+            /* reuse the send buffer of the previous message if it is large enough */
+            const size_t neededSize = MessageHeader::bytes + zip.compressBound(dataSize);
+            if (sendBuffer.size() < neededSize)
+                sendBuffer.resize(neededSize);
+            char* tmp = &sendBuffer[0];
             memcpy(tmp, array, sizeof(MessageHeader));
 
-            ZipConnector zip;
-            size_t zipedSize = zip.compress(tmp + MessageHeader::bytes, ((char*) array) + MessageHeader::bytes, size - MessageHeader::bytes, 6);
+            size_t zipedSize = zip.compress(tmp + MessageHeader::bytes, neededSize - MessageHeader::bytes,
+                                            ((char*) array) + MessageHeader::bytes, dataSize, 6);
             MessageHeader* header = (MessageHeader*) tmp;
             header->data.byte = (uint32_t) zipedSize;
             write(SocketFD, tmp, zipedSize + MessageHeader::bytes);
-            __deleteArray(tmp);
         }
     }
 
@@ -129,6 +134,9 @@ private:
     int Res;
     int SocketFD;
     bool connectOK;
+    /* keeps the compression state of all threads between messages */
+    ZipConnector zip;
+    std::vector<char> sendBuffer;
 
 };
 
@@ -27,13 +27,13 @@
 #include "plugins/ISimulationPlugin.hpp"
 #include "cuSTL/container/DeviceBuffer.hpp"
 #include "cuSTL/container/HostBuffer.hpp"
-#include "cuSTL/algorithm/kernel/Foreach.hpp"
-#include "cuSTL/cursor/MultiIndexCursor.hpp"
 #include "cuSTL/algorithm/mpi/Reduce.hpp"
 #include "cuSTL/algorithm/host/Foreach.hpp"
 #include "particles/policies/ExchangeParticles.hpp"
 #include "math/Vector.hpp"
 #include "algorithms/math.hpp"
+#include "algorithms/histogram/Histogram.hpp"
+#include "mappings/kernel/AreaMapping.hpp"
 #include <boost/shared_ptr.hpp>
 
 /* libSplash data output */
@@ -90,8 +90,9 @@ private:
     typedef PMacc::container::DeviceBuffer<float_X, DIM3> DBufCalorimeter;
     typedef PMacc::container::HostBuffer<float_X, DIM3> HBufCalorimeter;
 
-    /* device calorimeter buffer for a single gpu */
-    DBufCalorimeter* dBufCalorimeter;
+    /* calorimeter of the particles of a single gpu, bins are linearized [energy][pitch][yaw] */
+    typedef algorithms::histogram::Histogram<algorithms::histogram::accumulation::Floating<float_X> > CalorimeterHistogram;
+    CalorimeterHistogram* calorimeterHistogram;
     /* device calorimeter buffer for all particles which have left the simulation volume  */
     DBufCalorimeter* dBufLeftParsCalorimeter;
     /* host calorimeter buffer for a single mpi rank */
@@ -245,10 +246,10 @@ private:
         this->maxEnergy = maxEnergy_SI / UNIT_ENERGY;
 
         /* allocate memory buffers */
-        this->dBufCalorimeter = new DBufCalorimeter(this->numBinsYaw, this->numBinsPitch, this->numBinsEnergy);
-        this->dBufLeftParsCalorimeter = new DBufCalorimeter(this->dBufCalorimeter->size());
-        this->hBufCalorimeter = new HBufCalorimeter(this->dBufCalorimeter->size());
-        this->hBufTotalCalorimeter = new HBufCalorimeter(this->dBufCalorimeter->size());
+        this->calorimeterHistogram = new CalorimeterHistogram(this->numBinsYaw * this->numBinsPitch * this->numBinsEnergy);
+        this->dBufLeftParsCalorimeter = new DBufCalorimeter(this->numBinsYaw, this->numBinsPitch, this->numBinsEnergy);
+        this->hBufCalorimeter = new HBufCalorimeter(this->dBufLeftParsCalorimeter->size());
+        this->hBufTotalCalorimeter = new HBufCalorimeter(this->dBufLeftParsCalorimeter->size());
 
         /* fill calorimeter for left particles with zero */
         this->dBufLeftParsCalorimeter->assign(float_X(0.0));
@@ -306,7 +307,7 @@ private:
         if(this->notifyPeriod == 0)
             return;
 
-        __delete(this->dBufCalorimeter);
+        __delete(this->calorimeterHistogram);
         __delete(this->dBufLeftParsCalorimeter);
         __delete(this->hBufCalorimeter);
         __delete(this->hBufTotalCalorimeter);
@@ -409,7 +410,7 @@ public:
         notifyPeriod(0),
         cellDescription(NULL),
         leftParticlesDatasetName("calorimeterLeftParticles"),
-        dBufCalorimeter(NULL),
+        calorimeterHistogram(NULL),
         dBufLeftParsCalorimeter(NULL),
         hBufCalorimeter(NULL),
         hBufTotalCalorimeter(NULL)
@@ -420,39 +421,30 @@ public:
 
     void notify(uint32_t currentStep)
     {
-        /* initialize calorimeter with already detected particles */
-        *this->dBufCalorimeter = *this->dBufLeftParsCalorimeter;
-
-        /* data is written to dBufCalorimeter */
-        this->calorimeterFunctor->setCalorimeterCursor(this->dBufCalorimeter->origin());
-
-        /* create kernel functor instance */
         DataConnector &dc = Environment<>::get().DataConnector();
         ParticlesType* particles = &(dc.getData<ParticlesType > (ParticlesType::FrameType::getName(), true));
 
-        ParticleCalorimeterKernel<typename ParticlesType::ParticlesBoxType,
-                                  MyCalorimeterFunctor>
-                                  particleCalorimeterKernel(particles->getDeviceParticlesBox(),
-                                                            *this->calorimeterFunctor);
-
-        /* create zone */
-        typedef typename MappingDesc::SuperCellSize SuperCellSize;
-
-        const PMacc::math::Int<simDim> coreBorderGuardSuperCells = this->cellDescription->getGridSuperCells();
-        const uint32_t guardSuperCells = this->cellDescription->getGuardingSuperCells();
-        const PMacc::math::Int<simDim> coreBorderSuperCells = coreBorderGuardSuperCells - 2*guardSuperCells;
-
-        /* this zone represents the core+border area with guard offset in unit of cells */
-        const zone::SphericZone<simDim> zone(
-            static_cast<PMacc::math::Size_t<simDim> >(coreBorderSuperCells * SuperCellSize::toRT()),
-            guardSuperCells * SuperCellSize::toRT());
-
-        /* kernel call */
-        algorithm::kernel::Foreach<SuperCellSize> foreach;
-        foreach(zone, cursor::make_MultiIndexCursor<simDim>(), particleCalorimeterKernel);
-
-        /* copy to host */
-        *this->hBufCalorimeter = *this->dBufCalorimeter;
+        /* histogram of all particles of the core and border */
+        this->calorimeterHistogram->reset();
+        AreaMapping<CORE + BORDER, MappingDesc> mapper(*this->cellDescription);
+        PMACC_KERNEL(KernelParticleCalorimeterHistogram{})
+                (mapper.getGridDim(), mapper.getSuperCellSize(), this->calorimeterHistogram->getSharedMemBytes())
+                (particles->getDeviceParticlesBox(),
+                 (MyCalorimeterFunctor)*this->calorimeterFunctor,
+                 this->calorimeterHistogram->getDeviceHistogram(),
+                 mapper);
+
+        const float_64* calorimeterBins = this->calorimeterHistogram->merge();
+
+        /* initialize calorimeter with already detected particles and add the histogram */
+        *this->hBufCalorimeter = *this->dBufLeftParsCalorimeter;
+        for(uint32_t energyBin = 0; energyBin < this->numBinsEnergy; ++energyBin)
+            for(uint32_t pitchBin = 0; pitchBin < this->numBinsPitch; ++pitchBin)
+                for(uint32_t yawBin = 0; yawBin < this->numBinsYaw; ++yawBin)
+                {
+                    const uint32_t bin = yawBin + this->numBinsYaw * (pitchBin + this->numBinsPitch * energyBin);
+                    *this->hBufCalorimeter->origin()(yawBin, pitchBin, energyBin) += float_X(calorimeterBins[bin]);
+                }
 
         /* mpi reduce */
         using namespace lambda;
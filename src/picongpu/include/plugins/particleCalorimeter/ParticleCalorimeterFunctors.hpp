@@ -80,8 +80,15 @@ struct CalorimeterFunctor
         this->calorimeterCur = calorimeterCur;
     }
 
+    /** bin and energy of a particle
+     *
+     * @param bin linear index of the calorimeter bin (yaw is the fastest index, energy the slowest)
+     * @param value energy in units of TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE particles
+     * @return false if the particle does not hit the calorimeter
+     */
     template<typename ParticlesFrame>
-    DINLINE void operator()(ParticlesFrame& particlesFrame, const uint32_t linearThreadIdx)
+    DINLINE bool getBin(ParticlesFrame& particlesFrame, const uint32_t linearThreadIdx,
+                        uint32_t& bin, float_X& value) const
     {
         const float3_X mom = particlesFrame[linearThreadIdx][momentum_];
         const float_X mom2 = math::dot(mom, mom);
@@ -98,117 +105,63 @@ struct CalorimeterFunctor
         const float_X yaw = atan2(dirVec.x(), dirVec.y());
         const float_X pitch = asin(dirVec.z());
 
-        if(abs(yaw) < this->maxYaw && abs(pitch) < this->maxPitch)
+        if(!(abs(yaw) < this->maxYaw && abs(pitch) < this->maxPitch))
+            return false;
+
+        const float2_X calorimeterPos = particleCalorimeter::mapYawPitchToNormedRange(
+            yaw, pitch, this->maxYaw, this->maxPitch);
+
+        // yaw
+        int32_t yawBin = calorimeterPos.x() * static_cast<float_X>(numBinsYaw);
+        // catch out-of-range values
+        yawBin = yawBin >= numBinsYaw ? numBinsYaw - 1 : yawBin;
+        yawBin = yawBin < 0 ? 0 : yawBin;
+
+        // pitch
+        int32_t pitchBin = calorimeterPos.y() * static_cast<float_X>(numBinsPitch);
+        // catch out-of-range values
+        pitchBin = pitchBin >= numBinsPitch ? numBinsPitch - 1 : pitchBin;
+        pitchBin = pitchBin < 0 ? 0 : pitchBin;
+
+        // energy
+        const float_X weighting = particlesFrame[linearThreadIdx][weighting_];
+        const float_X normedWeighting = weighting /
+                                        static_cast<float_X>(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
+        const auto particle = particlesFrame[linearThreadIdx];
+        const float_X mass = attribute::getMass(weighting, particle);
+        const float_X energy = KinEnergy<>()(mom, mass) / weighting;
+
+        int32_t energyBin = 0;
+        if(this->numBinsEnergy > 1)
         {
-            const float2_X calorimeterPos = particleCalorimeter::mapYawPitchToNormedRange(
-                yaw, pitch, this->maxYaw, this->maxPitch);
-
-            // yaw
-            int32_t yawBin = calorimeterPos.x() * static_cast<float_X>(numBinsYaw);
-            // catch out-of-range values
-            yawBin = yawBin >= numBinsYaw ? numBinsYaw - 1 : yawBin;
-            yawBin = yawBin < 0 ? 0 : yawBin;
-
-            // pitch
-            int32_t pitchBin = calorimeterPos.y() * static_cast<float_X>(numBinsPitch);
-            // catch out-of-range values
-            pitchBin = pitchBin >= numBinsPitch ? numBinsPitch - 1 : pitchBin;
-            pitchBin = pitchBin < 0 ? 0 : pitchBin;
-
-            // energy
-            const float_X weighting = particlesFrame[linearThreadIdx][weighting_];
-            const float_X normedWeighting = weighting /
-                                            static_cast<float_X>(particles::TYPICAL_NUM_PARTICLES_PER_MACROPARTICLE);
-            const auto particle = particlesFrame[linearThreadIdx];
-            const float_X mass = attribute::getMass(weighting, particle);
-            const float_X energy = KinEnergy<>()(mom, mass) / weighting;
-
-            int32_t energyBin = 0;
-            if(this->numBinsEnergy > 1)
-            {
-                const int32_t numBinsOutOfRange = 2;
-                energyBin = math::float2int_rd(((logScale ? log10(energy) : energy) - minEnergy) /
-                    (maxEnergy - minEnergy) * static_cast<float_X>(this->numBinsEnergy - numBinsOutOfRange)) + 1;
-
-                // all entries larger than maxEnergy go into last bin
-                energyBin = energyBin < this->numBinsEnergy ? energyBin : this->numBinsEnergy - 1;
-
-                // all entries smaller than minEnergy go into bin zero
-                energyBin = energyBin > 0 ? energyBin : 0;
-            }
-
-            atomicAddWrapper(&(*this->calorimeterCur(yawBin, pitchBin, energyBin)),
-                             energy * normedWeighting);
-        }
-    }
-};
-
-
-template<typename T_ParticlesBox, typename T_CalorimeterFunctor>
-struct ParticleCalorimeterKernel
-{
-    typedef T_ParticlesBox ParticlesBox;
-    typedef T_CalorimeterFunctor CalorimeterFunctor;
-
-    ParticlesBox particlesBox;
-    CalorimeterFunctor calorimeterFunctor;
-
-    ParticleCalorimeterKernel(ParticlesBox particlesBox,
-                           CalorimeterFunctor calorimeterFunctor) :
-        particlesBox(particlesBox),
-        calorimeterFunctor(calorimeterFunctor)
-    {}
-
-    DINLINE void operator()(const PMacc::math::Int<simDim>& cellIndex)
-    {
-        /* definitions for domain variables, like indices of blocks and threads */
-        typedef typename MappingDesc::SuperCellSize SuperCellSize;
+            const int32_t numBinsOutOfRange = 2;
+            energyBin = math::float2int_rd(((logScale ? log10(energy) : energy) - minEnergy) /
+                (maxEnergy - minEnergy) * static_cast<float_X>(this->numBinsEnergy - numBinsOutOfRange)) + 1;
 
-        /* multi-dimensional offset vector from local domain origin on GPU in units of super cells */
-        const PMacc::math::Int<simDim> block = cellIndex / SuperCellSize::toRT();
+            // all entries larger than maxEnergy go into last bin
+            energyBin = energyBin < this->numBinsEnergy ? energyBin : this->numBinsEnergy - 1;
 
-        /* multi-dim offset from the origin of the local domain on GPU
-         * to the origin of the block of the in unit of cells
-         */
-        const PMacc::math::Int<simDim> blockCell = block * SuperCellSize::toRT();
-
-        /* multi-dim vector from origin of the block to a cell in units of cells */
-        const PMacc::math::Int<simDim> threadIndex = cellIndex % SuperCellSize::toRT();
-
-        /* conversion from a multi-dim cell coordinate to a linear coordinate of the cell in its super cell */
-        const int linearThreadIdx = PMacc::math::linearize(
-            PMacc::math::CT::shrinkTo<SuperCellSize, simDim-1>::type::toRT(),
-            threadIndex);
-
-        typedef typename ParticlesBox::FramePtr ParticlesFramePtr;
-        PMACC_SMEM( particlesFrame, ParticlesFramePtr );
-
-        /* find last frame in super cell
-         */
-        if (linearThreadIdx == 0)
-        {
-            particlesFrame = this->particlesBox.getLastFrame(block);
+            // all entries smaller than minEnergy go into bin zero
+            energyBin = energyBin > 0 ? energyBin : 0;
         }
 
-        __syncthreads();
+        bin = yawBin + numBinsYaw * (pitchBin + numBinsPitch * energyBin);
+        value = energy * normedWeighting;
+        return true;
+    }
 
-        while(particlesFrame.isValid())
+    /** add a particle directly to the calorimeter cursor */
+    template<typename ParticlesFrame>
+    DINLINE void operator()(ParticlesFrame& particlesFrame, const uint32_t linearThreadIdx)
+    {
+        uint32_t bin;
+        float_X value;
+        if(getBin(particlesFrame, linearThreadIdx, bin, value))
         {
-            /* casting uint8_t multiMask to boolean */
-            const bool isParticle = particlesFrame[linearThreadIdx][multiMask_];
-
-            if(isParticle)
-            {
-                calorimeterFunctor(particlesFrame, linearThreadIdx);
-            }
-
-            __syncthreads();
-
-            if (linearThreadIdx == 0)
-            {
-                particlesFrame = this->particlesBox.getPreviousFrame(particlesFrame);
-            }
-            __syncthreads();
+            const uint32_t yawBin = bin % numBinsYaw;
+            const uint32_t pitchBin = (bin / numBinsYaw) % numBinsPitch;
+            const uint32_t energyBin = bin / (numBinsYaw * numBinsPitch);
+            atomicAddWrapper(&(*this->calorimeterCur(yawBin, pitchBin, energyBin)), value);
         }
     }
 };
@@ -45,6 +45,7 @@
 #include "sys/stat.h"
 
 #include "plugins/radiation/Radiation.kernel"
+#include "plugins/radiation/tableFile.hpp"
 
 /* libSplash data output */
 #include <splash/splash.h>
@@ -102,9 +103,34 @@ private:
      *   omega_1(theta_2),omega_2(theta_2),...,omega_N-omega(theta_N-theta)]
      */
     GridBuffer<Amplitude, DIM1> *radiation;
+
+    /**
+     * Spectral backend `fft` only: real amplitudes spread onto a grid of
+     * retarded times, layout [observer][sample]. The grid is transformed
+     * into `radiation` if it is full and before the amplitudes are read.
+     */
+    GridBuffer<vector_64, DIM1> *timeSamples;
+    radiationSpectral::TimeDomainSpectrum *timeDomainSpectrum;
+    std::string spectralBackend;
+    uint32_t numTimeSamples;
+    /* retarded time of the first grid point */
+    float_64 timeSamplesBegin;
+    bool hasTimeSamples;
+
     radiation_frequencies::InitFreqFunctor freqInit;
     radiation_frequencies::FreqFunctor freqFkt;
 
+    /**
+     * Number of frequencies and observers, known after pluginLoad().
+     * A frequency list (`.omegaList`) or an observer list (`.observerList`)
+     * overwrites N_omega and N_observer of the param files.
+     */
+    uint32_t numFrequencies;
+    uint32_t numObservers;
+
+    /** observation direction of all observers (unit vectors), read by the kernels */
+    GridBuffer<vector_64, DIM1> *observerDirections;
+
     MappingDesc *cellDescription;
     uint32_t notifyFrequency;
     uint32_t dumpPeriod;
@@ -114,20 +140,26 @@ private:
     std::string speciesName;
     std::string pluginName;
     std::string pluginPrefix;
-    std::string filename_prefix;
-    bool totalRad;
     bool lastRad;
-    std::string folderLastRad;
-    std::string folderTotalRad;
-    std::string pathOmegaList;
     bool radPerGPU;
     std::string folderRadPerGPU;
     DataSpace<simDim> lastGPUpos;
+    std::string pathOmegaList;
+    std::string pathObserverList;
+
+    /**
+     * Each rank owns the observers [observerOffset, observerOffset + numLocalObservers).
+     * The amplitudes of all ranks are summed with a reduce-scatter, each rank
+     * receives and writes the slab of its observers.
+     */
+    uint32_t observerOffset;
+    uint32_t numLocalObservers;
+    /* number of float_64 received by each rank in the reduce-scatter */
+    std::vector<int> slabElements;
 
     /**
      * Data structure for storage and summation of the intermediate values of
-     * the calculated Amplitude from every host for every direction and
-     * frequency.
+     * the calculated Amplitude of the local observers for every frequency.
      */
     Amplitude* timeSumArray;
     Amplitude *tmp_result;
@@ -135,6 +167,9 @@ private:
     float_64* detectorFrequencies;
 
     bool isMaster;
+    MPI_Comm mpiComm;
+    int mpiRank;
+    int mpiSize;
 
     uint32_t currentStep;
     uint32_t lastStep;
@@ -143,7 +178,6 @@ private:
     std::string meshesPathName;
     std::string particlesPathName;
 
-    mpi::MPIReduce reduce;
     bool compressionOn;
     static const int numberMeshRecords = 3;
 
@@ -153,21 +187,32 @@ public:
     pluginName("Radiation: calculate the radiation of a species"),
     speciesName(ParticlesType::FrameType::getName()),
     pluginPrefix(speciesName + std::string("_radiation")),
-    filename_prefix(pluginPrefix),
     particles(NULL),
     radiation(NULL),
+    timeSamples(NULL),
+    timeDomainSpectrum(NULL),
+    numTimeSamples(0),
+    timeSamplesBegin(0.0),
+    hasTimeSamples(false),
+    numFrequencies(0),
+    numObservers(0),
+    observerDirections(NULL),
     cellDescription(NULL),
     notifyFrequency(0),
     dumpPeriod(0),
-    totalRad(false),
     lastRad(false),
+    radPerGPU(false),
+    observerOffset(0),
+    numLocalObservers(0),
     timeSumArray(NULL),
     tmp_result(NULL),
     detectorPositions(NULL),
     detectorFrequencies(NULL),
     isMaster(false),
+    mpiComm(MPI_COMM_NULL),
+    mpiRank(0),
+    mpiSize(1),
     currentStep(0),
-    radPerGPU(false),
     lastStep(0),
     meshesPathName("DetectorMesh/"),
     particlesPathName("DetectorParticle/"),
@@ -218,16 +263,16 @@ public:
         desc.add_options()
             ((pluginPrefix + ".period").c_str(), po::value<uint32_t > (&notifyFrequency), "enable plugin [for each n-th step]")
             ((pluginPrefix + ".dump").c_str(), po::value<uint32_t > (&dumpPeriod)->default_value(0), "dump integrated radiation from last dumped step [for each n-th step] (0 = only print data at end of simulation)")
-            ((pluginPrefix + ".lastRadiation").c_str(), po::bool_switch(&lastRad), "enable calculation of integrated radiation from last dumped step")
-            ((pluginPrefix + ".folderLastRad").c_str(), po::value<std::string > (&folderLastRad)->default_value("lastRad"), "folder in which the integrated radiation from last dumped step is written")
-            ((pluginPrefix + ".totalRadiation").c_str(), po::bool_switch(&totalRad), "enable calculation of integrated radiation from start of simulation")
-            ((pluginPrefix + ".folderTotalRad").c_str(), po::value<std::string > (&folderTotalRad)->default_value("totalRad"), "folder in which the integrated radiation from start of simulation is written")
+            ((pluginPrefix + ".lastRadiation").c_str(), po::bool_switch(&lastRad), "enable output of the integrated radiation from last dumped step (radiationHDF5/<species>_radLastAmplitudes_<step>.h5)")
             ((pluginPrefix + ".start").c_str(), po::value<uint32_t > (&radStart)->default_value(2), "time index when radiation should start with calculation")
             ((pluginPrefix + ".end").c_str(), po::value<uint32_t > (&radEnd)->default_value(0), "time index when radiation should end with calculation")
             ((pluginPrefix + ".omegaList").c_str(), po::value<std::string > (&pathOmegaList)->default_value("_noPath_"), "path to file containing all frequencies to calculate")
-            ((pluginPrefix + ".radPerGPU").c_str(), po::bool_switch(&radPerGPU), "enable radiation output from each GPU individually")
+            ((pluginPrefix + ".radPerGPU").c_str(), po::bool_switch(&radPerGPU), "enable radiation output from each GPU individually (text, not summed over the ranks)")
             ((pluginPrefix + ".folderRadPerGPU").c_str(), po::value<std::string > (&folderRadPerGPU)->default_value("radPerGPU"), "folder in which the radiation of each GPU is written")
-            ((pluginPrefix + ".compression").c_str(), po::bool_switch(&compressionOn), "enable compression of hdf5 output");
+            ((pluginPrefix + ".observerList").c_str(), po::value<std::string > (&pathObserverList)->default_value("_noPath_"), "path to file containing the observation directions (x y z per line), overwrites radiation_observer::observation_direction")
+            ((pluginPrefix + ".compression").c_str(), po::bool_switch(&compressionOn), "enable compression of hdf5 output")
+            ((pluginPrefix + ".spectralBackend").c_str(), po::value<std::string > (&spectralBackend)->default_value("dft"), "spectrum calculation: dft (direct sum for each frequency) or fft (retarded time grid, transformed on the host)")
+            ((pluginPrefix + ".timeSamples").c_str(), po::value<uint32_t > (&numTimeSamples)->default_value(16384), "spectralBackend fft: retarded time grid points per observer (power of two)");
     }
 
 
@@ -249,14 +294,10 @@ public:
         if(notifyFrequency == 0)
             return;
 
-        if(isMaster)
-        {
-            // this will lead to wrong lastRad output right after the checkpoint if the restart point is
-            // not a dump point. The correct lastRad data can be reconstructed from hdf5 data
-            // since text based lastRad output will be obsolete soon, this is not a problem
-            readHDF5file(timeSumArray, restartDirectory + "/" + speciesName + std::string("_radRestart_"), timeStep);
-            log<radLog::SIMULATION_STATE > ("Radiation (%1%): restart finished") % speciesName;
-        }
+        // this will lead to wrong lastRad output right after the checkpoint if the restart point is
+        // not a dump point. The correct lastRad data can be reconstructed from hdf5 data
+        readHDF5file(timeSumArray, restartDirectory + "/" + speciesName + std::string("_radRestart"), timeStep);
+        log<radLog::SIMULATION_STATE > ("Radiation (%1%): restart finished") % speciesName;
     }
 
 
@@ -266,16 +307,13 @@ public:
         if(notifyFrequency == 0)
             return;
 
-        // collect data GPU -> CPU -> Master
+        // collect data GPU -> CPU -> observer slabs
         copyRadiationDeviceToHost();
-        collectRadiationOnMaster();
+        collectRadiationSlabs();
         sumAmplitudesOverTime(tmp_result, timeSumArray);
 
         // write backup file
-        if (isMaster)
-        {
-            writeHDF5file(tmp_result, restartDirectory + "/" + speciesName + std::string("_radRestart_"));
-        }
+        writeHDF5file(tmp_result, restartDirectory + "/" + speciesName + std::string("_radRestart"));
     }
 
 
@@ -284,80 +322,81 @@ private:
     /**
      * The plugin is loaded on every MPI rank, and therefor this function is
      * executed on every MPI rank.
-     * One host with MPI rank 0 is defined to be the master.
-     * It creates a folder where all the
-     * results are saved and, depending on the type of radiation calculation,
-     * creates an additional data structure for the summation of all
-     * intermediate values.
+     * The observers are distributed in contiguous slabs over all ranks,
+     * each rank sums and writes the amplitudes of its slab.
+     * One host with MPI rank 0 is defined to be the master, it creates the
+     * output folder.
      * On every host data structure for storage of the calculated radiation
      * is created.       */
     void pluginLoad()
     {
-        // allocate memory for all amplitudes for temporal data collection
-        tmp_result = new Amplitude[elements_amplitude()];
-
         if (notifyFrequency > 0)
         {
-            /*only rank 0 create a file*/
-            isMaster = reduce.hasResult(mpi::reduceMethods::Reduce());
-
-            radiation = new GridBuffer<Amplitude, DIM1 > (DataSpace<DIM1 > (elements_amplitude())); //create one int on GPU and host
+            mpiComm = Environment<simDim>::get().GridController().getCommunicator().getMPIComm();
+            MPI_CHECK(MPI_Comm_rank(mpiComm, &mpiRank));
+            MPI_CHECK(MPI_Comm_size(mpiComm, &mpiSize));
+            isMaster = (mpiRank == 0);
 
             freqInit.Init(pathOmegaList);
             freqFkt = freqInit.getFunctor();
+            numFrequencies = freqInit.getNumFrequencies();
+            initObserverDirections();
+
+            /* block distribution, the first ranks get one observer more */
+            slabElements.resize(mpiSize);
+            for (int rank = 0; rank < mpiSize; ++rank)
+            {
+                const uint32_t observers = numObservers / mpiSize +
+                    (uint32_t(rank) < numObservers % mpiSize ? 1u : 0u);
+                slabElements[rank] = observers * numFrequencies * Amplitude::numComponents;
+                if (rank < mpiRank)
+                    observerOffset += observers;
+                if (rank == mpiRank)
+                    numLocalObservers = observers;
+            }
+
+            // allocate memory for the amplitudes of the local observers
+            tmp_result = new Amplitude[elements_local_amplitude()];
+            timeSumArray = new Amplitude[elements_local_amplitude()];
+            for (unsigned int i = 0; i < elements_local_amplitude(); ++i)
+                timeSumArray[i] = Amplitude::zero();
+
+            radiation = new GridBuffer<Amplitude, DIM1 > (DataSpace<DIM1 > (elements_amplitude())); //create one int on GPU and host
+
+            if (spectralBackend == "fft")
+                initTimeDomainSpectrum();
+            else if (spectralBackend != "dft")
+                throw std::runtime_error(std::string("Radiation: unknown spectral backend ") + spectralBackend);
 
 
             Environment<>::get().PluginConnector().setNotificationPeriod(this, notifyFrequency);
             PMacc::Filesystem<simDim>& fs = Environment<simDim>::get().Filesystem();
 
-            if (isMaster)
+            /* save detector position / observation direction of the local observers */
+            detectorPositions = new vector_64[numLocalObservers];
+            for(uint32_t detectorIndex=0; detectorIndex < numLocalObservers; ++detectorIndex)
             {
-                timeSumArray = new Amplitude[elements_amplitude()];
-
-                /* save detector position / observation direction */
-                detectorPositions = new vector_64[parameters::N_observer];
-                for(uint32_t detectorIndex=0; detectorIndex < parameters::N_observer; ++detectorIndex)
-                {
-                    detectorPositions[detectorIndex] = radiation_observer::observation_direction(detectorIndex);
-                }
-
-                /* save detector frequencies */
-                detectorFrequencies = new float_64[radiation_frequencies::N_omega];
-                for(uint32_t detectorIndex=0; detectorIndex < radiation_frequencies::N_omega; ++detectorIndex)
-                {
-                    detectorFrequencies[detectorIndex] = freqFkt(detectorIndex);
-                }
+                detectorPositions[detectorIndex] = observerDirections->getHostBuffer().getDataBox()[observerOffset + detectorIndex];
+            }
 
+            /* save detector frequencies */
+            detectorFrequencies = new float_64[numFrequencies];
+            for(uint32_t detectorIndex=0; detectorIndex < numFrequencies; ++detectorIndex)
+            {
+                detectorFrequencies[detectorIndex] = freqInit.getFrequency(detectorIndex);
             }
 
-            if (isMaster && totalRad)
+            if (isMaster)
             {
                 fs.createDirectory("radiationHDF5");
                 fs.setDirectoryPermissions("radiationHDF5");
             }
 
-
             if (isMaster && radPerGPU)
             {
                 fs.createDirectory(folderRadPerGPU);
                 fs.setDirectoryPermissions(folderRadPerGPU);
             }
-
-            if (isMaster && totalRad)
-            {
-                //create folder for total output
-                fs.createDirectory(folderTotalRad);
-                fs.setDirectoryPermissions(folderTotalRad);
-                for (unsigned int i = 0; i < elements_amplitude(); ++i)
-                    timeSumArray[i] = Amplitude::zero();
-            }
-            if (isMaster && lastRad)
-            {
-                //create folder for total output
-                fs.createDirectory(folderLastRad);
-                fs.setDirectoryPermissions(folderLastRad);
-            }
-
         }
     }
 
@@ -367,50 +406,51 @@ private:
         if (notifyFrequency > 0)
         {
 
-            // Some funny things that make it possible for the kernel to calculate
-            // the absolute position of the particles
-            const SubGrid<simDim>& subGrid = Environment<simDim>::get().SubGrid();
-            DataSpace<simDim> localSize(subGrid.getLocalDomain().size);
-            const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(currentStep);
-            DataSpace<simDim> globalOffset(subGrid.getLocalDomain().offset);
-            globalOffset.y() += (localSize.y() * numSlides);
-
             // only print data at end of simulation if no dump period was set
             if (dumpPeriod == 0)
             {
-                collectDataGPUToMaster();
-                writeAllFiles(globalOffset);
+                collectDataGPUToSlabs();
+                writeAllFiles();
             }
 
-            if (isMaster)
-            {
-                __deleteArray(timeSumArray);
-                delete[] detectorPositions;
-                delete[] detectorFrequencies;
-            }
+            __deleteArray(timeSumArray);
+            __deleteArray(tmp_result);
+            __deleteArray(detectorPositions);
+            __deleteArray(detectorFrequencies);
 
             __delete(radiation);
+            __delete(observerDirections);
+            __delete(timeSamples);
+            __delete(timeDomainSpectrum);
             CUDA_CHECK(cudaGetLastError());
         }
-
-        __deleteArray(tmp_result);
     }
 
 
   /** Method to copy data from GPU to CPU */
   void copyRadiationDeviceToHost()
   {
+    if (hasTimeSamples)
+        transformTimeSamples();
     radiation->deviceToHost();
     __getTransactionEvent().waitForFinished();
   }
 
 
   /** write radiation from each GPU to file individually
-   *  requires call of copyRadiationDeviceToHost() before */
-  void saveRadPerGPU(const DataSpace<simDim> currentGPUpos)
+   *
+   * The amplitudes of all observers emitted by the local particles since the
+   * last dump, before they are summed over the ranks.
+   * requires call of copyRadiationDeviceToHost() before */
+  void saveRadPerGPU()
   {
     if (radPerGPU)
       {
+        const SubGrid<simDim>& subGrid = Environment<simDim>::get().SubGrid();
+        const uint32_t numSlides = MovingWindow::getInstance().getSlideCounter(currentStep);
+        DataSpace<simDim> currentGPUpos(subGrid.getLocalDomain().offset);
+        currentGPUpos.y() += (subGrid.getLocalDomain().size.y() * numSlides);
+
         // only print lastGPUrad if full time period was covered
         if (lastGPUpos == currentGPUpos)
           {
@@ -435,109 +475,145 @@ private:
   }
 
 
-  /** returns number of observers (radiation detectors) */
-  static unsigned int elements_amplitude()
+  /** write the spectra of all observers as text, one line per observer */
+  void writeFile(Amplitude* values, std::string name)
   {
-    return radiation_frequencies::N_omega * parameters::N_observer; // storage for amplitude results on GPU
+      std::ofstream outFile;
+      outFile.open(name.c_str(), std::ofstream::out | std::ostream::trunc);
+      if (!outFile)
+      {
+          std::cerr << "Can't open file [" << name << "] for output, disable per GPU output. " << std::endl;
+          radPerGPU = false;
+      }
+      else
+      {
+          for (unsigned int index_direction = 0; index_direction < numObservers; ++index_direction) // over all directions
+          {
+              for (unsigned index_omega = 0; index_omega < numFrequencies; ++index_omega) // over all frequencies
+              {
+                  // Take Amplitude for one direction and frequency,
+                  // calculate the square of the absolute value
+                  // and write to file.
+                  outFile <<
+                    values[index_omega + index_direction * numFrequencies].calc_radiation() * UNIT_ENERGY * UNIT_TIME << "\t";
+
+              }
+              outFile << std::endl;
+          }
+          outFile.flush();
+          outFile << std::endl; //now all data are written to file
+
+          if (outFile.fail())
+              std::cerr << "Error on flushing file [" << name << "]. " << std::endl;
+
+          outFile.close();
+      }
   }
 
 
-  /** combine radiation data from each CPU and store result on master
-   *  copyRadiationDeviceToHost() should be called before */
-  void collectRadiationOnMaster()
+  /** returns number of amplitudes of all observers (radiation detectors) */
+  unsigned int elements_amplitude() const
   {
-      reduce(nvidia::functors::Add(),
-             tmp_result,
-             radiation->getHostBuffer().getBasePointer(),
-             elements_amplitude(),
-             mpi::reduceMethods::Reduce()
-             );
+    return numFrequencies * numObservers; // storage for amplitude results on GPU
   }
 
 
-  /** add collected radiation data to previously stored data
-   *  should be called after collectRadiationOnMaster() */
-  void sumAmplitudesOverTime(Amplitude* targetArray, Amplitude* summandArray)
+  /** returns number of amplitudes of the observers of this rank */
+  unsigned int elements_local_amplitude() const
   {
-    if (isMaster)
-      {
-        // add last amplitudes to previous amplitudes
-        for (unsigned int i = 0; i < elements_amplitude(); ++i)
-          targetArray[i] += summandArray[i];
-      }
+    return numFrequencies * numLocalObservers;
   }
 
 
-
-  /** writes to file the emitted radiation only from the current
-   *  time step. Radiation from previous time steps is neglected. */
-  void writeLastRadToText()
+  /** fill the observer table and set numObservers
+   *
+   * The directions are taken from the observer list if one is given (read
+   * by the master rank and broadcast), else from
+   * radiation_observer::observation_direction(). The kernels read the
+   * table instead of evaluating the directions for each block.
+   */
+  void initObserverDirections()
   {
-      // only the master rank writes data
-      if (isMaster)
+      std::vector<float_64> directionList;
+      if (pathObserverList != "_noPath_")
       {
-          // write file only if lastRad flag was selected
-          if (lastRad)
-          {
-              // get time step as string
-              std::stringstream o_step;
-              o_step << currentStep;
-
-              // write lastRad data to txt
-              writeFile(tmp_result, folderLastRad + "/" + filename_prefix + "_" + o_step.str() + ".dat");
-          }
+          directionList = radiationTable::loadTableFile(pathObserverList, 3, "radiation-observer-file", mpiComm);
+          numObservers = directionList.size() / 3;
       }
-  }
+      else
+          numObservers = parameters::N_observer;
 
+      observerDirections = new GridBuffer<vector_64, DIM1 > (DataSpace<DIM1 > (numObservers));
+      typename GridBuffer<vector_64, DIM1>::DataBoxType directions = observerDirections->getHostBuffer().getDataBox();
 
-  /** writes the total radiation (over entire simulation time) to file */
-  void writeTotalRadToText()
-  {
-      // only the master rank writes data
-      if (isMaster)
+      for (uint32_t i = 0; i < numObservers; ++i)
       {
-          // write file only if totalRad flag was selected
-          if (totalRad)
+          if (directionList.empty())
           {
-              // get time step as string
-              std::stringstream o_step;
-              o_step << currentStep;
-
-              // write totalRad data to txt
-              writeFile(timeSumArray, folderTotalRad + "/" + filename_prefix + "_" + o_step.str() + ".dat");
+              directions[i] = radiation_observer::observation_direction(i);
+              continue;
           }
+
+          const vector_64 direction(directionList[3 * i], directionList[3 * i + 1], directionList[3 * i + 2]);
+          if (direction.magnitude() == 0.0)
+              throw std::runtime_error(std::string("Radiation: observer ") + std::to_string(i) +
+                                       " in " + pathObserverList + " has no direction (zero vector)");
+          directions[i] = direction.unit_vec();
       }
+
+      observerDirections->hostToDevice();
+
+      log<radLog::SIMULATION_STATE > ("Radiation (%1%): %2% observers, %3% frequencies")
+          % speciesName % numObservers % numFrequencies;
   }
 
 
-  /** write total radiation data as HDF5 file */
-  void writeAmplitudesToHDF5()
+  /** sum radiation data of all ranks, each rank receives the amplitudes of its observers
+   *  copyRadiationDeviceToHost() should be called before */
+  void collectRadiationSlabs()
   {
-      if (isMaster)
-      {
-        writeHDF5file(timeSumArray, std::string("radiationHDF5/") + speciesName + std::string("_radAmplitudes_"));
-      }
+      /* the amplitudes of one observer are contiguous, [observer][omega] */
+      MPI_CHECK(MPI_Reduce_scatter(radiation->getHostBuffer().getBasePointer(),
+                                   tmp_result,
+                                   &slabElements[0],
+                                   MPI_DOUBLE,
+                                   MPI_SUM,
+                                   mpiComm));
+  }
+
+
+  /** add collected radiation data to previously stored data
+   *  should be called after collectRadiationSlabs() */
+  void sumAmplitudesOverTime(Amplitude* targetArray, Amplitude* summandArray)
+  {
+    // add last amplitudes to previous amplitudes
+    for (unsigned int i = 0; i < elements_local_amplitude(); ++i)
+      targetArray[i] += summandArray[i];
   }
 
 
-  /** perform all operations to get data from GPU to master */
-  void collectDataGPUToMaster()
+
+  /** perform all operations to get data from GPU to the observer slabs */
+  void collectDataGPUToSlabs()
   {
-      // collect data GPU -> CPU -> Master
+      // collect data GPU -> CPU -> observer slabs
       copyRadiationDeviceToHost();
-      collectRadiationOnMaster();
+      collectRadiationSlabs();
       sumAmplitudesOverTime(timeSumArray, tmp_result);
   }
 
 
-  /** write all possible/selected output */
-  void writeAllFiles(const DataSpace<simDim> currentGPUpos)
+  /** write all possible/selected output
+   *
+   * total radiation (over entire simulation time) and, if selected, the radiation
+   * emitted since the last dump and the radiation of each GPU
+   */
+  void writeAllFiles()
   {
-      // write data to files
-      saveRadPerGPU(currentGPUpos);
-      writeLastRadToText();
-      writeTotalRadToText();
-      writeAmplitudesToHDF5();
+      saveRadPerGPU();
+      writeHDF5file(timeSumArray, std::string("radiationHDF5/") + speciesName + std::string("_radAmplitudes"));
+      if (lastRad)
+          writeHDF5file(tmp_result, std::string("radiationHDF5/") + speciesName + std::string("_radLastAmplitudes"));
   }
 
 
@@ -649,34 +725,47 @@ private:
 
 
   /** Write Amplitude data to HDF5 file
+   *
+   * Collective: all ranks write the slab of their observers into one
+   * shared file (parallel HDF5).
    *
    * Arguments:
-   * Amplitude* values - array of complex amplitude values
-   * std::string name - path and beginning of file name to store data to
+   * Amplitude* values - array of complex amplitude values of the local observers
+   * std::string name - path and beginning of file name to store data to,
+   *                    the file is named <name>_<currentStep>.h5
    */
   void writeHDF5file(Amplitude* values, std::string name)
   {
-      splash::SerialDataCollector hdf5DataFile(1);
+      splash::ParallelDataCollector hdf5DataFile(mpiComm,
+                                                 MPI_INFO_NULL,
+                                                 splash::Dimensions(mpiSize, 1, 1),
+                                                 1);
       splash::DataCollector::FileCreationAttr fAttr;
 
       splash::DataCollector::initFileCreationAttr(fAttr);
       fAttr.enableCompression = compressionOn;
+      fAttr.mpiPosition.set(mpiRank, 0, 0);
+      fAttr.mpiSize.set(mpiSize, 1, 1);
 
-      std::ostringstream filename;
-      filename << name << currentStep;
-
-      hdf5DataFile.open(filename.str().c_str(), fAttr);
+      hdf5DataFile.open(name.c_str(), fAttr);
 
       typename PICToSplash<float_64>::type radSplashType;
 
 
+      /* global data set [observer][omega], each rank writes its observers */
+      splash::Dimensions globalComponentSize(1,
+                                             numFrequencies,
+                                             numObservers);
+
+      splash::Dimensions localOffset(0, 0, observerOffset);
+
       splash::Dimensions bufferSize(Amplitude::numComponents,
-                                    radiation_frequencies::N_omega,
-                                    parameters::N_observer);
+                                    numFrequencies,
+                                    numLocalObservers);
 
       splash::Dimensions componentSize(1,
-                                       radiation_frequencies::N_omega,
-                                       parameters::N_observer);
+                                       numFrequencies,
+                                       numLocalObservers);
 
       splash::Dimensions stride(Amplitude::numComponents,1,1);
 
@@ -697,6 +786,8 @@ private:
 
           /* save data for each x/y/z * Re/Im amplitude */
           hdf5DataFile.write(currentStep,
+                             globalComponentSize,
+                             localOffset,
                              radSplashType,
                              3,
                              dataSelection,
@@ -729,13 +820,17 @@ private:
                                   &factor);
 
       /* save detector position / observation direction */
+      splash::Dimensions globalSizeDetector(1,
+                                            1,
+                                            numObservers);
+
       splash::Dimensions bufferSizeDetector(3,
                                             1,
-                                            parameters::N_observer);
+                                            numLocalObservers);
 
       splash::Dimensions componentSizeDetector(1,
                                                1,
-                                               parameters::N_observer);
+                                               numLocalObservers);
 
       splash::Dimensions strideDetector(3,1,1);
 
@@ -748,6 +843,8 @@ private:
                                       strideDetector);
 
           hdf5DataFile.write(currentStep,
+                             globalSizeDetector,
+                             localOffset,
                              radSplashType,
                              3,
                              dataSelection,
@@ -776,9 +873,13 @@ private:
 
 
 
-      /* save detector frequencies */
+      /* save detector frequencies, all ranks know them, only the master writes */
+      splash::Dimensions globalSizeOmega(1,
+                                         numFrequencies,
+                                         1);
+
       splash::Dimensions bufferSizeOmega(1,
-                                         radiation_frequencies::N_omega,
+                                         isMaster ? numFrequencies : 0,
                                          1);
 
       splash::Dimensions strideOmega(1,1,1);
@@ -790,6 +891,8 @@ private:
                                       strideOmega);
 
       hdf5DataFile.write(currentStep,
+                         globalSizeOmega,
+                         offset,
                          radSplashType,
                          3,
                          dataSelection,
@@ -819,45 +922,45 @@ private:
       /* begin required openPMD global attributes */
       std::string openPMDversion("1.0.0");
       splash::ColTypeString ctOpenPMDversion(openPMDversion.length());
-      hdf5DataFile.writeGlobalAttribute( ctOpenPMDversion,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctOpenPMDversion,
                                          "openPMD",
                                          openPMDversion.c_str() );
 
       const uint32_t openPMDextension = 0; // no extension
       splash::ColTypeUInt32 ctUInt32;
-      hdf5DataFile.writeGlobalAttribute( ctUInt32,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctUInt32,
                                          "openPMDextension",
                                          &openPMDextension );
 
       std::string basePath("/data/%T/");
       splash::ColTypeString ctBasePath(basePath.length());
-      hdf5DataFile.writeGlobalAttribute(ctBasePath,
+      hdf5DataFile.writeGlobalAttribute(currentStep, ctBasePath,
                                         "basePath",
                                         basePath.c_str() );
 
       splash::ColTypeString ctMeshesPath(meshesPathName.length());
-      hdf5DataFile.writeGlobalAttribute(ctMeshesPath,
+      hdf5DataFile.writeGlobalAttribute(currentStep, ctMeshesPath,
                                         "meshesPath",
                                         meshesPathName.c_str() );
 
 
       splash::ColTypeString ctParticlesPath(particlesPathName.length());
-      hdf5DataFile.writeGlobalAttribute( ctParticlesPath,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctParticlesPath,
                                          "particlesPath",
                                          particlesPathName.c_str() );
 
       std::string iterationEncoding("fileBased");
       splash::ColTypeString ctIterationEncoding(iterationEncoding.length());
-      hdf5DataFile.writeGlobalAttribute( ctIterationEncoding,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctIterationEncoding,
                                          "iterationEncoding",
                                          iterationEncoding.c_str() );
 
-      /* the ..._0_0_0... extension comes from the current filename
-         formating of the serial data colector in libSplash */
+      /* the _%T.h5 extension comes from the filename formating of the
+         parallel data collector in libSplash */
       const int indexCutDirectory = name.rfind('/');
-      std::string iterationFormat(name.substr(indexCutDirectory + 1) +  std::string("%T_0_0_0.h5"));
+      std::string iterationFormat(name.substr(indexCutDirectory + 1) +  std::string("_%T.h5"));
       splash::ColTypeString ctIterationFormat(iterationFormat.length());
-      hdf5DataFile.writeGlobalAttribute( ctIterationFormat,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctIterationFormat,
                                          "iterationFormat",
                                          iterationFormat.c_str() );
 
@@ -875,14 +978,14 @@ private:
       if( author.length() > 0 )
         {
           splash::ColTypeString ctAuthor(author.length());
-          hdf5DataFile.writeGlobalAttribute( ctAuthor,
+          hdf5DataFile.writeGlobalAttribute( currentStep, ctAuthor,
                                              "author",
                                              author.c_str() );
         }
 
       std::string software("PIConGPU");
       splash::ColTypeString ctSoftware(software.length());
-      hdf5DataFile.writeGlobalAttribute( ctSoftware,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctSoftware,
                                          "software",
                                          software.c_str() );
 
@@ -891,13 +994,13 @@ private:
                       << PICONGPU_VERSION_MINOR << "."
                       << PICONGPU_VERSION_PATCH;
       splash::ColTypeString ctSoftwareVersion(softwareVersion.str().length());
-      hdf5DataFile.writeGlobalAttribute( ctSoftwareVersion,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctSoftwareVersion,
                                          "softwareVersion",
                                          softwareVersion.str().c_str() );
 
       std::string date  = helper::getDateString("%F %T %z");
       splash::ColTypeString ctDate(date.length());
-      hdf5DataFile.writeGlobalAttribute( ctDate,
+      hdf5DataFile.writeGlobalAttribute( currentStep, ctDate,
                                          "date",
                                          date.c_str() );
 
@@ -1026,55 +1129,76 @@ private:
       /* end required openPMD attributes for meshes */
       /* end openPMD attributes */
 
+      hdf5DataFile.finalize();
       hdf5DataFile.close();
     }
 
 
 
   /** Read Amplitude data from HDF5 file
+   *
+   * Collective: each rank reads the slab of its observers.
    *
    * Arguments:
-   * Amplitude* values - array of complex amplitudes to store data in
+   * Amplitude* values - array of complex amplitudes of the local observers to store data in
    * std::string name - path and beginning of file name with data stored in
    * const int timeStep - time step to read
    */
   void readHDF5file(Amplitude* values, std::string name, const int timeStep)
   {
-      splash::SerialDataCollector hdf5DataFile(1);
+      splash::ParallelDataCollector hdf5DataFile(mpiComm,
+                                                 MPI_INFO_NULL,
+                                                 splash::Dimensions(mpiSize, 1, 1),
+                                                 1);
       splash::DataCollector::FileCreationAttr fAttr;
 
       splash::DataCollector::initFileCreationAttr(fAttr);
 
       fAttr.fileAccType = splash::DataCollector::FAT_READ;
+      fAttr.mpiPosition.set(mpiRank, 0, 0);
+      fAttr.mpiSize.set(mpiSize, 1, 1);
 
       std::ostringstream filename;
-      /* add to standard ending added by libSplash for SerialDataCollector */
-      filename << name << timeStep << "_0_0_0.h5";
+      /* add to standard ending added by libSplash for ParallelDataCollector */
+      filename << name << "_" << timeStep << ".h5";
+
+      /* checkpoints of older versions were written by the master rank alone */
+      std::ostringstream serialFilename;
+      serialFilename << name << "_" << timeStep << "_0_0_0.h5";
 
       /* check if restart file exists */
-      if( !boost::filesystem::exists(filename.str()) )
+      if( !boost::filesystem::exists(filename.str()) && boost::filesystem::exists(serialFilename.str()) )
+      {
+          throw std::runtime_error(std::string("Radiation (") + speciesName + std::string("): restart file ") +
+                                   serialFilename.str() + std::string(" has the serial format of an older version, "
+                                   "the spectra can not be restored"));
+      }
+      else if( !boost::filesystem::exists(filename.str()) )
       {
           log<picLog::INPUT_OUTPUT > ("Radiation (%1%): restart file not found (%2%) - start with zero values") %
                                       speciesName % filename.str();
       }
       else
       {
-          hdf5DataFile.open(filename.str().c_str(), fAttr);
-
-          typename PICToSplash<float_64>::type radSplashType;
+          hdf5DataFile.open(name.c_str(), fAttr);
 
           splash::Dimensions componentSize(1,
-                                           radiation_frequencies::N_omega,
-                                           parameters::N_observer);
+                                           numFrequencies,
+                                           numLocalObservers);
 
-          const int N_tmpBuffer = radiation_frequencies::N_omega * parameters::N_observer;
-          picongpu::float_64* tmpBuffer = new picongpu::float_64[N_tmpBuffer];
+          splash::Dimensions localOffset(0, 0, observerOffset);
+
+          const int N_tmpBuffer = elements_local_amplitude();
+          picongpu::float_64* tmpBuffer = new picongpu::float_64[std::max(N_tmpBuffer, 1)];
 
           for(uint32_t ampIndex=0; ampIndex < Amplitude::numComponents; ++ampIndex)
           {
+              splash::Dimensions sizeRead(0, 0, 0);
               hdf5DataFile.read(timeStep,
-                                (meshesPathName + dataLabels(ampIndex)).c_str(),
                                 componentSize,
+                                localOffset,
+                                (meshesPathName + dataLabels(ampIndex)).c_str(),
+                                sizeRead,
                                 tmpBuffer);
 
               for(int copyIndex = 0; copyIndex < N_tmpBuffer; ++copyIndex)
@@ -1093,45 +1217,124 @@ private:
   }
 
 
-  /**
-   * From the collected data from all hosts the radiated intensity is
-   * calculated by calculating the absolute value squared and multiplying
-   * this with with the appropriate physics constants.
-   * @param values
-   * @param name
+  /** setup of the spectral backend `fft` */
+  void initTimeDomainSpectrum()
+  {
+#if( __COHERENTINCOHERENTWEIGHTING__ == 1 ) || ( __NYQUISTCHECK__ == 1 )
+      throw std::runtime_error("Radiation: spectralBackend fft does not support "
+                               "__COHERENTINCOHERENTWEIGHTING__ and __NYQUISTCHECK__");
+#endif
+      std::vector<float_64> omega(numFrequencies);
+      float_64 omegaMax = 0.0;
+      for (uint32_t i = 0; i < numFrequencies; ++i)
+      {
+          omega[i] = freqInit.getFrequency(i);
+          omegaMax = std::max(omegaMax, std::abs(omega[i]));
+      }
+
+      const float_64 sampleSpacing = radiationSpectral::TimeDomainSpectrum::getSampleSpacing(omegaMax);
+      timeDomainSpectrum = new radiationSpectral::TimeDomainSpectrum(omega, numTimeSamples, sampleSpacing);
+      timeSamples = new GridBuffer<vector_64, DIM1 > (DataSpace<DIM1 > (numObservers * numTimeSamples));
+      timeSamples->getDeviceBuffer().reset(false);
+
+      log<radLog::SIMULATION_STATE > ("Radiation (%1%): spectral backend fft (%2%), %3% time samples per observer")
+          % speciesName % (timeDomainSpectrum->isUniform() ? "chirp-z" : "NUFFT") % numTimeSamples;
+  }
+
+
+  /** upper limit of the light travel time |r| / c of all local particles
+   *
+   * The retarded time of a particle at step time t is within t +- this limit.
    */
-  void writeFile(Amplitude* values, std::string name)
+  float_64 getMaxLightTravelTime(const DataSpace<simDim>& globalOffset, const DataSpace<simDim>& localSize) const
   {
-      std::ofstream outFile;
-      outFile.open(name.c_str(), std::ofstream::out | std::ostream::trunc);
-      if (!outFile)
+      float_64 maxDistanceSquare = 0.0;
+      for (uint32_t d = 0; d < simDim; ++d)
       {
-          std::cerr << "Can't open file [" << name << "] for output, disable plugin output. " << std::endl;
-          isMaster = false; // no Master anymore -> no process is able to write
+          const float_64 distance = std::max(std::abs(float_64(globalOffset[d])),
+                                             std::abs(float_64(globalOffset[d] + localSize[d]))) * cellSize[d];
+          maxDistanceSquare += distance * distance;
       }
-      else
+      return std::sqrt(maxDistanceSquare) / SPEED_OF_LIGHT;
+  }
+
+
+  /** add the spectrum of the retarded time grid to the amplitudes and clear the grid */
+  void transformTimeSamples()
+  {
+      timeSamples->deviceToHost();
+      radiation->deviceToHost();
+      __getTransactionEvent().waitForFinished();
+
+      PMACC_CASSERT_MSG(vector_64_must_be_three_contiguous_float_64, sizeof(vector_64) == 3 * sizeof(float_64));
+      const float_64* samples = reinterpret_cast<const float_64*>(timeSamples->getHostBuffer().getBasePointer());
+      Amplitude* amplitudes = radiation->getHostBuffer().getBasePointer();
+      const int N_observer = numObservers;
+      const uint32_t N_omega = numFrequencies;
+
+      #pragma omp parallel
       {
-          for (unsigned int index_direction = 0; index_direction < parameters::N_observer; ++index_direction) // over all directions
-          {
-              for (unsigned index_omega = 0; index_omega < radiation_frequencies::N_omega; ++index_omega) // over all frequencies
-              {
-                  // Take Amplitude for one direction and frequency,
-                  // calculate the square of the absolute value
-                  // and write to file.
-                  outFile <<
-                    values[index_omega + index_direction * radiation_frequencies::N_omega].calc_radiation() * UNIT_ENERGY * UNIT_TIME << "\t";
+          std::vector<radiationSpectral::Complex> work(timeDomainSpectrum->getWorkSize());
+          std::vector<radiationSpectral::Complex> spectrum(3 * N_omega);
 
-              }
-              outFile << std::endl;
+          #pragma omp for
+          for (int observer = 0; observer < N_observer; ++observer)
+          {
+              for (uint32_t d = 0; d < 3; ++d)
+                  timeDomainSpectrum->transform(samples + (size_t(observer) * numTimeSamples) * 3 + d, 3,
+                                                timeSamplesBegin, &work[0], &spectrum[d * N_omega]);
+
+              for (uint32_t o = 0; o < N_omega; ++o)
+                  amplitudes[observer * N_omega + o] += Amplitude(spectrum[o].real(), spectrum[o].imag(),
+                                                                  spectrum[N_omega + o].real(), spectrum[N_omega + o].imag(),
+                                                                  spectrum[2 * N_omega + o].real(), spectrum[2 * N_omega + o].imag());
           }
-          outFile.flush();
-          outFile << std::endl; //now all data are written to file
+      }
 
-          if (outFile.fail())
-              std::cerr << "Error on flushing file [" << name << "]. " << std::endl;
+      radiation->hostToDevice();
+      timeSamples->getDeviceBuffer().reset(false);
+      hasTimeSamples = false;
+  }
 
-          outFile.close();
+
+  /** spread the radiation of all particles onto the retarded time grid (spectral backend `fft`) */
+  void spreadRadiationParticles(uint32_t currentStep, const DataSpace<simDim>& globalOffset,
+                                const DataSpace<simDim>& localSize)
+  {
+      const float_64 sampleSpacing = timeDomainSpectrum->getSampleSpacing();
+      const float_64 t = float_64(currentStep) * float_64(DELTA_T);
+      const float_64 reach = getMaxLightTravelTime(globalOffset, localSize) +
+          radiationSpectral::TimeDomainSpectrum::getSpreadMargin(sampleSpacing);
+      const float_64 timeSamplesEnd = timeSamplesBegin + float_64(numTimeSamples) * sampleSpacing;
+
+      if (2.0 * reach >= float_64(numTimeSamples) * sampleSpacing)
+          throw std::runtime_error(std::string("Radiation: the retarded times of one time step do not fit into ") +
+                                   pluginPrefix + ".timeSamples, increase the number of time samples");
+
+      /* transform the grid if the retarded times of this step could exceed it */
+      if (hasTimeSamples && t + reach >= timeSamplesEnd)
+          transformTimeSamples();
+
+      if (!hasTimeSamples)
+      {
+          timeSamplesBegin = t - reach;
+          hasTimeSamples = true;
       }
+
+      PMACC_KERNEL(KernelRadiationTimeDomain{})
+        (numObservers, PMacc::math::CT::volume<typename MappingDesc::SuperCellSize>::type::value)
+        (
+         particles->getDeviceParticlesBox(),
+         timeSamples->getDeviceBuffer().getDataBox(),
+         globalOffset,
+         currentStep, *cellDescription,
+         Environment<simDim>::get().SubGrid().getGlobalDomain().size,
+         observerDirections->getDeviceBuffer().getDataBox(),
+         timeSamplesBegin,
+         sampleSpacing,
+         numTimeSamples,
+         radiationSpectral::TimeDomainSpectrum::getSpreadExponent()
+         );
   }
 
   /**
@@ -1167,7 +1370,7 @@ private:
        * turned out to be slower on GPUs of the Fermi generation (sm_2x) (couple
        * percent) and definitely slower on Kepler GPUs (sm_3x, tested on K20))
        */
-      const int N_observer = parameters::N_observer;
+      const int N_observer = numObservers;
       const auto gridDim_rad = N_observer;
 
       /* number of threads per block = number of cells in a super cell
@@ -1189,25 +1392,34 @@ private:
       globalOffset.y() += (localSize.y() * numSlides);
 
 
-      // PIC-like kernel call of the radiation kernel
-      PMACC_KERNEL(KernelRadiationParticles{})
-        (gridDim_rad, blockDim_rad)
-        (
-         /*Pointer to particles memory on the device*/
-         particles->getDeviceParticlesBox(),
-
-         /*Pointer to memory of radiated amplitude on the device*/
-         radiation->getDeviceBuffer().getDataBox(),
-         globalOffset,
-         currentStep, *cellDescription,
-         freqFkt,
-         subGrid.getGlobalDomain().size
-         );
+      if (timeSamples != NULL)
+      {
+          spreadRadiationParticles(currentStep, globalOffset, localSize);
+      }
+      else
+      {
+          // PIC-like kernel call of the radiation kernel
+          PMACC_KERNEL(KernelRadiationParticles{})
+            (gridDim_rad, blockDim_rad)
+            (
+             /*Pointer to particles memory on the device*/
+             particles->getDeviceParticlesBox(),
+
+             /*Pointer to memory of radiated amplitude on the device*/
+             radiation->getDeviceBuffer().getDataBox(),
+             globalOffset,
+             currentStep, *cellDescription,
+             freqFkt,
+             numFrequencies,
+             observerDirections->getDeviceBuffer().getDataBox(),
+             subGrid.getGlobalDomain().size
+             );
+      }
 
       if (dumpPeriod != 0 && currentStep % dumpPeriod == 0)
       {
-          collectDataGPUToMaster();
-          writeAllFiles(globalOffset);
+          collectDataGPUToSlabs();
+          writeAllFiles();
 
           // update time steps
           lastStep = currentStep;
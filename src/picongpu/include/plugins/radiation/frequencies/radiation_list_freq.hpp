@@ -24,9 +24,10 @@
 
 #include "pmacc_types.hpp"
 #include "simulation_defines.hpp"
-#include <fstream>
-#include <cstdio>
 #include "memory/buffers/GridBuffer.hpp"
+#include "plugins/radiation/tableFile.hpp"
+
+#include <vector>
 
 #if (ENABLE_RADIATION == 1)
 
@@ -43,20 +44,22 @@ namespace picongpu
 
       typedef GridBuffer<float_X, DIM1>::DataBoxType DBoxType;
 
-      FreqFunctor(void)
+      FreqFunctor(void) : numFrequencies(0)
       { }
 
-      FreqFunctor(DBoxType frequencies_handed)
-      : frequencies(frequencies_handed)
+      FreqFunctor(DBoxType frequencies_handed, const unsigned int numFrequencies_handed)
+      : frequencies(frequencies_handed), numFrequencies(numFrequencies_handed)
       { }
 
       HDINLINE float_X operator()(const unsigned int ID)
       {
-          return (ID < radiation_frequencies::N_omega) ?  frequencies[ID] : 0.0  ;
+          return (ID < numFrequencies) ?  frequencies[ID] : 0.0  ;
       }
 
     private:
       DBoxType frequencies;
+      /* number of frequencies in the list, known at runtime */
+      unsigned int numFrequencies;
 
     };
 
@@ -65,7 +68,7 @@ namespace picongpu
     class InitFreqFunctor
     {
     public:
-      InitFreqFunctor(void)
+      InitFreqFunctor(void) : frequencyBuffer(NULL), numFrequencies(0)
       { }
 
       ~InitFreqFunctor(void)
@@ -75,49 +78,57 @@ namespace picongpu
 
       typedef GridBuffer<picongpu::float_X, DIM1>::DataBoxType DBoxType;
 
+      /** load the frequency list
+       *
+       * The file is read and validated by the master rank only and broadcast
+       * to all other ranks. The number of frequencies is defined by the
+       * file, N_omega of the param file is not used.
+       * Must be called by all ranks.
+       */
       HINLINE void Init(const std::string path )
       {
+          MPI_Comm comm = Environment<simDim>::get().GridController().getCommunicator().getMPIComm();
+          int mpiRank = 0;
+          MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
 
-          frequencyBuffer = new GridBuffer<float_X, DIM1>(DataSpace<DIM1> (N_omega));
-
+          const std::vector<float_64> frequencyList =
+              radiationTable::loadTableFile(path, 1, "radiation-frequency-file", comm);
 
+          numFrequencies = frequencyList.size();
+          frequencyBuffer = new GridBuffer<float_X, DIM1>(DataSpace<DIM1> (numFrequencies));
           DBoxType frequencyDB = frequencyBuffer->getHostBuffer().getDataBox();
 
-          std::ifstream freqListFile(path.c_str());
-          unsigned int i;
-
-          printf("freq: %s\n", path.c_str());
-
-          if(!freqListFile)
+          for(unsigned int i=0; i<frequencyList.size(); ++i)
           {
-              throw std::runtime_error(std::string("The radiation-frequency-file ") + path + std::string(" could not be found.\n"));
-          }
-
-
-          for(i=0; i<N_omega && !freqListFile.eof(); ++i)
-          {
-              freqListFile >> frequencyDB[i];
               // verbose output of loaded frequencies if verbose level PHYSICS is set:
-              log<PIConGPUVerboseRadiation::PHYSICS >("freq: %1% \t %2%") % i % frequencyDB[i];
-              frequencyDB[i] *= UNIT_TIME;
-          }
-
-          if(i != N_omega)
-          {
-              throw std::runtime_error(std::string("The number of frequencies in the list and the number of frequencies in the parameters differ.\n"));
+              if(mpiRank == 0)
+                  log<PIConGPUVerboseRadiation::PHYSICS >("freq: %1% \t %2%") % i % frequencyList[i];
+              frequencyDB[i] = float_X(frequencyList[i] * UNIT_TIME);
           }
 
           frequencyBuffer->hostToDevice();
-
       }
 
       FreqFunctor getFunctor(void)
       {
-          return FreqFunctor(frequencyBuffer->getDeviceBuffer().getDataBox());
+          return FreqFunctor(frequencyBuffer->getDeviceBuffer().getDataBox(), getNumFrequencies());
+      }
+
+      /** frequency with index ID, usable on the host */
+      HINLINE float_X getFrequency(const unsigned int ID)
+      {
+          return frequencyBuffer->getHostBuffer().getDataBox()[ID];
+      }
+
+      /** number of frequencies in the list */
+      HINLINE unsigned int getNumFrequencies(void) const
+      {
+          return numFrequencies;
       }
 
     private:
       GridBuffer<float_X, DIM1>* frequencyBuffer;
+      unsigned int numFrequencies;
     };
 
 
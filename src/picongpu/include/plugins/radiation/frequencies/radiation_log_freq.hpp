@@ -72,6 +72,18 @@ namespace picongpu
       {
           return FreqFunctor();
       }
+
+      /** frequency with index ID, usable on the host */
+      HINLINE float_X getFrequency(const unsigned int ID)
+      {
+          return getFunctor()(ID);
+      }
+
+      /** number of frequencies, defined at compile time */
+      HINLINE unsigned int getNumFrequencies(void) const
+      {
+          return N_omega;
+      }
     };
 
 
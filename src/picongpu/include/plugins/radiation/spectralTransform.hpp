@@ -0,0 +1,457 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+/* host only code without PIConGPU dependencies, it is also used by
+ * src/tools/radiationSpectrumBenchmark
+ */
+#include <stdint.h>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+
+namespace picongpu
+{
+namespace radiationSpectral
+{
+
+typedef std::complex<double> Complex;
+
+
+/** in-place radix-2 fast Fourier transform
+ *
+ * computes X_k = sum_n x_n exp(sign * i 2 pi n k / size) without
+ * normalization
+ */
+class Fft
+{
+public:
+
+    /** @param size number of points, must be a power of two */
+    explicit Fft(const uint32_t size) : size(size), twiddles(size / 2)
+    {
+        if (size == 0 || (size & (size - 1)) != 0)
+            throw std::runtime_error("Fft: size must be a power of two");
+
+        for (uint32_t i = 0; i < size / 2; ++i)
+            twiddles[i] = std::polar(1.0, 2.0 * M_PI * double(i) / double(size));
+    }
+
+    uint32_t getSize() const
+    {
+        return size;
+    }
+
+    /** @param sign +1 or -1, sign of the exponent */
+    void operator()(Complex* data, const int sign) const
+    {
+        /* bit reversal permutation */
+        for (uint32_t i = 1, j = 0; i < size; ++i)
+        {
+            uint32_t bit = size >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(data[i], data[j]);
+        }
+
+        for (uint32_t length = 2; length <= size; length <<= 1)
+        {
+            const uint32_t half = length / 2;
+            const uint32_t twiddleStride = size / length;
+            for (uint32_t start = 0; start < size; start += length)
+                for (uint32_t k = 0; k < half; ++k)
+                {
+                    const Complex w = sign > 0 ? twiddles[k * twiddleStride] :
+                        std::conj(twiddles[k * twiddleStride]);
+                    const Complex odd = data[start + k + half] * w;
+                    data[start + k + half] = data[start + k] - odd;
+                    data[start + k] += odd;
+                }
+        }
+    }
+
+private:
+
+    uint32_t size;
+    /* exp(i 2 pi k / size) */
+    std::vector<Complex> twiddles;
+};
+
+
+/** smallest power of two >= value */
+inline uint32_t nextPowerOfTwo(const uint64_t value)
+{
+    uint64_t result = 1;
+    while (result < value)
+        result <<= 1;
+    if (result > uint64_t(1) << 31)
+        throw std::runtime_error("radiation spectrum: transform size too large");
+    return uint32_t(result);
+}
+
+
+/** chirp-z transform (Bluestein) for equidistant phases
+ *
+ * computes X_k = sum_n x_n exp(i (theta0 + k deltaTheta) n)
+ * for n < numInput and k < numOutput with three FFTs of length
+ * >= numInput + numOutput - 1
+ */
+class ChirpZ
+{
+public:
+
+    ChirpZ(const uint32_t numInput, const uint32_t numOutput,
+           const double theta0, const double deltaTheta) :
+        numInput(numInput), numOutput(numOutput),
+        fft(nextPowerOfTwo(uint64_t(numInput) + numOutput - 1)),
+        inputFactor(numInput), outputFactor(numOutput),
+        kernelSpectrum(fft.getSize(), Complex(0.0, 0.0))
+    {
+        /* exp(i deltaTheta n k) = w_n w_k conj(w_{k-n}) with w_m = exp(i deltaTheta m^2 / 2) */
+        const uint32_t numChirp = std::max(numInput, numOutput);
+        std::vector<Complex> chirp(numChirp);
+        for (uint32_t m = 0; m < numChirp; ++m)
+        {
+            /* reduce the phase in double, m^2 is exact up to 2^26 */
+            const double phase = std::fmod(0.5 * deltaTheta * double(m) * double(m), 2.0 * M_PI);
+            chirp[m] = std::polar(1.0, phase);
+        }
+
+        for (uint32_t n = 0; n < numInput; ++n)
+            inputFactor[n] = chirp[n] * std::polar(1.0, std::fmod(theta0 * double(n), 2.0 * M_PI));
+        for (uint32_t k = 0; k < numOutput; ++k)
+            outputFactor[k] = chirp[k] / double(fft.getSize());
+
+        /* convolution kernel conj(w_m) for m in (-numInput, numOutput), negative indices wrapped */
+        const uint32_t size = fft.getSize();
+        for (uint32_t m = 0; m < numOutput; ++m)
+            kernelSpectrum[m] = std::conj(chirp[m]);
+        for (uint32_t m = 1; m < numInput; ++m)
+            kernelSpectrum[size - m] = std::conj(chirp[m]);
+        fft(&kernelSpectrum[0], -1);
+    }
+
+    uint32_t getWorkSize() const
+    {
+        return fft.getSize();
+    }
+
+    /** transform a real series
+     *
+     * @param input first sample, samples are `inputStride` elements apart
+     * @param work scratch memory of getWorkSize() elements
+     * @param output result, numOutput elements
+     */
+    void operator()(const double* input, const size_t inputStride, Complex* work, Complex* output) const
+    {
+        const uint32_t size = fft.getSize();
+        for (uint32_t n = 0; n < numInput; ++n)
+            work[n] = input[n * inputStride] * inputFactor[n];
+        std::fill(work + numInput, work + size, Complex(0.0, 0.0));
+
+        fft(work, -1);
+        for (uint32_t i = 0; i < size; ++i)
+            work[i] *= kernelSpectrum[i];
+        fft(work, +1);
+
+        for (uint32_t k = 0; k < numOutput; ++k)
+            output[k] = work[k] * outputFactor[k];
+    }
+
+private:
+
+    uint32_t numInput;
+    uint32_t numOutput;
+    Fft fft;
+    std::vector<Complex> inputFactor;
+    std::vector<Complex> outputFactor;
+    std::vector<Complex> kernelSpectrum;
+};
+
+
+/** non-uniform FFT (type 2) with Gaussian gridding
+ *
+ * computes X_k = sum_n x_n exp(i theta_k n) for n < numInput and arbitrary
+ * phases |theta_k| <= pi.
+ * Follows Greengard and Lee, SIAM Review 46 (2004): the series is
+ * deconvolved with a Gaussian, transformed by an oversampled FFT and
+ * interpolated to theta_k with the Gaussian. The relative error is about
+ * 1e-12 for `halfWidth = 12` and `oversampling = 2`.
+ */
+class Nufft
+{
+public:
+
+    static constexpr int halfWidth = 12;
+    static constexpr uint32_t oversampling = 2;
+
+    Nufft(const uint32_t numInput, const std::vector<double>& theta) :
+        numInput(numInput), numOutput(theta.size()),
+        fft(nextPowerOfTwo(uint64_t(numInput) * oversampling)),
+        deconvolution(numInput), firstGridPoint(numOutput),
+        weights(numOutput * 2 * halfWidth)
+    {
+        const double size = double(fft.getSize());
+        const double R = size / double(numInput);
+        const double tau = M_PI * halfWidth / (double(numInput) * double(numInput) * R * (R - 0.5));
+
+        /* modes are centered: n' = n - numInput / 2 */
+        for (uint32_t n = 0; n < numInput; ++n)
+        {
+            const double mode = double(n) - double(numInput / 2);
+            deconvolution[n] = std::sqrt(M_PI / tau) * std::exp(mode * mode * tau) / size;
+        }
+
+        const double gridSpacing = 2.0 * M_PI / size;
+        for (uint32_t k = 0; k < numOutput; ++k)
+        {
+            if (std::abs(theta[k]) > M_PI)
+                throw std::runtime_error("Nufft: phase out of range [-pi, pi]");
+            const int nearest = int(std::floor(theta[k] / gridSpacing));
+            firstGridPoint[k] = nearest - halfWidth + 1;
+            for (int i = 0; i < 2 * halfWidth; ++i)
+            {
+                const double distance = theta[k] - double(firstGridPoint[k] + i) * gridSpacing;
+                weights[k * 2 * halfWidth + i] = std::exp(-distance * distance / (4.0 * tau));
+            }
+        }
+
+        centerPhase.resize(numOutput);
+        for (uint32_t k = 0; k < numOutput; ++k)
+            centerPhase[k] = std::polar(1.0, theta[k] * double(numInput / 2));
+    }
+
+    uint32_t getWorkSize() const
+    {
+        return fft.getSize();
+    }
+
+    /** transform a real series, see ChirpZ::operator() */
+    void operator()(const double* input, const size_t inputStride, Complex* work, Complex* output) const
+    {
+        const int size = fft.getSize();
+        std::fill(work, work + size, Complex(0.0, 0.0));
+        for (uint32_t n = 0; n < numInput; ++n)
+        {
+            const int mode = int(n) - int(numInput / 2);
+            work[(mode + size) % size] = input[n * inputStride] * deconvolution[n];
+        }
+
+        fft(work, +1);
+
+        for (uint32_t k = 0; k < numOutput; ++k)
+        {
+            Complex sum(0.0, 0.0);
+            const double* w = &weights[k * 2 * halfWidth];
+            for (int i = 0; i < 2 * halfWidth; ++i)
+                sum += work[((firstGridPoint[k] + i) % size + size) % size] * w[i];
+            output[k] = sum * centerPhase[k];
+        }
+    }
+
+private:
+
+    uint32_t numInput;
+    uint32_t numOutput;
+    Fft fft;
+    std::vector<double> deconvolution;
+    std::vector<int> firstGridPoint;
+    std::vector<double> weights;
+    std::vector<Complex> centerPhase;
+};
+
+
+/** spectrum of point-like samples via a time-domain buffer
+ *
+ * The spectrum sum_p a_p exp(i omega_k t_p) of samples with amplitude a_p
+ * at (retarded) time t_p is computed in two steps:
+ *  - spread(): each sample is spread with a Gaussian onto a uniform time
+ *    grid t_n = t0 + n * dt (done by the device kernel in the plugin)
+ *  - transform(): the grid is transformed to the frequencies omega_k with a
+ *    chirp-z transform if the frequencies are equidistant, else with a
+ *    non-uniform FFT, and the Gaussian is deconvolved
+ *
+ * The grid spacing oversamples the highest frequency by `oversampling`
+ * relative to the Nyquist limit. With `spreadHalfWidth = 6` the relative
+ * error of the spectrum is about 1e-5.
+ */
+class TimeDomainSpectrum
+{
+public:
+
+    /** grid points on each side of a sample */
+    static constexpr int spreadHalfWidth = 6;
+    static constexpr double oversampling = 2.0;
+
+    /** grid spacing for frequencies up to |omega| = omegaMax */
+    static double getSampleSpacing(const double omegaMax)
+    {
+        return M_PI / (oversampling * omegaMax);
+    }
+
+    /** factor c of the spreading weight exp(-c * d^2), d is the distance in grid points */
+    static double getSpreadExponent()
+    {
+        /* Gaussian exp(-t^2 / (4 tau)) with tau / dt^2 = M_sp R / (4 pi (R - 0.5)) */
+        const double tau = spreadHalfWidth * oversampling / (4.0 * M_PI * (oversampling - 0.5));
+        return 1.0 / (4.0 * tau);
+    }
+
+    /** time span at the begin and end of the buffer which is needed by the spreading */
+    static double getSpreadMargin(const double sampleSpacing)
+    {
+        return double(spreadHalfWidth + 1) * sampleSpacing;
+    }
+
+    /** spread one sample (host reference of the device kernel)
+     *
+     * @param samples time grid, numSamples elements `stride` apart
+     * @param numSamples number of grid points
+     * @param u sample position in grid units, (t_p - t0) / dt
+     * @param amplitude amplitude a_p
+     */
+    static void spread(double* samples, const size_t stride, const uint32_t numSamples,
+                       const double u, const double amplitude)
+    {
+        const double spreadExponent = getSpreadExponent();
+        const int first = int(std::floor(u)) - spreadHalfWidth + 1;
+        for (int i = 0; i < 2 * spreadHalfWidth; ++i)
+        {
+            const int n = first + i;
+            if (n < 0 || n >= int(numSamples))
+                continue;
+            const double d = double(n) - u;
+            samples[n * stride] += amplitude * std::exp(-spreadExponent * d * d);
+        }
+    }
+
+    /** @param omega frequencies
+     *  @param numSamples number of grid points
+     *  @param sampleSpacing grid spacing dt
+     */
+    TimeDomainSpectrum(const std::vector<double>& omega, const uint32_t numSamples,
+                       const double sampleSpacing) :
+        omega(omega), numSamples(numSamples), sampleSpacing(sampleSpacing),
+        deconvolution(omega.size())
+    {
+        if (omega.empty())
+            throw std::runtime_error("radiation spectrum: no frequencies");
+
+        /* Fourier transform of the spreading Gaussian: sqrt(4 pi tau) exp(-omega^2 tau) / dt */
+        const double tau = 1.0 / (4.0 * getSpreadExponent()) * sampleSpacing * sampleSpacing;
+        for (size_t k = 0; k < omega.size(); ++k)
+        {
+            if (std::abs(omega[k]) * sampleSpacing > M_PI / oversampling * (1.0 + 1.0e-6))
+                throw std::runtime_error("radiation spectrum: frequency above the sampling limit");
+            deconvolution[k] = sampleSpacing / std::sqrt(4.0 * M_PI * tau) * std::exp(omega[k] * omega[k] * tau);
+        }
+
+        if (isEquidistant(omega))
+        {
+            const double deltaOmega = omega.size() > 1 ? (omega.back() - omega.front()) / double(omega.size() - 1) : 0.0;
+            chirpZ.reset(new ChirpZ(numSamples, omega.size(), omega.front() * sampleSpacing, deltaOmega * sampleSpacing));
+        }
+        else
+        {
+            std::vector<double> theta(omega.size());
+            for (size_t k = 0; k < omega.size(); ++k)
+                theta[k] = omega[k] * sampleSpacing;
+            nufft.reset(new Nufft(numSamples, theta));
+        }
+    }
+
+    /** true if the chirp-z transform is used */
+    bool isUniform() const
+    {
+        return chirpZ.get() != NULL;
+    }
+
+    uint32_t getNumSamples() const
+    {
+        return numSamples;
+    }
+
+    double getSampleSpacing() const
+    {
+        return sampleSpacing;
+    }
+
+    /** scratch memory per call of transform() */
+    uint32_t getWorkSize() const
+    {
+        return isUniform() ? chirpZ->getWorkSize() : nufft->getWorkSize();
+    }
+
+    /** spectrum of a time grid
+     *
+     * thread safe if each thread uses its own work memory
+     *
+     * @param samples time grid, getNumSamples() elements `stride` apart
+     * @param t0 time of the first grid point
+     * @param work scratch memory of getWorkSize() elements
+     * @param result spectrum, one element per frequency
+     */
+    void transform(const double* samples, const size_t stride, const double t0,
+                   Complex* work, Complex* result) const
+    {
+        if (isUniform())
+            (*chirpZ)(samples, stride, work, result);
+        else
+            (*nufft)(samples, stride, work, result);
+
+        for (size_t k = 0; k < omega.size(); ++k)
+            result[k] *= deconvolution[k] * std::polar(1.0, std::fmod(omega[k] * t0, 2.0 * M_PI));
+    }
+
+private:
+
+    static bool isEquidistant(const std::vector<double>& omega)
+    {
+        if (omega.size() < 2)
+            return true;
+        const double deltaOmega = (omega.back() - omega.front()) / double(omega.size() - 1);
+        const double tolerance = 1.0e-6 * std::max(std::abs(omega.front()), std::abs(omega.back()));
+        for (size_t k = 0; k < omega.size(); ++k)
+            if (std::abs(omega[k] - (omega.front() + double(k) * deltaOmega)) > tolerance)
+                return false;
+        return true;
+    }
+
+    TimeDomainSpectrum(const TimeDomainSpectrum&);
+    TimeDomainSpectrum& operator=(const TimeDomainSpectrum&);
+
+    std::vector<double> omega;
+    uint32_t numSamples;
+    double sampleSpacing;
+    std::vector<double> deconvolution;
+    std::unique_ptr<ChirpZ> chirpZ;
+    std::unique_ptr<Nufft> nufft;
+};
+
+} // namespace radiationSpectral
+} // namespace picongpu
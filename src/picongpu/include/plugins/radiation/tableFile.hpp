@@ -0,0 +1,119 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "pmacc_types.hpp"
+#include "simulation_defines.hpp"
+
+#include <mpi.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+namespace picongpu
+{
+namespace radiationTable
+{
+
+    /** read a whitespace separated table of numbers on rank 0 and broadcast it
+     *
+     * Only rank 0 of `comm` opens and validates the file, all other ranks
+     * receive the values in binary. Errors are broadcast too, so all ranks
+     * throw the same exception. Must be called by all ranks of `comm`.
+     *
+     * @param path file with `numColumns` numbers per row (lines starting with `#` are skipped)
+     * @param numColumns number of values per row
+     * @param description name of the table in error messages
+     * @param comm communicator of all ranks which need the table
+     * @return all values in file order, the size is a non zero multiple of numColumns
+     */
+    HINLINE std::vector<float_64> loadTableFile(const std::string& path,
+                                                const uint32_t numColumns,
+                                                const std::string& description,
+                                                MPI_Comm comm)
+    {
+        int mpiRank = 0;
+        MPI_CHECK(MPI_Comm_rank(comm, &mpiRank));
+
+        std::vector<float_64> values;
+        std::string errorMessage;
+
+        if (mpiRank == 0)
+        {
+            std::ifstream file(path.c_str());
+            if (!file)
+                errorMessage = std::string("The ") + description + " " + path + " could not be found.";
+
+            std::string line;
+            while (errorMessage.empty() && std::getline(file, line))
+            {
+                if (!line.empty() && line[0] == '#')
+                    continue;
+
+                std::istringstream lineStream(line);
+                float_64 value;
+                while (lineStream >> value)
+                {
+                    if (!std::isfinite(value))
+                    {
+                        errorMessage = std::string("The ") + description + " " + path +
+                            " contains a value which is not finite.";
+                        break;
+                    }
+                    values.push_back(value);
+                }
+                if (errorMessage.empty() && !lineStream.eof())
+                    errorMessage = std::string("The ") + description + " " + path +
+                        " contains a value which is not a number: " + line;
+            }
+
+            if (errorMessage.empty() && (values.empty() || values.size() % numColumns != 0))
+            {
+                std::ostringstream msg;
+                msg << "The " << description << " " << path << " contains " << values.size()
+                    << " values, expected a non zero multiple of " << numColumns << ".";
+                errorMessage = msg.str();
+            }
+        }
+
+        /* status first, so a failing read does not leave ranks waiting for data */
+        int errorLength = static_cast<int>(errorMessage.size());
+        MPI_CHECK(MPI_Bcast(&errorLength, 1, MPI_INT, 0, comm));
+        if (errorLength != 0)
+        {
+            errorMessage.resize(errorLength);
+            MPI_CHECK(MPI_Bcast(&errorMessage[0], errorLength, MPI_CHAR, 0, comm));
+            throw std::runtime_error(errorMessage);
+        }
+
+        uint64_t numValues = values.size();
+        MPI_CHECK(MPI_Bcast(&numValues, 1, MPI_UINT64_T, 0, comm));
+        values.resize(numValues);
+        MPI_CHECK(MPI_Bcast(&values[0], static_cast<int>(numValues), MPI_DOUBLE, 0, comm));
+
+        return values;
+    }
+
+} // namespace radiationTable
+} // namespace picongpu
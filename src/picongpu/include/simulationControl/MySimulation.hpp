@@ -105,6 +105,12 @@ public:
     cellDescription(NULL),
     initialiserController(NULL),
     slidingWindow(false),
+    exchangeBufferPeriod(100),
+    exchangeBufferMaxMiB(64),
+    particleSortPeriod(0),
+    framePoolSlots(0),
+    framePoolProbes(8),
+    framePoolLogPeriod(0),
     rngFactory(NULL)
     {
         ForEach<VectorAllSpecies, particles::AssignNull<bmpl::_1>, MakeIdentifier<bmpl::_1> > setPtrToNull;
@@ -131,7 +137,34 @@ public:
             ("periodic", po::value<std::vector<uint32_t> > (&periodic)->multitoken(),
              "specifying whether the grid is periodic (1) or not (0) in each dimension, default: no periodic dimensions")
 
-            ("moving,m", po::value<bool>(&slidingWindow)->zero_tokens(), "enable sliding/moving window");
+            ("moving,m", po::value<bool>(&slidingWindow)->zero_tokens(), "enable sliding/moving window")
+
+            ("synchrotronFunctionsCache", po::value<std::string>(&synchrotronFunctionsCacheDirectory),
+             "directory to cache the synchrotron function lookup tables for later runs, default: no caching")
+
+            ("exchangeBuffer.period", po::value<uint32_t>(&exchangeBufferPeriod)->default_value(100),
+             "adapt the particle exchange buffers to the observed traffic every N steps, "
+             "0 keeps the sizes from memory.param")
+
+            ("exchangeBuffer.maxMiB", po::value<uint32_t>(&exchangeBufferMaxMiB)->default_value(64),
+             "largest particle exchange buffer per species and direction in MiB, "
+             "larger sizes from memory.param are kept")
+
+            ("particleSort.period", po::value<uint32_t>(&particleSortPeriod)->default_value(0),
+             "sort the particles inside each supercell by cell every N steps, 0 disables sorting. "
+             "The effect on the particle push and the current deposition depends on the setup, "
+             "compare the runtime with and without sorting")
+
+            ("framePool.slots", po::value<uint32_t>(&framePoolSlots)->default_value(0),
+             "maximal number of released particle frames per species which are kept for recycling "
+             "instead of returning them to mallocMC, 0 disables recycling. Check the gain with "
+             "framePool.logPeriod and the step time before enabling it for production runs")
+
+            ("framePool.probes", po::value<uint32_t>(&framePoolProbes)->default_value(8),
+             "slots of the frame pool searched near the block and at a random position per frame request")
+
+            ("framePool.logPeriod", po::value<uint32_t>(&framePoolLogPeriod)->default_value(0),
+             "print the frame recycling rate of each species every N steps, 0 disables the output");
     }
 
     std::string pluginGetName() const
@@ -318,7 +351,7 @@ public:
         // Initialize synchrotron functions, if there are synchrotron photon species
         if(!bmpl::empty<AllSynchrotronPhotonsSpecies>::value)
         {
-            this->synchrotronFunctions.init();
+            this->synchrotronFunctions.init(synchrotronFunctionsCacheDirectory);
         }
 
         ForEach<VectorAllSpecies, particles::CreateSpecies<bmpl::_1>, MakeIdentifier<bmpl::_1> > createSpeciesMemory;
@@ -354,6 +387,10 @@ public:
         ForEach<VectorAllSpecies, particles::CallCreateParticleBuffer<bmpl::_1>, MakeIdentifier<bmpl::_1> > createParticleBuffer;
         createParticleBuffer(forward(particleStorage));
 
+        ForEach<VectorAllSpecies, particles::SetFramePoolSize<bmpl::_1>, MakeIdentifier<bmpl::_1> > setFramePoolSize;
+        /* the counters cost a global atomic per frame request, count only if they are printed */
+        setFramePoolSize(forward(particleStorage), framePoolSlots, framePoolProbes, framePoolLogPeriod != 0);
+
         Environment<>::get().MemoryInfo().getMemoryInfo(&freeGpuMem);
         log<picLog::MEMORY > ("free mem after all mem is allocated %1% MiB") % (freeGpuMem / 1024 / 1024);
 
@@ -465,23 +502,62 @@ public:
     {
         namespace nvfct = PMacc::nvidia::functors;
 
+        /* resize the particle exchange buffers to the traffic of the last steps,
+         * particles which do not fit are sent in additional rounds */
+        if (exchangeBufferPeriod != 0 && currentStep != 0 && currentStep % exchangeBufferPeriod == 0)
+        {
+            typedef typename PMacc::particles::traits::FilterByFlag
+            <
+                VectorAllSpecies,
+                particlePusher<>
+            >::type VectorSpeciesWithPusher;
+
+            simulationControl::ProfileScope profileScope("exchangeBufferAdaption");
+            ForEach<VectorSpeciesWithPusher, particles::AdaptExchangeBuffers<bmpl::_1>, MakeIdentifier<bmpl::_1> > adaptExchangeBuffers;
+            /* buffers grow only into memory which is free beside the reserved memory,
+             * the reserve is kept for temporary buffers of plugins */
+            adaptExchangeBuffers(forward(particleStorage),
+                                 size_t(BYTES_CORNER),
+                                 size_t(exchangeBufferMaxMiB) * 1024 * 1024,
+                                 reservedGpuMemorySize);
+        }
+
+        if (framePoolLogPeriod != 0 && currentStep != 0 && currentStep % framePoolLogPeriod == 0)
+        {
+            ForEach<VectorAllSpecies, particles::LogFramePoolStatistics<bmpl::_1>, MakeIdentifier<bmpl::_1> > logFramePool;
+            logFramePool(forward(particleStorage));
+        }
+
+        if (particleSortPeriod != 0 && currentStep % particleSortPeriod == 0)
+        {
+            simulationControl::ProfileScope profileScope("particleSort");
+            ForEach<VectorAllSpecies, particles::SortParticlesByCell<bmpl::_1>, MakeIdentifier<bmpl::_1> > sortParticles;
+            sortParticles(forward(particleStorage));
+        }
+
         /* Initialize ionization routine for each species with the flag `ionizer<>` */
         typedef typename PMacc::particles::traits::FilterByFlag
         <
             VectorAllSpecies,
             ionizer<>
         >::type VectorSpeciesWithIonizer;
-        ForEach<VectorSpeciesWithIonizer, particles::CallIonization<bmpl::_1>, MakeIdentifier<bmpl::_1> > particleIonization;
-        particleIonization(forward(particleStorage), cellDescription, currentStep);
+        {
+            simulationControl::ProfileScope profileScope("ionization");
+            ForEach<VectorSpeciesWithIonizer, particles::CallIonization<bmpl::_1>, MakeIdentifier<bmpl::_1> > particleIonization;
+            particleIonization(forward(particleStorage), cellDescription, currentStep);
+        }
 
         /* call the synchrotron radiation module for each radiating species (normally electrons) */
         typedef typename PMacc::particles::traits::FilterByFlag<VectorAllSpecies,
                                                                 synchrotronPhotons<> >::type AllSynchrotronPhotonsSpecies;
 
-        ForEach<AllSynchrotronPhotonsSpecies,
-                particles::CallSynchrotronPhotons<bmpl::_1>,
-                MakeIdentifier<bmpl::_1> > synchrotronRadiation;
-        synchrotronRadiation(forward(particleStorage), cellDescription, currentStep, this->synchrotronFunctions);
+        {
+            simulationControl::ProfileScope profileScope("synchrotronPhotons");
+            ForEach<AllSynchrotronPhotonsSpecies,
+                    particles::CallSynchrotronPhotons<bmpl::_1>,
+                    MakeIdentifier<bmpl::_1> > synchrotronRadiation;
+            synchrotronRadiation(forward(particleStorage), cellDescription, currentStep, this->synchrotronFunctions);
+        }
 
 
         EventTask initEvent = __getTransactionEvent();
@@ -489,39 +565,66 @@ public:
         EventTask commEvent;
 
         /* push all species */
-        particles::PushAllSpecies pushAllSpecies;
-        pushAllSpecies(particleStorage, currentStep, initEvent, updateEvent, commEvent);
+        {
+            simulationControl::ProfileScope profileScope("particlePush");
+            particles::PushAllSpecies pushAllSpecies;
+            pushAllSpecies(particleStorage, currentStep, initEvent, updateEvent, commEvent);
+        }
 
-        __setTransactionEvent(updateEvent);
-        /** remove background field for particle pusher */
-        (*pushBGField)(fieldE, nvfct::Sub(), FieldBackgroundE(fieldE->getUnit()),
-                       currentStep, FieldBackgroundE::InfluenceParticlePusher);
-        (*pushBGField)(fieldB, nvfct::Sub(), FieldBackgroundB(fieldB->getUnit()),
-                       currentStep, FieldBackgroundB::InfluenceParticlePusher);
+        /* the particle exchange overlaps with the field solver, only if the
+         * phases are profiled the communication is waited for separately */
+        if (Environment<>::get().StepProfiler().isActive())
+        {
+            simulationControl::ProfileScope profileScope("particleCommunication");
+            commEvent.waitForFinished();
+        }
 
-        this->myFieldSolver->update_beforeCurrent(currentStep);
+        __setTransactionEvent(updateEvent);
+        {
+            simulationControl::ProfileScope profileScope("fieldSolver");
+            /** remove background field for particle pusher */
+            (*pushBGField)(fieldE, nvfct::Sub(), FieldBackgroundE(fieldE->getUnit()),
+                           currentStep, FieldBackgroundE::InfluenceParticlePusher);
+            (*pushBGField)(fieldB, nvfct::Sub(), FieldBackgroundB(fieldB->getUnit()),
+                           currentStep, FieldBackgroundB::InfluenceParticlePusher);
+
+            this->myFieldSolver->update_beforeCurrent(currentStep);
+        }
 
         FieldJ::ValueType zeroJ( FieldJ::ValueType::create(0.) );
         fieldJ->assign( zeroJ );
 
         __setTransactionEvent(commEvent);
-        (*currentBGField)(fieldJ, nvfct::Add(), FieldBackgroundJ(fieldJ->getUnit()),
-                          currentStep, FieldBackgroundJ::activated);
 #if (ENABLE_CURRENT == 1)
         typedef typename PMacc::particles::traits::FilterByFlag
         <
             VectorAllSpecies,
             current<>
         >::type VectorSpeciesWithCurrentSolver;
-        ForEach<VectorSpeciesWithCurrentSolver, ComputeCurrent<bmpl::_1,bmpl::int_<CORE + BORDER> >, MakeIdentifier<bmpl::_1> > computeCurrent;
-        computeCurrent(forward(fieldJ),forward(particleStorage), currentStep);
 #endif
+        {
+            simulationControl::ProfileScope profileScope("currentDeposition");
+            (*currentBGField)(fieldJ, nvfct::Add(), FieldBackgroundJ(fieldJ->getUnit()),
+                              currentStep, FieldBackgroundJ::activated);
+#if (ENABLE_CURRENT == 1)
+            ForEach<VectorSpeciesWithCurrentSolver, ComputeCurrent<bmpl::_1,bmpl::int_<CORE + BORDER> >, MakeIdentifier<bmpl::_1> > computeCurrent;
+            computeCurrent(forward(fieldJ),forward(particleStorage), currentStep);
+#endif
+        }
 
 #if  (ENABLE_CURRENT == 1)
         if(bmpl::size<VectorSpeciesWithCurrentSolver>::type::value > 0)
         {
             EventTask eRecvCurrent = fieldJ->asyncCommunication(__getTransactionEvent());
 
+            if (Environment<>::get().StepProfiler().isActive())
+            {
+                simulationControl::ProfileScope profileScope("currentCommunication");
+                eRecvCurrent.waitForFinished();
+            }
+
+            simulationControl::ProfileScope profileScope("addCurrentToEMF");
+
             const DataSpace<simDim> currentRecvLower( GetMargin<fieldSolver::CurrentInterpolation>::LowerMargin( ).toRT( ) );
             const DataSpace<simDim> currentRecvUpper( GetMargin<fieldSolver::CurrentInterpolation>::UpperMargin( ).toRT( ) );
 
@@ -548,7 +651,10 @@ public:
         }
 #endif
 
-        this->myFieldSolver->update_afterCurrent(currentStep);
+        {
+            simulationControl::ProfileScope profileScope("fieldSolver");
+            this->myFieldSolver->update_afterCurrent(currentStep);
+        }
     }
 
     virtual void movingWindowCheck(uint32_t currentStep)
@@ -652,6 +758,7 @@ protected:
 
     // Synchrotron functions (used in synchrotronPhotons module)
     particles::synchrotronPhotons::SynchrotronFunctions synchrotronFunctions;
+    std::string synchrotronFunctionsCacheDirectory;
 
     // factory for the random number generator
     typedef PMacc::random::RNGProvider<simDim, PMacc::random::methods::XorMin> RNGFactory;
@@ -675,6 +782,18 @@ protected:
     std::vector<std::string> gridDistribution;
 
     bool slidingWindow;
+
+    /* steps between two adaptions of the particle exchange buffers */
+    uint32_t exchangeBufferPeriod;
+    uint32_t exchangeBufferMaxMiB;
+
+    /* steps between two sorts of the particles by cell */
+    uint32_t particleSortPeriod;
+
+    /* spare particle frames per species and their statistics output */
+    uint32_t framePoolSlots;
+    uint32_t framePoolProbes;
+    uint32_t framePoolLogPeriod;
 };
 } /* namespace picongpu */
 
@@ -89,7 +89,13 @@ using namespace picongpu;
  */
 int main(int argc, char **argv)
 {
+#if (PIC_MPI_THREAD_MULTIPLE == 1)
+    /* the provided level is checked by the plugins which need it */
+    int threadLevel = MPI_THREAD_SINGLE;
+    MPI_CHECK(MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &threadLevel));
+#else
     MPI_CHECK(MPI_Init(&argc, &argv));
+#endif
 
     picongpu::simulation_starter::SimStarter sim;
     ArgsParser::ArgsErrorCode parserCode = sim.parseConfigs(argc, argv);
@@ -20,12 +20,17 @@
 
 #include "include/plugins/common/particlePatches.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
 namespace picongpu
 {
 namespace openPMD
 {
 
-    ParticlePatches::ParticlePatches( const size_t n )
+    ParticlePatches::ParticlePatches( const size_t n ) :
+        indexDim( 0u ),
+        maxOuterExtent( 0u )
     {
         /* zero particles */
         numParticles = std::vector<uint64_t>( n, 0u );
@@ -71,6 +76,151 @@ namespace openPMD
         return numParticles.size();
     }
 
+    const std::vector<uint64_t>& ParticlePatches::offsetComp( const uint32_t comp ) const
+    {
+        if( comp == 0 )
+            return offsetX;
+        if( comp == 1 )
+            return offsetY;
+        return offsetZ;
+    }
+
+    const std::vector<uint64_t>& ParticlePatches::extentComp( const uint32_t comp ) const
+    {
+        if( comp == 0 )
+            return extentX;
+        if( comp == 1 )
+            return extentY;
+        return extentZ;
+    }
+
+    int ParticlePatches::compareOffset( const size_t id, const uint64_t* const offset ) const
+    {
+        for( int d = int( indexDim ) - 1; d >= 0; --d )
+        {
+            const uint64_t patchOffset = offsetComp( d )[ id ];
+            if( patchOffset < offset[ d ] )
+                return -1;
+            if( patchOffset > offset[ d ] )
+                return 1;
+        }
+        return 0;
+    }
+
+    /** strict weak ordering of patch ids by their offset */
+    struct PatchOffsetLess
+    {
+        const ParticlePatches& patches;
+        const uint32_t dimensionality;
+
+        PatchOffsetLess( const ParticlePatches& p, const uint32_t dim ) :
+            patches( p ), dimensionality( dim )
+        {
+        }
+
+        bool operator()( const size_t a, const size_t b ) const
+        {
+            const std::vector<uint64_t>* comps[] = {
+                &patches.offsetX, &patches.offsetY, &patches.offsetZ
+            };
+            for( int d = int( dimensionality ) - 1; d >= 0; --d )
+            {
+                if( (*comps[ d ])[ a ] != (*comps[ d ])[ b ] )
+                    return (*comps[ d ])[ a ] < (*comps[ d ])[ b ];
+            }
+            return a < b;
+        }
+    };
+
+    void ParticlePatches::buildIndex( const uint32_t dimensionality )
+    {
+        indexDim = dimensionality;
+        sortedIds.resize( size() );
+        for( size_t i = 0; i < size(); ++i )
+            sortedIds[ i ] = i;
+        std::sort( sortedIds.begin(), sortedIds.end(), PatchOffsetLess( *this, dimensionality ) );
+
+        const std::vector<uint64_t>& outerExtent = extentComp( dimensionality - 1 );
+        maxOuterExtent = 0u;
+        for( size_t i = 0; i < size(); ++i )
+            maxOuterExtent = std::max( maxOuterExtent, outerExtent[ i ] );
+    }
+
+    std::vector<size_t> ParticlePatches::findOverlapping(
+        const uint64_t* const offset,
+        const uint64_t* const extent
+    ) const
+    {
+        if( sortedIds.size() != size() || indexDim == 0u )
+            throw std::runtime_error( "ParticlePatches: buildIndex() was not called" );
+
+        std::vector<size_t> result;
+
+        /* fast path: same domain decomposition as the patches */
+        size_t first = 0;
+        size_t last = sortedIds.size();
+        while( first < last )
+        {
+            const size_t mid = first + ( last - first ) / 2;
+            if( compareOffset( sortedIds[ mid ], offset ) < 0 )
+                first = mid + 1;
+            else
+                last = mid;
+        }
+        if( first < sortedIds.size() && compareOffset( sortedIds[ first ], offset ) == 0 )
+        {
+            const size_t id = sortedIds[ first ];
+            bool sameExtent = true;
+            for( uint32_t d = 0; d < indexDim; ++d )
+                if( extentComp( d )[ id ] != extent[ d ] )
+                    sameExtent = false;
+            if( sameExtent )
+            {
+                result.push_back( id );
+                return result;
+            }
+        }
+
+        /* all candidates start in the slowest varying component inside
+         * [offset - maxOuterExtent + 1, offset + extent) */
+        const uint32_t outer = indexDim - 1;
+        const std::vector<uint64_t>& outerOffset = offsetComp( outer );
+        const uint64_t outerBegin =
+            offset[ outer ] >= maxOuterExtent ? offset[ outer ] - maxOuterExtent + 1u : 0u;
+        const uint64_t outerEnd = offset[ outer ] + extent[ outer ];
+
+        first = 0;
+        last = sortedIds.size();
+        while( first < last )
+        {
+            const size_t mid = first + ( last - first ) / 2;
+            if( outerOffset[ sortedIds[ mid ] ] < outerBegin )
+                first = mid + 1;
+            else
+                last = mid;
+        }
+
+        for( size_t i = first;
+             i < sortedIds.size() && outerOffset[ sortedIds[ i ] ] < outerEnd;
+             ++i )
+        {
+            const size_t id = sortedIds[ i ];
+            bool isOverlapping = true;
+            for( uint32_t d = 0; d < indexDim; ++d )
+            {
+                const uint64_t begin = offsetComp( d )[ id ];
+                const uint64_t end = begin + extentComp( d )[ id ];
+                if( begin >= offset[ d ] + extent[ d ] || end <= offset[ d ] )
+                    isOverlapping = false;
+            }
+            if( isOverlapping )
+                result.push_back( id );
+        }
+
+        std::sort( result.begin(), result.end() );
+        return result;
+    }
+
     void ParticlePatches::print()
     {
         std::cout << "id | numParticles numParticlesOffset "
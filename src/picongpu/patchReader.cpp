@@ -21,6 +21,10 @@
 #if( ENABLE_HDF5 == 1 )
 
 #  include "include/plugins/hdf5/openPMD/patchReader.hpp"
+#  include "communication/manager_common.h"
+
+#  include <vector>
+#  include <algorithm>
 
 namespace picongpu
 {
@@ -28,17 +32,16 @@ namespace hdf5
 {
 namespace openPMD
 {
-    void PatchReader::checkSpatialTypeSize(
+    uint32_t PatchReader::checkSpatialTypeSize(
             splash::DataCollector* const dc,
-            const uint32_t availableRanks,
             const int32_t id,
             const std::string particlePatchPathComponent
     ) const
     {
-        // will later read into 1D buffer from first position on
-        splash::Dimensions dstBuffer(availableRanks, 1, 1);
+        // only the meta data is read, an empty buffer adopts the size of the data set
+        splash::Dimensions dstBuffer(0, 0, 0);
         splash::Dimensions dstOffset(0, 0, 0);
-        // sizeRead will be set
+        // sizeRead will be set to the size of the data set
         splash::Dimensions sizeRead(0, 0, 0);
 
         splash::CollectionType* colType = dc->readMeta(
@@ -48,32 +51,37 @@ namespace openPMD
             dstOffset,
             sizeRead );
 
-        // check if the 1D list of patches has the right length
-        assert( sizeRead[0] == availableRanks );
+        // the list of patches is 1D
+        assert( sizeRead[1] == 1 && sizeRead[2] == 1 );
 
         // currently only support uint64_t types to spare type conversation
         assert( typeid(*colType) == typeid(splash::ColTypeUInt64) );
 
         // free collections
         __delete( colType );
+
+        return sizeRead[0];
     }
 
     void PatchReader::readPatchAttribute(
         splash::DataCollector* const dc,
-        const uint32_t availableRanks,
+        const uint32_t numPatches,
         const int32_t id,
         const std::string particlePatchPathComponent,
         uint64_t* const dest
     ) const
     {
-        // will later read into 1D buffer from first position on
-        splash::Dimensions dstBuffer(availableRanks, 1, 1);
-        splash::Dimensions dstOffset(0, 0, 0);
         // sizeRead will be set
         splash::Dimensions sizeRead(0, 0, 0);
 
         // check if types, number of patches and names are supported
-        checkSpatialTypeSize( dc, availableRanks, id, particlePatchPathComponent.c_str() );
+        const uint32_t numPatchesInComponent =
+            checkSpatialTypeSize( dc, id, particlePatchPathComponent.c_str() );
+        if( numPatchesInComponent != numPatches )
+            throw std::runtime_error(
+                std::string("Inconsistent number of particle patches in ") +
+                particlePatchPathComponent
+            );
 
         // read actual offset and extent data of particle patch component
         dc->read( id,
@@ -82,42 +90,126 @@ namespace openPMD
                   (void*)dest );
     }
 
-    picongpu::openPMD::ParticlePatches PatchReader::operator()(
-        splash::DataCollector* const dc,
-        const uint32_t availableRanks,
+    void PatchReader::readTable(
+        const std::string& filename,
+        MPI_Info info,
         const uint32_t dimensionality,
         const int32_t id,
-        const std::string particlePatchPath
+        const std::string& particlePatchPath,
+        std::vector<uint64_t>& table
     ) const
     {
-        // allocate memory for patches
-        picongpu::openPMD::ParticlePatches particlePatches( availableRanks );
+        const uint32_t maxOpenFilesPerNode = 1;
+
+        /* the checkpoint is opened only by the calling rank, the reads of
+         * the parallel DataCollector are collective within MPI_COMM_SELF */
+        splash::ParallelDataCollector pdc(
+            MPI_COMM_SELF,
+            info,
+            splash::Dimensions(1, 1, 1),
+            maxOpenFilesPerNode );
+
+        splash::DataCollector::FileCreationAttr attr;
+        splash::DataCollector::initFileCreationAttr( attr );
+        attr.fileAccType = splash::DataCollector::FAT_READ;
+        pdc.open( filename.c_str(), attr );
+
+        // the number of patches is the number of ranks which wrote the file
+        const uint32_t numPatches = checkSpatialTypeSize(
+            &pdc, id, particlePatchPath + std::string("numParticles")
+        );
+
+        // one contiguous table: numParticles, numParticlesOffset, offset, extent
         const std::string name_lookup[] = {"x", "y", "z"};
+        std::vector<std::string> names;
+        names.push_back( particlePatchPath + std::string("numParticles") );
+        names.push_back( particlePatchPath + std::string("numParticlesOffset") );
+        for( uint32_t d = 0; d < dimensionality; ++d )
+            names.push_back( particlePatchPath + std::string("offset/") + name_lookup[d] );
         for( uint32_t d = 0; d < dimensionality; ++d )
+            names.push_back( particlePatchPath + std::string("extent/") + name_lookup[d] );
+
+        table.resize( names.size() * numPatches );
+        for( size_t c = 0; c < names.size() && numPatches != 0; ++c )
+            readPatchAttribute( &pdc, numPatches, id, names[c], &table[c * numPatches] );
+
+        pdc.close();
+        pdc.finalize();
+    }
+
+    picongpu::openPMD::ParticlePatches PatchReader::operator()(
+        const std::string& filename,
+        MPI_Comm comm,
+        MPI_Info info,
+        const uint32_t dimensionality,
+        const int32_t id,
+        const std::string particlePatchPath
+    ) const
+    {
+        int rank = 0;
+        MPI_CHECK( MPI_Comm_rank( comm, &rank ) );
+
+        /* only rank 0 accesses the file system
+         *
+         * An error on rank 0 is broadcasted as well, else all other ranks
+         * wait forever for the table.
+         */
+        std::vector<uint64_t> table;
+        std::string errorMsg;
+        if( rank == 0 )
         {
-            readPatchAttribute(
-                dc, availableRanks, id,
-                particlePatchPath + std::string("offset/") + name_lookup[d],
-                particlePatches.getOffsetComp( d )
-            );
-            readPatchAttribute(
-                dc, availableRanks, id,
-                particlePatchPath + std::string("extent/") + name_lookup[d],
-                particlePatches.getExtentComp( d )
+            try
+            {
+                readTable( filename, info, dimensionality, id, particlePatchPath, table );
+            }
+            catch( const splash::DCException& e )
+            {
+                errorMsg = e.what();
+            }
+            catch( const std::runtime_error& e )
+            {
+                errorMsg = e.what();
+            }
+        }
+
+        // header: failed flag, table size
+        uint64_t header[2] = { errorMsg.empty() ? 0u : 1u, table.size() };
+        MPI_CHECK( MPI_Bcast( header, 2, MPI_UINT64_T, 0, comm ) );
+        if( header[0] != 0 )
+            throw std::runtime_error(
+                std::string("HDF5: failed to read particle patches ") + particlePatchPath +
+                std::string(" on rank 0: ") + errorMsg
             );
+
+        table.resize( header[1] );
+        if( !table.empty() )
+            MPI_CHECK( MPI_Bcast( &table[0], table.size(), MPI_UINT64_T, 0, comm ) );
+
+        const uint64_t numColumns = 2 + 2 * dimensionality;
+        const uint64_t numPatches = table.size() / numColumns;
+
+        // allocate memory for patches
+        picongpu::openPMD::ParticlePatches particlePatches( numPatches );
+
+        if( numPatches != 0 )
+        {
+            std::vector<uint64_t*> columns;
+            columns.push_back( &(*particlePatches.numParticles.begin()) );
+            columns.push_back( &(*particlePatches.numParticlesOffset.begin()) );
+            for( uint32_t d = 0; d < dimensionality; ++d )
+                columns.push_back( particlePatches.getOffsetComp( d ) );
+            for( uint32_t d = 0; d < dimensionality; ++d )
+                columns.push_back( particlePatches.getExtentComp( d ) );
+
+            for( size_t c = 0; c < columns.size(); ++c )
+                std::copy(
+                    table.begin() + c * numPatches,
+                    table.begin() + ( c + 1 ) * numPatches,
+                    columns[c]
+                );
         }
 
-        // read number of particles and their starting point (offset), too
-        readPatchAttribute(
-            dc, availableRanks, id,
-            particlePatchPath + std::string("numParticles"),
-            &(*particlePatches.numParticles.begin())
-        );
-        readPatchAttribute(
-            dc, availableRanks, id,
-            particlePatchPath + std::string("numParticlesOffset"),
-            &(*particlePatches.numParticlesOffset.begin())
-        );
+        particlePatches.buildIndex( dimensionality );
 
         // return struct of array with particle patches
         return particlePatches;
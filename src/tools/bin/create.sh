@@ -21,7 +21,11 @@
 
 videoName=radiation2800
 
-radiationFolder=../totalRad
+# total spectra of the radiation plugin (<species>_radAmplitudes_<step>.h5)
+radiationFolder=../radiationHDF5
+radiationPrefix=e_radAmplitudes_
+# directory containing modules4picongpu
+picongpuPython=$(cd $(dirname $0)/../share/python && pwd)
 folderPNG=../pngElectronsYX
 pngPrefix=PngImageElectrons_yx_0.5_
 
@@ -48,7 +52,9 @@ pwdFolder=`pwd`
 
 cd $folderPDF
 #cretae data from radiation file
-for((i=$nBEGIN ; i<=$nEND ; i+=$nSTEP )) ; do $pwdFolder/matrix_view.py $pwdFolder/$radiationFolder/RadiationElectrons_$i.dat ; done
+#convert the spectra from HDF5 to the text matrix of matrix_view.py (rows: observers, columns: frequencies)
+for((i=$nBEGIN ; i<=$nEND ; i+=$nSTEP )) ; do PYTHONPATH=$picongpuPython:$PYTHONPATH python -c "import sys, numpy; from modules4picongpu.hdf5Radiation import radiationHDF5; numpy.savetxt(sys.argv[2], radiationHDF5(sys.argv[1]).get_Spectra())" $pwdFolder/$radiationFolder/$radiationPrefix$i.h5 RadiationElectrons_$i.dat ; done
+for((i=$nBEGIN ; i<=$nEND ; i+=$nSTEP )) ; do $pwdFolder/matrix_view.py RadiationElectrons_$i.dat ; done
 
 cd -
 
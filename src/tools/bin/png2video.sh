@@ -21,7 +21,7 @@
 
 videoName=radiation2800
 
-radiationFolder=../totalRad
+radiationFolder=../radiationHDF5
 folderPNG=../pngElectronsYX
 pngPrefix=PngImageElectrons_yx_0.5_
 
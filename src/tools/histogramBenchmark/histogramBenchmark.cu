@@ -0,0 +1,278 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Benchmark of the GPU histogram engine of libPMacc
+ *  (PMacc::algorithms::histogram) for 10^2 to 10^6 bins.
+ *
+ * Random values are added to a histogram
+ *  - with one float atomic per value in global memory (the former
+ *    implementation of the particle calorimeter),
+ *  - with Histogram<Floating<float> >,
+ *  - with Histogram<FixedPoint>,
+ * and compared against the serial HostHistogram. The bins are either
+ * uniformly distributed or concentrated in a few percent of the range,
+ * which is typical for energy spectra and causes atomic contention.
+ */
+
+#include "Environment.hpp"
+#include "dimensions/DataSpace.hpp"
+#include "memory/buffers/GridBuffer.hpp"
+#include "algorithms/histogram/Histogram.hpp"
+#include "algorithms/histogram/HostHistogram.hpp"
+#include "eventSystem/EventSystem.hpp"
+
+#include <mpi.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using namespace PMacc;
+    namespace histogram = PMacc::algorithms::histogram;
+
+    const uint32_t blockSize = 256;
+
+    /** add value[i] to bin[i] with the histogram engine */
+    struct KernelEngine
+    {
+        template<typename T_DeviceHistogram>
+        DINLINE void operator()(T_DeviceHistogram deviceHistogram,
+                                const uint32_t* bins,
+                                const float* values,
+                                const uint32_t numValues) const
+        {
+            auto blockHistogram = deviceHistogram.getBlockHistogram();
+
+            /* all threads iterate the same number of times, add() must not diverge */
+            const uint32_t stride = gridDim.x * blockDim.x;
+            for (uint32_t base = blockIdx.x * blockDim.x; base < numValues; base += stride)
+            {
+                const uint32_t i = base + threadIdx.x;
+                const bool isValid = i < numValues;
+                blockHistogram.add(isValid, isValid ? bins[i] : 0u, isValid ? values[i] : 0.0f);
+            }
+            blockHistogram.flush();
+        }
+    };
+
+    /** add value[i] to bin[i] with one global atomic per value */
+    struct KernelNaive
+    {
+        DINLINE void operator()(float* result,
+                                const uint32_t* bins,
+                                const float* values,
+                                const uint32_t numValues) const
+        {
+            const uint32_t stride = gridDim.x * blockDim.x;
+            for (uint32_t i = blockIdx.x * blockDim.x + threadIdx.x; i < numValues; i += stride)
+                atomicAdd(result + bins[i], values[i]);
+        }
+    };
+
+    struct Result
+    {
+        double seconds;
+        double maxError;
+    };
+
+    double maxDifference(const float_64* result, const std::vector<float_64>& reference)
+    {
+        double maxError = 0.0;
+        for (size_t i = 0; i < reference.size(); ++i)
+            maxError = std::max(maxError, std::abs(result[i] - reference[i]));
+        return maxError;
+    }
+
+    template<typename T_Accumulation>
+    Result runEngine(const uint32_t numBins,
+                     GridBuffer<uint32_t, DIM1>& bins,
+                     GridBuffer<float, DIM1>& values,
+                     const uint32_t numValues,
+                     const uint32_t numBlocks,
+                     const uint32_t repetitions,
+                     const std::vector<float_64>& reference)
+    {
+        histogram::Histogram<T_Accumulation> gpuHistogram(numBins);
+        const float_64* result = NULL;
+
+        __getTransactionEvent().waitForFinished();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < repetitions; ++r)
+        {
+            gpuHistogram.reset();
+            PMACC_KERNEL(KernelEngine{})
+                (numBlocks, blockSize, gpuHistogram.getSharedMemBytes())
+                (gpuHistogram.getDeviceHistogram(),
+                 bins.getDeviceBuffer().getBasePointer(),
+                 values.getDeviceBuffer().getBasePointer(),
+                 numValues);
+            result = gpuHistogram.merge();
+        }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+        Result r = {time.count() / double(repetitions), maxDifference(result, reference)};
+        return r;
+    }
+
+    Result runNaive(const uint32_t numBins,
+                    GridBuffer<uint32_t, DIM1>& bins,
+                    GridBuffer<float, DIM1>& values,
+                    const uint32_t numValues,
+                    const uint32_t numBlocks,
+                    const uint32_t repetitions,
+                    const std::vector<float_64>& reference)
+    {
+        GridBuffer<float, DIM1> gpuHistogram(DataSpace<DIM1>(numBins));
+
+        __getTransactionEvent().waitForFinished();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < repetitions; ++r)
+        {
+            gpuHistogram.getDeviceBuffer().setValue(0.0f);
+            PMACC_KERNEL(KernelNaive{})
+                (numBlocks, blockSize)
+                (gpuHistogram.getDeviceBuffer().getBasePointer(),
+                 bins.getDeviceBuffer().getBasePointer(),
+                 values.getDeviceBuffer().getBasePointer(),
+                 numValues);
+            gpuHistogram.deviceToHost();
+            __getTransactionEvent().waitForFinished();
+        }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+        std::vector<float_64> result(numBins);
+        for (uint32_t i = 0; i < numBins; ++i)
+            result[i] = gpuHistogram.getHostBuffer().getBasePointer()[i];
+
+        Result r = {time.count() / double(repetitions), maxDifference(&result[0], reference)};
+        return r;
+    }
+
+    void printUsage(const char* name)
+    {
+        std::cout << "usage: " << name << " [--values N] [--repetitions N] [--minBins N] [--maxBins N]" << std::endl;
+    }
+
+    void printResult(const uint32_t numBins, const std::string& distribution, const std::string& method,
+                     const uint32_t numValues, const Result& result)
+    {
+        std::cout << std::left << std::setw(10) << numBins << std::setw(14) << distribution
+                  << std::setw(20) << method
+                  << std::setw(16) << float_64(numValues) / result.seconds * 1.0e-6
+                  << std::setw(16) << result.maxError << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t numValues = 1u << 24;
+    uint32_t repetitions = 10;
+    uint32_t minBins = 100;
+    uint32_t maxBins = 1000000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (arg == "--help" || i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--values")
+            numValues = atoi(value);
+        else if (arg == "--repetitions")
+            repetitions = atoi(value);
+        else if (arg == "--minBins")
+            minBins = atoi(value);
+        else if (arg == "--maxBins")
+            maxBins = atoi(value);
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    MPI_Init(&argc, &argv);
+    {
+        Environment<DIM2>::get().initDevices(DataSpace<DIM2>(1, 1), DataSpace<DIM2>(1, 1));
+
+        GridBuffer<uint32_t, DIM1> bins(DataSpace<DIM1>(numValues));
+        GridBuffer<float, DIM1> values(DataSpace<DIM1>(numValues));
+        /* enough blocks to fill the GPU, each block loops over several values */
+        const uint32_t numBlocks = std::min((numValues + blockSize - 1) / blockSize, 4096u);
+
+        std::cout << "values: " << numValues << ", repetitions: " << repetitions << std::endl;
+        std::cout << std::left << std::setw(10) << "bins" << std::setw(14) << "distribution"
+                  << std::setw(20) << "method" << std::setw(16) << "Mvalues/s"
+                  << std::setw(16) << "max abs. error" << std::endl;
+
+        const char* distributions[2] = {"uniform", "narrow"};
+        for (uint32_t numBins = minBins; numBins <= maxBins; numBins *= 10)
+            for (int d = 0; d < 2; ++d)
+            {
+                /* narrow: all values within 2% of the bins around the center */
+                const uint32_t binRange = d == 0 ? numBins : std::max(numBins / 50, 1u);
+                const uint32_t binOffset = (numBins - binRange) / 2;
+
+                histogram::HostHistogram reference(numBins);
+                uint32_t state = 12345u;
+                for (uint32_t i = 0; i < numValues; ++i)
+                {
+                    state = state * 1664525u + 1013904223u;
+                    const uint32_t bin = binOffset + (state >> 8) % binRange;
+                    /* weighting like values in (0, 2] */
+                    const float value = float((state & 0xffu) + 1u) / 128.0f;
+                    bins.getHostBuffer().getBasePointer()[i] = bin;
+                    values.getHostBuffer().getBasePointer()[i] = value;
+                }
+
+                const auto start = std::chrono::steady_clock::now();
+                for (uint32_t i = 0; i < numValues; ++i)
+                    reference.add(bins.getHostBuffer().getBasePointer()[i], values.getHostBuffer().getBasePointer()[i]);
+                const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+                const std::vector<float_64> referenceResult = reference.getResult();
+
+                bins.hostToDevice();
+                values.hostToDevice();
+
+                const Result hostResult = {time.count(), 0.0};
+                printResult(numBins, distributions[d], "host reference", numValues, hostResult);
+                printResult(numBins, distributions[d], "global atomics",
+                            numValues, runNaive(numBins, bins, values, numValues, numBlocks, repetitions, referenceResult));
+                printResult(numBins, distributions[d], "engine float",
+                            numValues, runEngine<histogram::accumulation::Floating<float> >(
+                                numBins, bins, values, numValues, numBlocks, repetitions, referenceResult));
+                printResult(numBins, distributions[d], "engine fixed point",
+                            numValues, runEngine<histogram::accumulation::FixedPoint>(
+                                numBins, bins, values, numValues, numBlocks, repetitions, referenceResult));
+            }
+    }
+    Environment<>::get().finalize();
+    MPI_Finalize();
+
+    return 0;
+}
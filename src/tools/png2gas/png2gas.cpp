@@ -21,6 +21,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <cstring>
 #include <pngwriter.h>
 #include <splash/splash.h>
 #include <mpi.h>
@@ -29,6 +30,11 @@
 using namespace splash;
 namespace po = boost::program_options;
 
+/** attribute of the density dataset, number of cells the 2D profile
+ * (z size 1) is repeated in z direction (see gasProfiles::FromHDF5Impl)
+ */
+#define EXTRUSION_ATTR_NAME "extrusionSize"
+
 typedef struct
 {
     std::string filename;
@@ -37,6 +43,7 @@ typedef struct
     int iteration;
     Dimensions dataSize;
     Dimensions dataOffset;
+    bool extrude;
 } Options;
 
 bool parseCmdLine(int argc, char **argv, Options &options)
@@ -49,6 +56,7 @@ bool parseCmdLine(int argc, char **argv, Options &options)
         options.densityDataset = "fields/e_chargeDensity";
         options.dataOffset.set(0, 0, 0);
         options.iteration = 0;
+        options.extrude = false;
 
         std::stringstream desc_stream;
         desc_stream << "Usage " << argv[0] << " <png-file> -g width height depth [options]" << std::endl;
@@ -66,6 +74,9 @@ bool parseCmdLine(int argc, char **argv, Options &options)
                 "Output filename (basepart)")
                 ("dataset,d", po::value<std::string > (&options.densityDataset)->default_value(options.densityDataset),
                 "Fully qualified density HDF5 dataset name")
+                ("extrude", po::value<bool > (&options.extrude)->zero_tokens(),
+                "Store only the 2D profile (z size 1) and the attribute '" EXTRUSION_ATTR_NAME "' "
+                "with the grid depth, the profile is repeated in z direction when it is loaded")
                 ;
 
         po::positional_options_description pos_options_descr;
@@ -128,52 +139,85 @@ int main(int argc, char **argv)
 
     MPI_Init(NULL, NULL);
 
-    Dimensions data_size(options.dataSize);
-    std::cout << "Creating density data with size " << data_size.toString() << std::endl;
+    int mpiRank;
+    int mpiSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
 
-    std::cout << " Reading PNG file '" << options.filename << "'" << std::endl;
-    pngwriter image(data_size[1], data_size[0], 0, (options.filename + std::string(".tmp")).c_str());
-    image.readfromfile(options.filename.c_str());
+    Dimensions data_size(options.dataSize);
+    const size_t sliceSize = data_size[0] * data_size[1];
+    /* the normalized density of one z plane, index y * size.x + x */
+    std::vector<float> slice(sliceSize, 0.0f);
+    int imageValid = 1;
 
-    if (image.getwidth() != (int) data_size[1] || image.getheight() != (int) data_size[0])
+    if (mpiRank == 0)
     {
-        image.close();
-        std::cerr << "Invalid image size (" << image.getwidth() << "," <<
-                image.getheight() << ") for data size" << std::endl;
-        MPI_Finalize();
-        return -1;
-    }
+        std::cout << "Creating density data with size " << data_size.toString() << std::endl;
 
-    float *data = new float[data_size.getScalarSize()];
-    memset(data, 0, data_size.getScalarSize() * sizeof (float));
+        std::cout << " Reading PNG file '" << options.filename << "'" << std::endl;
+        pngwriter image(data_size[1], data_size[0], 0, (options.filename + std::string(".tmp")).c_str());
+        image.readfromfile(options.filename.c_str());
 
-    for (size_t x = 0; x < data_size[0]; ++x)
-        for (size_t y = 0; y < data_size[1]; ++y)
+        if (image.getwidth() != (int) data_size[1] || image.getheight() != (int) data_size[0])
         {
-            /* pngwriter coordinates start at (1,1) and the y direction is inverted */
-            int pos_x = 1 + y;
-            int pos_y = 1 + (data_size[0] - x - 1);
+            std::cerr << "Invalid image size (" << image.getwidth() << "," <<
+                    image.getheight() << ") for data size" << std::endl;
+            imageValid = 0;
+        }
+        else
+        {
+            for (size_t x = 0; x < data_size[0]; ++x)
+                for (size_t y = 0; y < data_size[1]; ++y)
+                {
+                    /* pngwriter coordinates start at (1,1) and the y direction is inverted */
+                    int pos_x = 1 + y;
+                    int pos_y = 1 + (data_size[0] - x - 1);
 
-            double color = image.dreadHSV(pos_x, pos_y, 3);
+                    double color = image.dreadHSV(pos_x, pos_y, 3);
 
-            image.plot(pos_x, pos_y, color, color, color);
+                    image.plot(pos_x, pos_y, color, color, color);
 
-            for (size_t z = 0; z < data_size[2]; ++z)
-            {
-                size_t index = z * (data_size[0] * data_size[1]) + y * data_size[0] + x;
-                data[index] = color;
-            }
+                    slice[y * data_size[0] + x] = color;
+                }
         }
 
-    /* write and close the output png */
-    image.close();
+        /* write and close the output png */
+        image.close();
+    }
+
+    MPI_Bcast(&imageValid, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (!imageValid)
+    {
+        MPI_Finalize();
+        return -1;
+    }
+    MPI_Bcast(&slice[0], sliceSize, MPI_FLOAT, 0, MPI_COMM_WORLD);
+
+    /* all z planes are equal, therefore each rank creates only its part of
+     * the volume (z-slab) or only the 2D profile is stored
+     */
+    Dimensions globalSize(data_size);
+    if (options.extrude)
+        globalSize[2] = 1;
+
+    const size_t firstPlane = globalSize[2] * mpiRank / mpiSize;
+    const size_t endPlane = globalSize[2] * (mpiRank + 1) / mpiSize;
+    Dimensions localSize(data_size[0], data_size[1], endPlane - firstPlane);
+    Dimensions localOffset(0, 0, firstPlane);
+
+    std::vector<float> data(std::max(localSize.getScalarSize(), size_t(1)));
+
+    #pragma omp parallel for
+    for (int z = 0; z < (int) localSize[2]; ++z)
+        memcpy(&data[z * sliceSize], &slice[0], sliceSize * sizeof (float));
 
-    std::cout << " Creating density HDF5 file '" << options.densityFilename << "_" <<
-            options.iteration << ".h5'" << std::endl;
+    if (mpiRank == 0)
+        std::cout << " Creating density HDF5 file '" << options.densityFilename << "_" <<
+                options.iteration << ".h5'" << std::endl;
 
     /* write density information to HDF5 */
     ParallelDomainCollector *pdc = new
-            ParallelDomainCollector(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(1, 1, 1), 1);
+            ParallelDomainCollector(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(mpiSize, 1, 1), 1);
     DataCollector::FileCreationAttr attr;
     DataCollector::initFileCreationAttr(attr);
     pdc->open(options.densityFilename.c_str(), attr);
@@ -181,27 +225,31 @@ int main(int argc, char **argv)
     ColTypeFloat ctFloat;
     pdc->writeDomain(
             options.iteration,
+            globalSize,
+            localOffset,
             ctFloat,
             data_size.getDims(),
-            Selection(data_size),
+            Selection(localSize),
             options.densityDataset.c_str(),
             Domain(
                    options.dataOffset,
-                   data_size
-            ),
-            Domain(
-                   options.dataOffset,
-                   data_size
+                   globalSize
             ),
             DomainCollector::GridType,
-            data);
+            &data[0]);
+
+    if (options.extrude)
+    {
+        ColTypeUInt64 ctUInt64;
+        uint64_t extrusionSize = data_size[2];
+        pdc->writeAttribute(options.iteration, ctUInt64, options.densityDataset.c_str(),
+                EXTRUSION_ATTR_NAME, &extrusionSize);
+    }
 
     pdc->close();
     pdc->finalize();
     delete pdc;
 
-    delete[] data;
-
     MPI_Finalize();
 
     return 0;
@@ -0,0 +1,366 @@
+/**
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of PIConGPU.
+ *
+ * PIConGPU is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * PIConGPU is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PIConGPU.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** Compares the direct DFT of the radiation plugin with the time-domain
+ *  (FFT/NUFFT) spectrum on synthetic trajectories.
+ *
+ * Electrons oscillate in an undulator-like field. For each time step and
+ * observer the real amplitude and the retarded time are computed like
+ * Calc_Amplitude<Retarded_time_1, Old_DFT> in plugins/radiation. The
+ * spectrum is computed
+ *  - directly in double precision (reference),
+ *  - directly with a single precision phase (like KernelRadiationParticles),
+ *  - with radiationSpectral::TimeDomainSpectrum
+ * for a linear (chirp-z) and a logarithmic (NUFFT) frequency grid.
+ */
+
+#include "plugins/radiation/spectralTransform.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using picongpu::radiationSpectral::Complex;
+    using picongpu::radiationSpectral::TimeDomainSpectrum;
+
+    const double speedOfLight = 2.99792458e8;
+
+    struct Vec
+    {
+        double x, y, z;
+
+        Vec(double x = 0., double y = 0., double z = 0.) : x(x), y(y), z(z)
+        {
+        }
+
+        Vec operator+(const Vec& o) const { return Vec(x + o.x, y + o.y, z + o.z); }
+        Vec operator-(const Vec& o) const { return Vec(x - o.x, y - o.y, z - o.z); }
+        Vec operator*(const double s) const { return Vec(x * s, y * s, z * s); }
+        double operator*(const Vec& o) const { return x * o.x + y * o.y + z * o.z; }
+        /* cross product */
+        Vec operator%(const Vec& o) const
+        {
+            return Vec(y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x);
+        }
+    };
+
+    /** one radiation sample of a particle for one observer */
+    struct Sample
+    {
+        double tRet;
+        Vec amplitude;
+    };
+
+    struct Parameters
+    {
+        uint32_t numParticles;
+        uint32_t numSteps;
+        uint32_t numObserver;
+        uint32_t numOmega;
+        double gamma;
+        double undulatorParameter;
+        /* time steps per undulator period */
+        double stepsPerPeriod;
+        double deltaT;
+
+        Parameters() :
+            numParticles(32), numSteps(1000), numObserver(8), numOmega(1024),
+            gamma(5.0), undulatorParameter(0.5), stepsPerPeriod(100.0), deltaT(1.0e-17)
+        {
+        }
+    };
+
+    /** samples[observer][particle * numSteps + step] */
+    std::vector<std::vector<Sample> > createSamples(const Parameters& p, const std::vector<Vec>& look)
+    {
+        std::vector<std::vector<Sample> > samples(look.size());
+        const double omegaUndulator = 2.0 * M_PI / (p.stepsPerPeriod * p.deltaT);
+        const double betaMean = std::sqrt(1.0 - 1.0 / (p.gamma * p.gamma));
+        const double betaAmplitude = p.undulatorParameter / p.gamma;
+
+        srand(42);
+        for (uint32_t i = 0; i < p.numParticles; ++i)
+        {
+            const double phase = 2.0 * M_PI * double(rand()) / RAND_MAX;
+            Vec position(1.0e-7 * double(rand()) / RAND_MAX,
+                         1.0e-7 * double(rand()) / RAND_MAX,
+                         1.0e-6 * double(rand()) / RAND_MAX);
+
+            Vec betaOld;
+            for (uint32_t step = 0; step <= p.numSteps; ++step)
+            {
+                const double t = double(step) * p.deltaT;
+                const double betaX = betaAmplitude * std::sin(omegaUndulator * t + phase);
+                const Vec beta(betaX, 0.0, std::sqrt(betaMean * betaMean - betaX * betaX));
+                position = position + beta * (speedOfLight * p.deltaT);
+
+                if (step > 0)
+                {
+                    /* Old_DFT: n x ((n - beta) x dbeta/dt) / (1 - beta n)^2 */
+                    const Vec betaDot = (beta - betaOld) * (1.0 / p.deltaT);
+                    for (size_t o = 0; o < look.size(); ++o)
+                    {
+                        const Vec& n = look[o];
+                        const double oneMinusBetaN = 1.0 - beta * n;
+                        Sample sample;
+                        sample.amplitude = (n % ((n - beta) % betaDot)) *
+                            (p.deltaT / (oneMinusBetaN * oneMinusBetaN));
+                        /* Retarded_time_1 */
+                        sample.tRet = t - (n * position) / speedOfLight;
+                        samples[o].push_back(sample);
+                    }
+                }
+                betaOld = beta;
+            }
+        }
+        return samples;
+    }
+
+    /** direct sum over all samples, result[(observer * 3 + component) * numOmega + k] */
+    template<typename T_Phase>
+    void directSpectrum(const std::vector<std::vector<Sample> >& samples, const std::vector<double>& omega,
+                        std::vector<Complex>& result)
+    {
+        const int numObserver = samples.size();
+        const int numOmega = omega.size();
+        result.assign(numObserver * 3 * numOmega, Complex(0.0, 0.0));
+
+        #pragma omp parallel for collapse(2)
+        for (int o = 0; o < numObserver; ++o)
+            for (int k = 0; k < numOmega; ++k)
+            {
+                Complex sum[3];
+                for (size_t s = 0; s < samples[o].size(); ++s)
+                {
+                    const Sample& sample = samples[o][s];
+                    const T_Phase phase = T_Phase(sample.tRet * omega[k]);
+                    const Complex e(std::cos(phase), std::sin(phase));
+                    sum[0] += sample.amplitude.x * e;
+                    sum[1] += sample.amplitude.y * e;
+                    sum[2] += sample.amplitude.z * e;
+                }
+                for (int c = 0; c < 3; ++c)
+                    result[(o * 3 + c) * numOmega + k] = sum[c];
+            }
+    }
+
+    /** spread all samples to a time grid and transform it */
+    void timeDomainSpectrum(const std::vector<std::vector<Sample> >& samples, const std::vector<double>& omega,
+                            std::vector<Complex>& result, bool& isUniform, double& spreadSeconds,
+                            double& transformSeconds, uint32_t& numGridPoints)
+    {
+        const int numObserver = samples.size();
+        const int numOmega = omega.size();
+        result.assign(numObserver * 3 * numOmega, Complex(0.0, 0.0));
+
+        double omegaMax = 0.0;
+        for (int k = 0; k < numOmega; ++k)
+            omegaMax = std::max(omegaMax, std::abs(omega[k]));
+        const double dt = TimeDomainSpectrum::getSampleSpacing(omegaMax);
+        const double margin = TimeDomainSpectrum::getSpreadMargin(dt);
+
+        /* one grid size for all observer, like the device buffer */
+        std::vector<double> t0(numObserver);
+        double maxSpan = 0.0;
+        for (int o = 0; o < numObserver; ++o)
+        {
+            double tMin = samples[o][0].tRet;
+            double tMax = tMin;
+            for (size_t s = 0; s < samples[o].size(); ++s)
+            {
+                tMin = std::min(tMin, samples[o][s].tRet);
+                tMax = std::max(tMax, samples[o][s].tRet);
+            }
+            t0[o] = tMin - margin;
+            maxSpan = std::max(maxSpan, tMax - tMin + 2.0 * margin);
+        }
+        numGridPoints = picongpu::radiationSpectral::nextPowerOfTwo(uint64_t(maxSpan / dt) + 1);
+
+        typedef std::chrono::high_resolution_clock Clock;
+        Clock::time_point start = Clock::now();
+
+        /* interleaved x, y, z per grid point like vector_64 on the device */
+        std::vector<double> grid(size_t(numObserver) * numGridPoints * 3, 0.0);
+        #pragma omp parallel for
+        for (int o = 0; o < numObserver; ++o)
+        {
+            double* observerGrid = &grid[size_t(o) * numGridPoints * 3];
+            for (size_t s = 0; s < samples[o].size(); ++s)
+            {
+                const Sample& sample = samples[o][s];
+                const double u = (sample.tRet - t0[o]) / dt;
+                TimeDomainSpectrum::spread(observerGrid + 0, 3, numGridPoints, u, sample.amplitude.x);
+                TimeDomainSpectrum::spread(observerGrid + 1, 3, numGridPoints, u, sample.amplitude.y);
+                TimeDomainSpectrum::spread(observerGrid + 2, 3, numGridPoints, u, sample.amplitude.z);
+            }
+        }
+        Clock::time_point spreadEnd = Clock::now();
+
+        const TimeDomainSpectrum spectrum(omega, numGridPoints, dt);
+        isUniform = spectrum.isUniform();
+        #pragma omp parallel
+        {
+            std::vector<Complex> work(spectrum.getWorkSize());
+            #pragma omp for collapse(2)
+            for (int o = 0; o < numObserver; ++o)
+                for (int c = 0; c < 3; ++c)
+                    spectrum.transform(&grid[size_t(o) * numGridPoints * 3 + c], 3, t0[o],
+                                       &work[0], &result[(o * 3 + c) * numOmega]);
+        }
+        Clock::time_point transformEnd = Clock::now();
+
+        spreadSeconds = std::chrono::duration<double>(spreadEnd - start).count();
+        transformSeconds = std::chrono::duration<double>(transformEnd - spreadEnd).count();
+    }
+
+    /** maximal error of the intensity |A|^2 relative to the maximal reference intensity */
+    double intensityError(const std::vector<Complex>& reference, const std::vector<Complex>& test, const int numOmega)
+    {
+        const size_t numValues = reference.size() / 3;
+        std::vector<double> referenceIntensity(numValues, 0.0);
+        std::vector<double> testIntensity(numValues, 0.0);
+        for (size_t i = 0; i < reference.size(); ++i)
+        {
+            /* (o * 3 + c) * numOmega + k -> o * numOmega + k */
+            const size_t index = i / (3 * numOmega) * numOmega + i % numOmega;
+            referenceIntensity[index] += std::norm(reference[i]);
+            testIntensity[index] += std::norm(test[i]);
+        }
+
+        double maxIntensity = 0.0;
+        double maxError = 0.0;
+        for (size_t i = 0; i < numValues; ++i)
+        {
+            maxIntensity = std::max(maxIntensity, referenceIntensity[i]);
+            maxError = std::max(maxError, std::abs(testIntensity[i] - referenceIntensity[i]));
+        }
+        return maxIntensity > 0.0 ? maxError / maxIntensity : maxError;
+    }
+
+    void printUsage(const char* name)
+    {
+        std::cout << "usage: " << name << " [--particles N] [--steps N] [--observer N] [--omega N]"
+                  << " [--gamma X] [--K X]" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Parameters p;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (arg == "--help" || i + 1 >= argc)
+        {
+            printUsage(argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--particles")
+            p.numParticles = atoi(value);
+        else if (arg == "--steps")
+            p.numSteps = atoi(value);
+        else if (arg == "--observer")
+            p.numObserver = atoi(value);
+        else if (arg == "--omega")
+            p.numOmega = atoi(value);
+        else if (arg == "--gamma")
+            p.gamma = atof(value);
+        else if (arg == "--K")
+            p.undulatorParameter = atof(value);
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    /* observer around the mean velocity within an angle of 2 / gamma */
+    std::vector<Vec> look(p.numObserver);
+    for (uint32_t o = 0; o < p.numObserver; ++o)
+    {
+        const double theta = 2.0 / p.gamma * double(o) / double(std::max(p.numObserver - 1, 1u));
+        look[o] = Vec(std::sin(theta), 0.0, std::cos(theta));
+    }
+    const std::vector<std::vector<Sample> > samples = createSamples(p, look);
+
+    /* up to twice the on-axis fundamental of the undulator */
+    const double omegaUndulator = 2.0 * M_PI / (p.stepsPerPeriod * p.deltaT);
+    const double omegaMax = 4.0 * p.gamma * p.gamma * omegaUndulator /
+        (1.0 + p.undulatorParameter * p.undulatorParameter / 2.0);
+
+    std::vector<double> linearOmega(p.numOmega);
+    std::vector<double> logOmega(p.numOmega);
+    for (uint32_t k = 0; k < p.numOmega; ++k)
+    {
+        const double x = double(k) / double(p.numOmega - 1);
+        linearOmega[k] = x * omegaMax;
+        logOmega[k] = omegaMax * std::pow(1.0e-3, 1.0 - x);
+    }
+
+    std::cout << "particles: " << p.numParticles << ", steps: " << p.numSteps
+              << ", observer: " << p.numObserver << ", frequencies: " << p.numOmega << std::endl;
+    std::cout << std::left << std::setw(10) << "grid" << std::setw(26) << "method"
+              << std::setw(14) << "time [s]" << std::setw(16) << "max rel. error" << std::endl;
+
+    const char* gridNames[2] = {"linear", "log"};
+    const std::vector<double>* grids[2] = {&linearOmega, &logOmega};
+    for (int g = 0; g < 2; ++g)
+    {
+        typedef std::chrono::high_resolution_clock Clock;
+        const std::vector<double>& omega = *grids[g];
+
+        std::vector<Complex> reference;
+        Clock::time_point start = Clock::now();
+        directSpectrum<double>(samples, omega, reference);
+        const double directSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<Complex> singlePhase;
+        start = Clock::now();
+        directSpectrum<float>(samples, omega, singlePhase);
+        const double singleSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::vector<Complex> timeDomain;
+        bool isUniform = false;
+        double spreadSeconds = 0.0;
+        double transformSeconds = 0.0;
+        uint32_t numGridPoints = 0;
+        timeDomainSpectrum(samples, omega, timeDomain, isUniform, spreadSeconds, transformSeconds, numGridPoints);
+
+        std::cout << std::setw(10) << gridNames[g] << std::setw(26) << "direct DFT (double)"
+                  << std::setw(14) << directSeconds << std::setw(16) << 0.0 << std::endl;
+        std::cout << std::setw(10) << gridNames[g] << std::setw(26) << "direct DFT (float phase)"
+                  << std::setw(14) << singleSeconds
+                  << std::setw(16) << intensityError(reference, singlePhase, p.numOmega) << std::endl;
+        std::cout << std::setw(10) << gridNames[g] << std::setw(26) << (isUniform ? "time grid + chirp-z" : "time grid + NUFFT")
+                  << std::setw(14) << spreadSeconds + transformSeconds
+                  << std::setw(16) << intensityError(reference, timeDomain, p.numOmega)
+                  << "(spread " << spreadSeconds << " s, transform " << transformSeconds << " s, "
+                  << numGridPoints << " grid points)" << std::endl;
+    }
+
+    return 0;
+}
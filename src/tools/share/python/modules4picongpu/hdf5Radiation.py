@@ -63,14 +63,17 @@ class radiationHDF5:
 
     def get_timestep(self):
         """Returns simulation timestep of the hdf5 data."""
-        # this is a workaround till openPMD is implemented
-        str_timestep = self.filename.split("_")[-4]
-        if str_timestep.isdigit():
-            return int(str_timestep)
+        # each radiation file holds exactly one iteration in /data/<step>,
+        # independent of the file name:
+        # <species>_radAmplitudes_<step>.h5 (parallel output) or
+        # <species>_radAmplitudes_<step>_0_0_0.h5 (serial output before)
+        iterations = list(self.h5_file["/data"].keys())
+        if len(iterations) == 1 and iterations[0].isdigit():
+            return int(iterations[0])
         else:
             raise Exception("Could not extract timestep from " +
-                            "filename (\"{}\") - ".format(self.filename) +
-                            "Extracted: {}".format(str_timestep))
+                            "file (\"{}\") - ".format(self.filename) +
+                            "Iterations: {}".format(iterations))
 
     def get_Amplitude_x(self):
         """Returns the complex amplitudes in x-axis."""
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of splash2txt.
+ *
+ * splash2txt is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * splash2txt is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with splash2txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "export_writer.hpp"
+
+namespace
+{
+    /* number of records converted by one thread at once */
+    const size_t recordsPerBlock = 64 * 1024;
+
+    bool isLittleEndian()
+    {
+        const uint16_t value = 1;
+        return *((const uint8_t*) &value) == 1;
+    }
+
+    template<typename T>
+    const char* getNpyTypeDescription();
+
+    template<> const char* getNpyTypeDescription<float>() { return "<f4"; }
+    template<> const char* getNpyTypeDescription<double>() { return "<f8"; }
+    template<> const char* getNpyTypeDescription<uint32_t>() { return "<u4"; }
+    template<> const char* getNpyTypeDescription<uint64_t>() { return "<u8"; }
+    template<> const char* getNpyTypeDescription<int32_t>() { return "<i4"; }
+    template<> const char* getNpyTypeDescription<int64_t>() { return "<i8"; }
+
+    /* format used by the former std::stringstream output */
+    template<typename T>
+    const char* getTextFormat() { return "%g"; }
+
+    template<> const char* getTextFormat<float>() { return "%.16g"; }
+    template<> const char* getTextFormat<double>() { return "%.16g"; }
+}
+
+ExportWriter::ExportWriter(OutputFormat format, std::ostream &outStream, const std::string &delimiter) :
+m_format(format),
+m_outStream(outStream),
+m_delimiter(delimiter)
+{
+#ifdef _OPENMP
+    m_buffers.resize(omp_get_max_threads());
+#else
+    m_buffers.resize(1);
+#endif
+}
+
+template<typename T>
+void ExportWriter::appendText(std::vector<char> &buffer, const void *data,
+        size_t index, double unit, const std::string &delimiter)
+{
+    char text[32];
+    const int length = snprintf(text, sizeof(text), getTextFormat<T>(),
+            double(((const T*) data)[index]) * unit);
+    buffer.insert(buffer.end(), text, text + length);
+    buffer.insert(buffer.end(), delimiter.begin(), delimiter.end());
+}
+
+template<typename T, typename T_Out>
+void ExportWriter::appendBinary(std::vector<char> &buffer, const void *data,
+        size_t index, double unit, const std::string &)
+{
+    T_Out value = T_Out(((const T*) data)[index]);
+    if (unit != 1.0)
+        value = T_Out(value * unit);
+
+    const char *bytes = (const char*) &value;
+    const size_t offset = buffer.size();
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T_Out));
+    if (!isLittleEndian())
+        std::reverse(buffer.begin() + offset, buffer.end());
+}
+
+void ExportWriter::addColumn(const std::string &name, ColumnType type, double unit)
+{
+    Column column;
+    column.name = name;
+    column.type = type;
+    column.unit = unit;
+
+    /* values with unit are converted to double */
+    const bool asDouble = (unit != 1.0);
+
+    switch (type)
+    {
+        case CT_FLOAT32:
+            column.append = (m_format == OF_TEXT) ? &appendText<float> :
+                    asDouble ? &appendBinary<float, double> : &appendBinary<float, float>;
+            column.npyType = asDouble ? getNpyTypeDescription<double>() : getNpyTypeDescription<float>();
+            break;
+        case CT_FLOAT64:
+            column.append = (m_format == OF_TEXT) ? &appendText<double> : &appendBinary<double, double>;
+            column.npyType = getNpyTypeDescription<double>();
+            break;
+        case CT_UINT32:
+            column.append = (m_format == OF_TEXT) ? &appendText<uint32_t> :
+                    asDouble ? &appendBinary<uint32_t, double> : &appendBinary<uint32_t, uint32_t>;
+            column.npyType = asDouble ? getNpyTypeDescription<double>() : getNpyTypeDescription<uint32_t>();
+            break;
+        case CT_UINT64:
+            column.append = (m_format == OF_TEXT) ? &appendText<uint64_t> :
+                    asDouble ? &appendBinary<uint64_t, double> : &appendBinary<uint64_t, uint64_t>;
+            column.npyType = asDouble ? getNpyTypeDescription<double>() : getNpyTypeDescription<uint64_t>();
+            break;
+        case CT_INT32:
+            column.append = (m_format == OF_TEXT) ? &appendText<int32_t> :
+                    asDouble ? &appendBinary<int32_t, double> : &appendBinary<int32_t, int32_t>;
+            column.npyType = asDouble ? getNpyTypeDescription<double>() : getNpyTypeDescription<int32_t>();
+            break;
+        case CT_INT64:
+            column.append = (m_format == OF_TEXT) ? &appendText<int64_t> :
+                    asDouble ? &appendBinary<int64_t, double> : &appendBinary<int64_t, int64_t>;
+            column.npyType = asDouble ? getNpyTypeDescription<double>() : getNpyTypeDescription<int64_t>();
+            break;
+        default:
+            throw std::runtime_error("cannot identify datatype");
+    }
+
+    m_columns.push_back(column);
+}
+
+void ExportWriter::writeHeader(const std::vector<size_t> &shape)
+{
+    if (m_format != OF_NPY)
+        return;
+
+    std::stringstream dict;
+    dict << "{'descr': [";
+    for (size_t i = 0; i < m_columns.size(); ++i)
+        dict << "('" << m_columns[i].name << "', '" << m_columns[i].npyType << "'), ";
+    dict << "], 'fortran_order': False, 'shape': (";
+    for (size_t i = 0; i < shape.size(); ++i)
+        dict << shape[i] << ", ";
+    dict << "), }";
+
+    /* NumPy format 1.0: magic (6 byte), version (2 byte), header length
+     * (2 byte, little endian), the header is padded with spaces and
+     * terminated by a line break such that the data is 64 byte aligned
+     */
+    std::string header = dict.str();
+    const size_t prefixBytes = 10;
+    const size_t paddedBytes = (prefixBytes + header.size() + 1 + 63) / 64 * 64;
+    header.append(paddedBytes - prefixBytes - header.size() - 1, ' ');
+    header.push_back('\n');
+
+    if (header.size() > 65535)
+        throw std::runtime_error("NumPy header too large, too many columns");
+
+    const char magic[8] = {'\x93', 'N', 'U', 'M', 'P', 'Y', 1, 0};
+    const char headerLength[2] = {char(header.size() & 0xFF), char(header.size() >> 8)};
+    m_outStream.write(magic, sizeof(magic));
+    m_outStream.write(headerLength, sizeof(headerLength));
+    m_outStream.write(header.c_str(), header.size());
+}
+
+void ExportWriter::write(const std::vector<const void*> &columns, size_t numLines,
+        size_t recordsPerLine, size_t lineStride, size_t recordStride)
+{
+    if (columns.size() != m_columns.size())
+        throw std::runtime_error("number of data pointers does not match the number of columns");
+
+    if (numLines == 0)
+        return;
+
+    const size_t linesPerBlock = std::max(size_t(1), recordsPerBlock / std::max(size_t(1), recordsPerLine));
+    const size_t numBlocks = (numLines + linesPerBlock - 1) / linesPerBlock;
+    const size_t numBuffers = m_buffers.size();
+    const int numColumns = m_columns.size();
+    const bool isText = (m_format == OF_TEXT);
+
+    /* each round converts one block per buffer in parallel and writes
+     * the buffers in order
+     */
+    for (size_t firstBlock = 0; firstBlock < numBlocks; firstBlock += numBuffers)
+    {
+        const int blocksInRound = std::min(numBuffers, numBlocks - firstBlock);
+
+        #pragma omp parallel for
+        for (int b = 0; b < blocksInRound; ++b)
+        {
+            std::vector<char> &buffer = m_buffers[b];
+            buffer.clear();
+
+            const size_t lineBegin = (firstBlock + b) * linesPerBlock;
+            const size_t lineEnd = std::min(lineBegin + linesPerBlock, numLines);
+
+            for (size_t line = lineBegin; line < lineEnd; ++line)
+            {
+                for (size_t i = 0; i < recordsPerLine; ++i)
+                {
+                    const size_t index = line * lineStride + i * recordStride;
+                    for (int c = 0; c < numColumns; ++c)
+                        m_columns[c].append(buffer, columns[c], index, m_columns[c].unit, m_delimiter);
+                }
+
+                if (isText)
+                    buffer.push_back('\n');
+            }
+        }
+
+        for (int b = 0; b < blocksInRound; ++b)
+            if (!m_buffers[b].empty())
+                m_outStream.write(&(m_buffers[b][0]), m_buffers[b].size());
+    }
+}
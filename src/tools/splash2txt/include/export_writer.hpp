@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017 Rene Widera
+ *
+ * This file is part of splash2txt.
+ *
+ * splash2txt is free software: you can redistribute it and/or modify
+ * it under the terms of either the GNU General Public License or
+ * the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * splash2txt is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License and the GNU Lesser General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * and the GNU Lesser General Public License along with splash2txt.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXPORT_WRITER_HPP
+#define EXPORT_WRITER_HPP
+
+#include "splash2txt.hpp"
+
+enum ColumnType { CT_FLOAT32 = 0, CT_FLOAT64, CT_UINT32, CT_UINT64, CT_INT32, CT_INT64 };
+
+/**
+ * Converts the elements of one or more datasets (columns) to records and
+ * writes them as text, raw binary or NumPy (.npy) data.
+ *
+ * A record contains one element of each column. Text output writes each
+ * value followed by the delimiter and a line break after each line of
+ * records. Binary output writes the records without any separator in little
+ * endian byte order; columns with a unit != 1.0 are stored as double.
+ * NumPy output is binary output with a header describing a structured
+ * array (one field per column).
+ *
+ * Large inputs are split into blocks which are converted in parallel
+ * (OpenMP) into per-thread buffers and written in order.
+ */
+class ExportWriter
+{
+public:
+
+    ExportWriter(OutputFormat format, std::ostream &outStream, const std::string &delimiter);
+
+    /** add a column, all columns must be added before writeHeader()
+     *
+     * @param name name of the column (NumPy field name)
+     * @param type element type of the input data
+     * @param unit factor which is applied to all elements
+     */
+    void addColumn(const std::string &name, ColumnType type, double unit);
+
+    /** write the file header (NumPy output only)
+     *
+     * @param shape number of records per dimension (slowest varying first)
+     */
+    void writeHeader(const std::vector<size_t> &shape);
+
+    /** convert and write records
+     *
+     * The element of column c for record i in line l is
+     * columns[c][l * lineStride + i * recordStride].
+     *
+     * @param columns pointer to the data of each column
+     * @param numLines number of lines
+     * @param recordsPerLine number of records in each line
+     * @param lineStride distance in elements between the first records of two lines
+     * @param recordStride distance in elements between two records of a line
+     */
+    void write(const std::vector<const void*> &columns, size_t numLines,
+            size_t recordsPerLine, size_t lineStride, size_t recordStride);
+
+private:
+
+    typedef void (*AppendFunc)(std::vector<char> &buffer, const void *data,
+            size_t index, double unit, const std::string &delimiter);
+
+    struct Column
+    {
+        std::string name;
+        ColumnType type;
+        double unit;
+        AppendFunc append;
+        /* NumPy type description, e.g. '<f8' */
+        std::string npyType;
+    };
+
+    template<typename T>
+    static void appendText(std::vector<char> &buffer, const void *data,
+            size_t index, double unit, const std::string &delimiter);
+
+    template<typename T, typename T_Out>
+    static void appendBinary(std::vector<char> &buffer, const void *data,
+            size_t index, double unit, const std::string &delimiter);
+
+    OutputFormat m_format;
+    std::ostream &m_outStream;
+    std::string m_delimiter;
+    std::vector<Column> m_columns;
+    /* one buffer per thread, kept between calls of write() */
+    std::vector<std::vector<char> > m_buffers;
+};
+
+#endif    /* EXPORT_WRITER_HPP */
@@ -83,12 +83,15 @@ enum FileMode { FM_SPLASH = 0
 #endif
 };
 
+enum OutputFormat { OF_TEXT = 0, OF_BINARY = 1, OF_NPY = 2 };
+
 typedef struct
 {
     FileMode fileMode; // type of input file
     std::string inputFile; // input file, common part
     std::string outputFile; // output file
     bool toFile; // use output file
+    OutputFormat outputFormat; // text, raw binary or NumPy output
     std::string delimiter;
     uint32_t step; // simulation iteration
     std::vector<std::string> data; // names of datasets
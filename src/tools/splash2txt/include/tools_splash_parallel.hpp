@@ -26,6 +26,7 @@
 
 #include "splash/splash.h"
 #include "ITools.hpp"
+#include "export_writer.hpp"
 
 using namespace splash;
 
@@ -33,6 +34,7 @@ typedef struct
 {
     DataContainer* container;
     double unit;
+    std::string name;
 } ExDataContainer;
 
 class ToolsSplashParallel : public ITools
@@ -57,11 +59,16 @@ protected:
 
     void printParticles(std::vector<ExDataContainer> fileData);
 
-    void printElement(DCDataType dataType,
-            void* elem, double unit, std::string delimiter);
+    void restrictToLines(Dimensions &offset, Dimensions &domainSize);
+
+    void addColumns(ExportWriter &writer, std::vector<ExDataContainer> &fileData);
+
+    static ColumnType toColumnType(DCDataType dataType);
 
     ParallelDomainCollector dc;
     std::ostream &errorStream;
+    int mpiRank;
+    int mpiSize;
 };
 
 #endif    /* TOOLS_SPLASH_PARALLEL_HPP */
@@ -46,6 +46,7 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
 
     std::string slice_string = "";
     std::string filemode = "splash";
+    std::string format = "text";
 
 #if (ENABLE_ADIOS==1)
     const std::string filemodeOptions = "[splash,adios]";
@@ -60,7 +61,10 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
         ( "mode,m", po::value< std::string > ( &filemode )->default_value( filemode ), (std::string("File Mode ") + filemodeOptions).c_str() )
         ( "list,l", "list the available datasets for an input file" )
         ( "input-file", po::value< std::string > ( &options.inputFile ), "parallel input file" )
-        ( "output-file,o", po::value< std::string > ( &options.outputFile ), "output file (otherwise stdout)" )
+        ( "output-file,o", po::value< std::string > ( &options.outputFile ), "output file (otherwise stdout), "
+          "with more than one MPI process each process writes <name>_<rank><extension>" )
+        ( "format,f", po::value< std::string > ( &format )->default_value( format ),
+          "output format [text,binary,npy], binary: raw little endian records, npy: NumPy structured array" )
         ( "step,s", po::value<uint32_t > ( &options.step )->default_value( options.step ), "requested simulation step" )
         ( "data,d", po::value<std::vector<std::string> > ( &options.data )->multitoken( ), "name of datasets to print" )
         ( "slice", po::value< std::string > ( &slice_string )->default_value( "xy" ), "dimensions of slice for field data, e.g. xy" )
@@ -100,6 +104,20 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
             options.fileMode = FM_ADIOS;
         }
 #endif
+
+        if ( format == "text" )
+            options.outputFormat = OF_TEXT;
+        else if ( format == "binary" )
+            options.outputFormat = OF_BINARY;
+        else if ( format == "npy" )
+            options.outputFormat = OF_NPY;
+        else
+        {
+            errorStream << "Invalid input for parameter 'format'. Accepted: text, binary, npy" << std::endl;
+            errorStream << desc << "\n";
+            return false;
+        }
+
         // re-parse wrong typed input files to valid format, if possible
         //   find _X.h5 with syntax at the end and delete it
         boost::regex filePattern( "_.*\\.h5",
@@ -168,6 +186,21 @@ bool parseOptions( int argc, char** argv, ProgramOptions &options )
     return true;
 }
 
+/** name of the output file of an MPI process, the rank is inserted before the extension */
+std::string getRankFileName( const std::string &fileName, int rank )
+{
+    std::stringstream rankSuffix;
+    rankSuffix << "_" << rank;
+
+    const size_t extensionPos = fileName.find_last_of( '.' );
+    const size_t directoryPos = fileName.find_last_of( '/' );
+    if ( extensionPos == std::string::npos ||
+         ( directoryPos != std::string::npos && extensionPos < directoryPos ) )
+        return fileName + rankSuffix.str( );
+
+    return fileName.substr( 0, extensionPos ) + rankSuffix.str( ) + fileName.substr( extensionPos );
+}
+
 static void mpi_finalize(void)
 {
      // PHDF5 might have finalized already
@@ -180,20 +213,13 @@ static void mpi_finalize(void)
 int main( int argc, char** argv )
 {
     int rank, size;
-    // we read with one MPI process
+    // each MPI process reads independently
     Dims mpi_topology(1, 1, 1);
 
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    if (size > 1)
-    {
-        std::cerr << "Only 1 MPI process supported" << std::endl;
-        mpi_finalize();
-        return 1;
-    }
-
     // read command line options
     ProgramOptions options;
     bool parseSuccessfull = false;
@@ -219,32 +245,68 @@ int main( int argc, char** argv )
         return 1;
     }
 
-    ITools *tools = NULL;
-    switch ( options.fileMode)
+    if ( size > 1 )
     {
-        case FM_SPLASH: tools = new ToolsSplashParallel( options, mpi_topology, *outStream );
-                        break;
+        std::string error;
+        if ( options.fileMode != FM_SPLASH )
+            error = "More than 1 MPI process is only supported for mode 'splash'";
+        else if ( !options.listDatasets && !options.toFile )
+            error = "More than 1 MPI process requires an output file";
+
+        if ( !error.empty( ) )
+        {
+            if ( rank == 0 )
+                errorStream << error << std::endl;
+            mpi_finalize();
+            return 1;
+        }
+
+        options.outputFile = getRankFileName( options.outputFile, rank );
+    }
+
 #if (ENABLE_ADIOS==1)
-        case FM_ADIOS: tools = new ToolsAdiosParallel( options, mpi_topology, *outStream );
-                        break;
-#endif
+    if ( options.fileMode == FM_ADIOS && options.outputFormat != OF_TEXT )
+    {
+        errorStream << "Only text output is supported for mode 'adios'" << std::endl;
+        mpi_finalize();
+        return 1;
     }
+#endif
+
+    ITools *tools = NULL;
 
     try
     {
         std::ofstream file;
         if ( options.toFile )
         {
-            file.open( options.outputFile.c_str( ) );
+            std::ios_base::openmode mode = std::ofstream::out | std::ofstream::trunc;
+            if ( options.outputFormat != OF_TEXT )
+                mode |= std::ofstream::binary;
+
+            file.open( options.outputFile.c_str( ), mode );
             if ( !file.is_open( ) )
                 throw std::runtime_error( "Failed to open output file for writing." );
 
             outStream = &file;
         }
 
+        switch ( options.fileMode)
+        {
+            case FM_SPLASH: tools = new ToolsSplashParallel( options, mpi_topology, *outStream );
+                            break;
+#if (ENABLE_ADIOS==1)
+            case FM_ADIOS: tools = new ToolsAdiosParallel( options, mpi_topology, *outStream );
+                            break;
+#endif
+        }
+
         // apply requested command to file
         if ( options.listDatasets )
-            tools->listAvailableDatasets( );
+        {
+            if ( rank == 0 )
+                tools->listAvailableDatasets( );
+        }
         else
             tools->convertToText(  );
 
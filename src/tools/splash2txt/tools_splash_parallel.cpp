@@ -26,9 +26,13 @@
 
 ToolsSplashParallel::ToolsSplashParallel(ProgramOptions &options, Dims &mpiTopology, std::ostream &outStream) :
 ITools(options, mpiTopology, outStream),
-dc(MPI_COMM_WORLD, MPI_INFO_NULL, Dimensions(mpiTopology[0], mpiTopology[1], mpiTopology[2]), 100),
+dc(MPI_COMM_SELF, MPI_INFO_NULL, Dimensions(mpiTopology[0], mpiTopology[1], mpiTopology[2]), 100),
 errorStream(std::cerr)
 {
+    /* each MPI process reads its part of the data independently */
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+
     DataCollector::FileCreationAttr fattr;
     fattr.enableCompression = false;
     fattr.fileAccType = DataCollector::FAT_READ_MERGED;
@@ -47,106 +51,107 @@ ToolsSplashParallel::~ToolsSplashParallel()
     dc.finalize();
 }
 
-void ToolsSplashParallel::printElement(DCDataType dataType,
-        void* elem, double unit, std::string delimiter)
+ColumnType ToolsSplashParallel::toColumnType(DCDataType dataType)
 {
-    std::stringstream stream;
-
     switch (dataType)
     {
         case DCDT_FLOAT32:
-            stream << std::setprecision(16) << *((float*) elem) *
-                    unit << delimiter;
-            break;
+            return CT_FLOAT32;
         case DCDT_FLOAT64:
-            stream << std::setprecision(16) << *((double*) elem) *
-                    unit << delimiter;
-            break;
+            return CT_FLOAT64;
         case DCDT_UINT32:
-            stream << *((uint32_t*) elem) * unit << delimiter;
-            break;
+            return CT_UINT32;
         case DCDT_UINT64:
-            stream << *((uint64_t*) elem) * unit << delimiter;
-            break;
+            return CT_UINT64;
         case DCDT_INT32:
-            stream << *((int32_t*) elem) * unit << delimiter;
-            break;
+            return CT_INT32;
         case DCDT_INT64:
-            stream << *((int64_t*) elem) * unit << delimiter;
-            break;
+            return CT_INT64;
         default:
             throw DCException("cannot identify datatype");
     }
+}
 
-    m_outStream << stream.str();
+void ToolsSplashParallel::addColumns(ExportWriter &writer, std::vector<ExDataContainer> &fileData)
+{
+    for (std::vector<ExDataContainer>::iterator iter = fileData.begin();
+            iter != fileData.end(); ++iter)
+    {
+        writer.addColumn(iter->name,
+                toColumnType(iter->container->getIndex(0)->getDataType()),
+                iter->unit);
+    }
 }
 
 void ToolsSplashParallel::printParticles(std::vector<ExDataContainer> fileData)
 {
     if (fileData.size() > 0)
     {
-        size_t num_elements = fileData[0].container->getNumElements();
+        const size_t numSubdomains = fileData[0].container->getNumSubdomains();
 
-        if (m_options.verbose)
+        for (std::vector<ExDataContainer>::iterator iter = fileData.begin();
+                iter != fileData.end(); ++iter)
         {
-            errorStream << "num_elements = " << num_elements << std::endl;
-            errorStream << "container = " << fileData.size() << std::endl;
+            if (iter->container->getNumSubdomains() != numSubdomains)
+                throw std::runtime_error("All requested datasets must have the same subdomains");
         }
 
-        std::map<DataContainer*, DomainData*> subdomain;
-        std::map<DataContainer*, size_t> subdomainIndex;
-        std::map<DataContainer*, size_t> numElementsProcessed;
-        for (size_t i = 0; i < num_elements; ++i)
+        /* each MPI process converts a contiguous range of subdomains */
+        const size_t firstSubdomain = numSubdomains * mpiRank / mpiSize;
+        const size_t endSubdomain = numSubdomains * (mpiRank + 1) / mpiSize;
+
+        size_t num_elements = 0;
+        for (size_t s = firstSubdomain; s < endSubdomain; ++s)
         {
+            const size_t subdomainElements =
+                    fileData[0].container->getIndex(s)->getElements().getScalarSize();
             for (std::vector<ExDataContainer>::iterator iter = fileData.begin();
                     iter != fileData.end(); ++iter)
             {
-                DataContainer *container = iter->container;
-                DCDataType data_type =
-                        container->getIndex(0)->getDataType();
+                if (iter->container->getIndex(s)->getElements().getScalarSize() != subdomainElements)
+                    throw std::runtime_error("All requested datasets must have the same number of elements per subdomain");
+            }
+            num_elements += subdomainElements;
+        }
 
-                if (i == 0)
-                {
-                    if (m_options.verbose)
-                        errorStream << "container " << container << " has " <<
-                            container->getNumSubdomains() << " subdomains" << std::endl;
-                    subdomainIndex[container] = 0;
-                    subdomain[container] = container->getIndex(subdomainIndex[container]);
-                    numElementsProcessed[container] = 0;
-                    if (m_options.verbose)
-                        errorStream << "Loading domaindata 0 for container " << container
-                            << " (element = " << i << ")" << std::endl;
-                    dc.readDomainLazy(subdomain[container]);
-                } else
-                {
-                    if (numElementsProcessed[container] == subdomain[container]->getElements().getScalarSize())
-                    {
-                        subdomain[container]->freeData();
-                        subdomainIndex[container]++;
-                        numElementsProcessed[container] = 0;
-                        subdomain[container] = container->getIndex(subdomainIndex[container]);
-                        if (m_options.verbose)
-                            errorStream << std::endl << "Loading domaindata " << subdomainIndex[container] <<
-                                " for container " << container << " (element = " << i << ")" << std::endl;
-                        dc.readDomainLazy(subdomain[container]);
-                    }
-                }
+        if (m_options.verbose)
+        {
+            errorStream << "num_elements = " << num_elements << std::endl;
+            errorStream << "container = " << fileData.size() << std::endl;
+            errorStream << "subdomains = [" << firstSubdomain << ", " << endSubdomain <<
+                ") of " << numSubdomains << std::endl;
+        }
+
+        ExportWriter writer(m_options.outputFormat, m_outStream, m_options.delimiter);
+        addColumns(writer, fileData);
+        writer.writeHeader(std::vector<size_t>(1, num_elements));
 
-                void* element = container->getElement(i);
-                assert(element != NULL);
+        /* read one subdomain of all datasets at once and convert it */
+        std::vector<const void*> columns(fileData.size());
+        for (size_t s = firstSubdomain; s < endSubdomain; ++s)
+        {
+            const size_t subdomainElements =
+                    fileData[0].container->getIndex(s)->getElements().getScalarSize();
+            if (subdomainElements == 0)
+                continue;
+
+            if (m_options.verbose)
+                errorStream << "Loading domaindata " << s << " (" << subdomainElements <<
+                    " elements)" << std::endl;
 
-                printElement(data_type, element, iter->unit, m_options.delimiter);
-                numElementsProcessed[container]++;
+            for (size_t c = 0; c < fileData.size(); ++c)
+            {
+                DomainData *subdomain = fileData[c].container->getIndex(s);
+                dc.readDomainLazy(subdomain);
+                columns[c] = subdomain->getData();
+                assert(columns[c] != NULL);
             }
 
-            m_outStream << std::endl;
+            writer.write(columns, subdomainElements, 1, 1, 0);
 
-            if (m_options.verbose && i % 100000 == 0)
-                errorStream << "." << std::flush;
+            for (size_t c = 0; c < fileData.size(); ++c)
+                fileData[c].container->getIndex(s)->freeData();
         }
-
-        if (m_options.verbose)
-            errorStream << std::endl;
     }
 }
 
@@ -179,41 +184,57 @@ void ToolsSplashParallel::printFields(std::vector<ExDataContainer> fileData)
             size2 = tmpSize;
         }
 
-        for (size_t j = 0; j < size2; ++j)
+        /* the slice is read as one block, each line contains size1 elements */
+        std::vector<const void*> columns;
+        for (std::vector<ExDataContainer>::iterator iter = fileData.begin();
+                iter != fileData.end(); ++iter)
         {
-            size_t index = 0;
-
-            for (size_t i = 0; i < size1; ++i)
-            {
-                if (!m_options.isReverseSlice)
-                    index = j * size1 + i;
-                else
-                    index = i * size2 + j;
-
-                for (std::vector<ExDataContainer>::iterator iter = fileData.begin();
-                        iter != fileData.end(); ++iter)
-                {
-                    DCDataType data_type =
-                            iter->container->getIndex(0)->getDataType();
-
-                    void* element = iter->container->getElement(index);
-                    assert(element != NULL);
-
-                    printElement(data_type, element, iter->unit, m_options.delimiter);
-                }
-            }
+            if (iter->container->getNumSubdomains() != 1)
+                throw std::runtime_error("Field data must be read as one merged block");
+            columns.push_back(iter->container->getIndex(0)->getData());
+            assert(columns.back() != NULL);
+        }
 
-            m_outStream << std::endl;
+        ExportWriter writer(m_options.outputFormat, m_outStream, m_options.delimiter);
+        addColumns(writer, fileData);
 
-            if (m_options.verbose && index % 100000 == 0)
-                errorStream << "." << std::flush;
-        }
+        std::vector<size_t> shape;
+        shape.push_back(size2);
+        shape.push_back(size1);
+        writer.writeHeader(shape);
 
-        if (m_options.verbose)
-            errorStream << std::endl;
+        if (!m_options.isReverseSlice)
+            writer.write(columns, size2, size1, size1, 1);
+        else
+            writer.write(columns, size2, size1, 1, size2);
     }
 }
 
+void ToolsSplashParallel::restrictToLines(Dimensions &offset, Dimensions &domainSize)
+{
+    /* slice dimensions in the order of memory (fast first) */
+    int sliceDims[2] = {-1, -1};
+    int numSliceDims = 0;
+    for (int i = 0; i < 3 && numSliceDims < 2; ++i)
+        if (m_options.fieldDims[i])
+            sliceDims[numSliceDims++] = i;
+
+    if (numSliceDims != 2)
+        throw std::runtime_error("Invalid slice dimensions");
+
+    /* output lines run along the slow dimension of the output */
+    const int lineDim = m_options.isReverseSlice ? sliceDims[0] : sliceDims[1];
+    const size_t numLines = domainSize[lineDim];
+    const size_t firstLine = numLines * mpiRank / mpiSize;
+    const size_t endLine = numLines * (mpiRank + 1) / mpiSize;
+
+    if (endLine == firstLine)
+        throw std::runtime_error("Number of MPI processes exceeds the number of lines of the slice");
+
+    offset[lineDim] += firstLine;
+    domainSize[lineDim] = endLine - firstLine;
+}
+
 void ToolsSplashParallel::convertToText()
 {
     if (m_options.data.size() == 0)
@@ -277,6 +298,7 @@ void ToolsSplashParallel::convertToText()
 
         // create an extended container for each dataset
         ExDataContainer excontainer;
+        excontainer.name = *iter;
 
         if (ref_data_class == DomainCollector::PolyType)
         {
@@ -302,6 +324,9 @@ void ToolsSplashParallel::convertToText()
                     break;
                 }
 
+            // each MPI process reads a contiguous range of output lines
+            restrictToLines(offset, domain_size);
+
             excontainer.container = dc.readDomain(m_options.step, iter->c_str(),
                     Domain(offset, domain_size), NULL);
         }